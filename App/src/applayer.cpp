@@ -21,6 +21,13 @@ AppLayer::AppLayer(AppWindow* parent)
     std::println(__FUNCTION__);
 
     m_renderer = m_parent->getRenderer();
+    m_renderThread = m_parent->getRenderThread();
+
+    // Nothing has been submitted to the render thread yet, the renderer can be set up directly
+    m_drawSortingEnabled = m_renderer->isDrawSortingEnabled();
+    m_autoInstancingEnabled = m_renderer->isAutoInstancingEnabled();
+    m_depthPrePassEnabled = m_renderer->isDepthPrePassEnabled();
+    m_commandCachingEnabled = m_renderer->isCommandCachingEnabled();
 
     s_cubeMesh.vertices = {
         // Front face
@@ -61,6 +68,39 @@ AppLayer::AppLayer(AppWindow* parent)
         4, 5, 1,
         1, 0, 4
     };
+    s_cubeMesh.updateBounds();
+
+    // The grid rings hide each other along the view axis, let the compute pass (with Hi-Z) pick the visible cubes
+    m_renderer->setGpuCullingEnabled(true);
+
+    const glm::vec2 gridOffsets[] = {
+        { 0.0f,  0.0f}, // Center
+        { 1.5f,  0.0f}, // Right
+        {-1.5f,  0.0f}, // Left
+        { 0.0f,  1.5f}, // Top
+        { 0.0f, -1.5f}, // Bottom
+        {-1.5f, -1.5f}, // Bottom Left
+        { 1.5f, -1.5f}, // Bottom Right
+        { 1.5f,  1.5f}, // Top Right
+        {-1.5f,  1.5f}, // Top Left
+    };
+
+    for (size_t c = 1; c < 4; c++)
+    {
+        float z = -1.5f;
+        for (size_t i = 0; i < 3; i++)
+        {
+            s_cubeMeshTransform.translate.z = z;
+            z += 1.5f;
+
+            for (const auto& offset : gridOffsets)
+            {
+                s_cubeMeshTransform.translate.x = offset.x * c;
+                s_cubeMeshTransform.translate.y = offset.y * c;
+                m_cubeRenderableIds.push_back(m_renderer->createRenderable(s_cubeMesh, s_cubeMeshTransform));
+            }
+        }
+    }
 }
 
 void AppLayer::onAttach()
@@ -80,56 +120,69 @@ void AppLayer::onUpdate(Timestep ts)
     cm.view = glm::lookAt(glm::vec3(0.0f, 0.0f, 14.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
     cm.projection[1][1] *= -1; // Invert Y for Vulkan
 
-    m_renderer->beginFrame(cm);
+    // Recorded and submitted on the render thread, while the next frame is simulated here
+    auto& frame = m_renderThread->beginFrame(m_renderer);
+    frame.camera = cm;
 
-    for (size_t c = 1; c < 4; c++)
+    // The cube grid is resident in the renderer, nothing to submit while it doesn't change
+
+    if (m_benchmarkEnabled)
     {
-        float z = -1.5f;
-        for (size_t i = 0; i < 3; i++)
+        // Immediate cube wall submitted back to front, the worst order for overdraw unless the renderer sorts it
+        Transform transform;
+        transform.scale = glm::vec3(0.9f);
+        for (int layer = 0; layer < 16; layer++)
         {
-            s_cubeMeshTransform.translate.z = z;
-            z += 1.5f;
+            transform.translate.z = -20.0f + static_cast<float>(layer) * 1.5f;
+            for (int y = -5; y < 5; y++)
+            {
+                for (int x = -5; x < 5; x++)
+                {
+                    transform.translate.x = static_cast<float>(x) + 0.5f;
+                    transform.translate.y = static_cast<float>(y) + 0.5f;
+                    frame.drawMesh(s_cubeMesh, transform);
+                }
+            }
+        }
+    }
+
+    m_renderThread->submitFrame();
 
-            // Center
-            s_cubeMeshTransform.translate.x = 0.0f;
-            s_cubeMeshTransform.translate.y = 0.0f;
-            m_renderer->drawMesh(s_cubeMesh, s_cubeMeshTransform);
-            // Right
-            s_cubeMeshTransform.translate.x = 1.5f * c;
-            s_cubeMeshTransform.translate.y = 0.0f * c;
-            m_renderer->drawMesh(s_cubeMesh, s_cubeMeshTransform);
-            // Left
-            s_cubeMeshTransform.translate.x = -1.5f * c;
-            s_cubeMeshTransform.translate.y = 0.0f * c;
-            m_renderer->drawMesh(s_cubeMesh, s_cubeMeshTransform);
-            // Top
-            s_cubeMeshTransform.translate.x = 0.0f * c;
-            s_cubeMeshTransform.translate.y = 1.5f * c;
-            m_renderer->drawMesh(s_cubeMesh, s_cubeMeshTransform);
-            // Bottom
-            s_cubeMeshTransform.translate.x = 0.0f * c;
-            s_cubeMeshTransform.translate.y = -1.5f * c;
-            m_renderer->drawMesh(s_cubeMesh, s_cubeMeshTransform);
-            // Bottom Left
-            s_cubeMeshTransform.translate.x = -1.5f * c;
-            s_cubeMeshTransform.translate.y = -1.5f * c;
-            m_renderer->drawMesh(s_cubeMesh, s_cubeMeshTransform);
-            // Bottom Right
-            s_cubeMeshTransform.translate.x = 1.5f * c;
-            s_cubeMeshTransform.translate.y = -1.5f * c;
-            m_renderer->drawMesh(s_cubeMesh, s_cubeMeshTransform);
-            // Top Right
-            s_cubeMeshTransform.translate.x = 1.5f * c;
-            s_cubeMeshTransform.translate.y = 1.5f * c;
-            m_renderer->drawMesh(s_cubeMesh, s_cubeMeshTransform);
-            // Top Left
-            s_cubeMeshTransform.translate.x = -1.5f * c;
-            s_cubeMeshTransform.translate.y = 1.5f * c;
-            m_renderer->drawMesh(s_cubeMesh, s_cubeMeshTransform);
+    if (m_benchmarkEnabled)
+    {
+        // Lags the submitted frame by the frames queued on the render thread
+        const auto stats = m_renderThread->getStats(m_renderer);
+        m_benchmarkSortTime += stats.drawSortTimeMicroseconds;
+        m_benchmarkGpuTime += stats.gpuFrameTimeMilliseconds;
+        m_benchmarkFrameCount++;
+        m_benchmarkElapsed += ts.getSeconds();
+
+        if (m_benchmarkElapsed >= 1.0f)
+        {
+            const auto frameCount = static_cast<double>(m_benchmarkFrameCount);
+            std::println("Draw sorting {}, instancing {}, depth pre-pass {}: {} draws ({:.1f} per instanced draw), sort {:.1f} us, GPU frame {:.3f} ms (average of {} frames), state commands {} emitted {} elided",
+                m_drawSortingEnabled ? "on" : "off",
+                m_autoInstancingEnabled ? "on" : "off",
+                m_depthPrePassEnabled ? "on" : "off",
+                stats.visibleObjectCount,
+                stats.getInstancingRatio(),
+                m_benchmarkSortTime / frameCount,
+                m_benchmarkGpuTime / frameCount,
+                m_benchmarkFrameCount,
+                stats.emittedStateCommandCount,
+                stats.elidedStateCommandCount);
+
+            m_benchmarkSortTime = m_benchmarkGpuTime = 0.0;
+            m_benchmarkFrameCount = 0;
+            m_benchmarkElapsed = 0.0f;
         }
     }
+}
 
-    m_renderer->endFrame();
+bool AppLayer::needsContinuousRedraw() const
+{
+    // The scene is static, only the benchmark measures every frame
+    return m_benchmarkEnabled;
 }
 
 void AppLayer::onEvent(Event &e)
@@ -210,6 +263,42 @@ bool AppLayer::onWindowClosed(WindowCloseEvent &e)
 bool AppLayer::onKeyPressed(KeyPressedEvent &e)
 {
     std::println("{}", e.toString());
+
+    // B: draw submission benchmark, S, I and P: toggle the sorting, the instancing and the depth pre-pass while it runs.
+    // C: toggle the geometry command caching
+    if (e.getKeyCode() == Key::B)
+    {
+        m_benchmarkEnabled = !m_benchmarkEnabled;
+    }
+    else if (e.getKeyCode() == Key::C)
+    {
+        m_commandCachingEnabled = !m_commandCachingEnabled;
+        m_renderThread->enqueue([renderer = m_renderer, enabled = m_commandCachingEnabled] {
+            renderer->setCommandCachingEnabled(enabled);
+        });
+    }
+    else if (e.getKeyCode() == Key::S)
+    {
+        m_drawSortingEnabled = !m_drawSortingEnabled;
+        m_renderThread->enqueue([renderer = m_renderer, enabled = m_drawSortingEnabled] {
+            renderer->setDrawSortingEnabled(enabled);
+        });
+    }
+    else if (e.getKeyCode() == Key::I)
+    {
+        m_autoInstancingEnabled = !m_autoInstancingEnabled;
+        m_renderThread->enqueue([renderer = m_renderer, enabled = m_autoInstancingEnabled] {
+            renderer->setAutoInstancingEnabled(enabled);
+        });
+    }
+    else if (e.getKeyCode() == Key::P)
+    {
+        m_depthPrePassEnabled = !m_depthPrePassEnabled;
+        m_renderThread->enqueue([renderer = m_renderer, enabled = m_depthPrePassEnabled] {
+            renderer->setDepthPrePassEnabled(enabled);
+        });
+    }
+
     return false;
 }
 
@@ -247,4 +336,4 @@ bool AppLayer::onMouseScrolled(MouseScrolledEvent &e)
 {
     std::println("{}", e.toString());
     return false;
-}
+}
\ No newline at end of file
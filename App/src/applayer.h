@@ -13,6 +13,7 @@
 
 #include "renderer/framebuffer.h"
 #include "renderer/renderer.h"
+#include "renderer/renderthread.h"
 
 using namespace LearnVulkanRAII;
 
@@ -31,6 +32,8 @@ public:
     void onUpdate(Timestep ts) override;
     void onEvent(Event& e) override;
 
+    [[nodiscard]] bool needsContinuousRedraw() const override;
+
 private:
     bool onWindowResize(WindowResizeEvent& e);
     bool onWindowMoved(WindowMovedEvent& e);
@@ -54,6 +57,20 @@ private:
     AppWindow* m_parent;
 
     Renderer::Shared m_renderer;
+    RenderThread::Shared m_renderThread;
+    std::vector<RenderableId> m_cubeRenderableIds;
+
+    // The renderer's toggles, it's only changed through the render thread
+    bool m_drawSortingEnabled = true;
+    bool m_autoInstancingEnabled = true;
+    bool m_depthPrePassEnabled = false;
+    bool m_commandCachingEnabled = false;
+
+    bool m_benchmarkEnabled = false;
+    double m_benchmarkSortTime = 0.0;
+    double m_benchmarkGpuTime = 0.0;
+    size_t m_benchmarkFrameCount = 0;
+    float m_benchmarkElapsed = 0.0f;
 };
 
 #endif //LEARNVULKANRAII_APPLAYER_H
\ No newline at end of file
@@ -7,6 +7,7 @@
 AppWindow::AppWindow(const WindowSpecification &spec): Window(spec)
 {
     m_renderer = Renderer::makeShared(getGraphicsContext());
+    m_renderThread = RenderThread::getShared(getGraphicsContext()->getGraphicsDevice());
 
     auto& layerStack = getLayerStack();
 
@@ -17,6 +18,9 @@ AppWindow::AppWindow(const WindowSpecification &spec): Window(spec)
 Renderer::Shared AppWindow::getRenderer()
 { return m_renderer; }
 
+RenderThread::Shared AppWindow::getRenderThread()
+{ return m_renderThread; }
+
 void AppWindow::onEvent(Event &e)
 {
     EventDispatcher dispatcher(e);
@@ -28,6 +32,9 @@ void AppWindow::onEvent(Event &e)
 
 bool AppWindow::onWindowClose(WindowCloseEvent& e)
 {
+    // The render thread may still have frames of this window queued
+    m_renderThread->flush();
+
     auto& device = getGraphicsContext()->getDevice();
     device.waitIdle();
     return false;
@@ -35,7 +42,13 @@ bool AppWindow::onWindowClose(WindowCloseEvent& e)
 
 bool AppWindow::onWindowResize(WindowResizeEvent &e)
 {
-    getGraphicsContext()->resize(e.getWidth(), e.getHeight());
-    m_renderer->resize(e.getWidth(), e.getHeight());
+    // Minimized, nothing is rendered until the window gets a size again
+    if (e.getWidth() == 0 || e.getHeight() == 0)
+        return false;
+
+    // Only recorded on the render thread, the swapchain is recreated once before its next frame
+    m_renderThread->enqueue([renderer = m_renderer, width = e.getWidth(), height = e.getHeight()] {
+        renderer->resize(width, height);
+    });
     return false;
 }
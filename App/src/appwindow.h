@@ -20,6 +20,7 @@ public:
     explicit AppWindow(const WindowSpecification& spec);
 
     Renderer::Shared getRenderer();
+    RenderThread::Shared getRenderThread();
 
 protected:
     void onEvent(Event &e) override;
@@ -29,6 +30,8 @@ protected:
 
 private:
     Renderer::Shared m_renderer;
+    // Declared after the renderer, the thread drawing with it stops first
+    RenderThread::Shared m_renderThread;
 };
 
 
@@ -0,0 +1,103 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#include "renderer/drawlist.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <print>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace LearnVulkanRAII;
+
+namespace
+{
+    // Keys shaped like a frame's draws: both pipelines, a spread of view depths, a few materials and meshes
+    std::vector<uint64_t> makeKeys(size_t count, std::mt19937& random)
+    {
+        std::uniform_int_distribution<uint32_t> pipeline(0, 1);
+        std::uniform_real_distribution<float> depth(0.1f, 1000.0f);
+        std::uniform_int_distribution<uint32_t> material(0, 63);
+        std::uniform_int_distribution<uint32_t> mesh(0, 255);
+
+        std::vector<uint64_t> keys(count);
+        for (auto& key : keys)
+        {
+            key = DrawKey::make(pipeline(random), depth(random), material(random), mesh(random));
+        }
+        return keys;
+    }
+
+    // Average of the runs in milliseconds, the setup (restoring the unsorted input) isn't timed
+    double measure(uint32_t runCount, const std::function<void()>& setup, const std::function<void()>& function)
+    {
+        double total = 0.0;
+        for (uint32_t run = 0; run <= runCount; run++)
+        {
+            setup();
+            const auto start = std::chrono::steady_clock::now();
+            function();
+            const double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            // The first run warms up the caches and the scratch allocations
+            if (run > 0)
+                total += time;
+        }
+        return total / runCount;
+    }
+}
+
+int main()
+{
+    std::mt19937 random(1234);
+
+    for (const size_t drawCount : { 1000, 10000, 100000, 1000000 })
+    {
+        const auto input = makeKeys(drawCount, random);
+        const uint32_t runCount = static_cast<uint32_t>(std::clamp<size_t>(10000000 / drawCount, 4, 1000));
+
+        // Both sort the keys along with the draw order, like DrawList::sort does
+        std::vector<uint64_t> keys;
+        std::vector<uint32_t> order;
+        std::vector<uint64_t> keyScratch;
+        std::vector<uint32_t> orderScratch;
+        const auto resetKeys = [&] {
+            keys = input;
+            order.resize(drawCount);
+            for (uint32_t i = 0; i < drawCount; i++)
+                order[i] = i;
+        };
+
+        std::vector<std::pair<uint64_t, uint32_t>> pairs;
+        const auto resetPairs = [&] {
+            pairs.resize(drawCount);
+            for (uint32_t i = 0; i < drawCount; i++)
+                pairs[i] = { input[i], i };
+        };
+
+        const double radixTime = measure(runCount, resetKeys, [&] {
+            DrawList::radixSort(keys, order, keyScratch, orderScratch);
+        });
+        // The pair compares the index too, which makes std::sort as stable as the radix sort
+        const double stdSortTime = measure(runCount, resetPairs, [&] {
+            std::sort(pairs.begin(), pairs.end());
+        });
+
+        bool matches = true;
+        for (size_t i = 0; i < drawCount; i++)
+        {
+            matches = matches && keys[i] == pairs[i].first && order[i] == pairs[i].second;
+        }
+
+        std::println("{:>8} draws: radix sort {:.3f} ms, std::sort {:.3f} ms, {:.2f}x{}",
+            drawCount, radixTime, stdSortTime, stdSortTime / radixTime, matches ? "" : " (ORDER MISMATCH)");
+        if (!matches)
+            return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#include "base/jobsystem.h"
+
+#include "mesh/mesh.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <print>
+#include <thread>
+#include <vector>
+
+using namespace LearnVulkanRAII;
+
+namespace
+{
+    constexpr uint32_t RunCount = 8;
+
+    // Average of the runs in milliseconds, after a warm up run
+    double measure(const std::function<void()>& function)
+    {
+        function();
+
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t run = 0; run < RunCount; run++)
+            function();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / RunCount;
+    }
+
+    std::vector<uint32_t> getWorkerCounts()
+    {
+        // 1, 2, 4... up to one per hardware thread besides the main thread
+        const uint32_t maxWorkerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+        std::vector<uint32_t> workerCounts;
+        for (uint32_t workerCount = 1; workerCount < maxWorkerCount; workerCount *= 2)
+            workerCounts.push_back(workerCount);
+        workerCounts.push_back(maxWorkerCount);
+        return workerCounts;
+    }
+
+    // Transform evaluation, the data parallel work the renderer hands to parallelFor
+    void benchmarkParallelFor()
+    {
+        constexpr uint32_t transformCount = 1000000;
+        constexpr uint32_t grainSize = 4096;
+
+        std::vector<Transform> transforms(transformCount);
+        for (uint32_t i = 0; i < transformCount; i++)
+        {
+            transforms[i].translate = glm::vec3(static_cast<float>(i % 100), static_cast<float>(i / 100 % 100), 0.0f);
+            transforms[i].setRotation(glm::vec3(static_cast<float>(i) * 0.001f));
+        }
+        std::vector<glm::mat3x4> matrices(transformCount);
+
+        const auto evaluate = [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++)
+                matrices[i] = transforms[i].toAffine3x4();
+        };
+
+        const double inlineTime = measure([&] { evaluate(0, transformCount); });
+        std::println("parallelFor: {} transforms (grain {}), inline {:.3f} ms", transformCount, grainSize, inlineTime);
+
+        for (const auto workerCount : getWorkerCounts())
+        {
+            JobSystem jobSystem(workerCount);
+            const double time = measure([&] { jobSystem.parallelFor(transformCount, grainSize, evaluate); });
+            std::println("  {} workers (+ main thread): {:.3f} ms, {:.2f}x", workerCount, time, inlineTime / time);
+        }
+    }
+
+    // Tiny jobs scheduled from inside jobs, the scheduling and stealing overhead dominates
+    void benchmarkScheduling()
+    {
+        constexpr uint32_t parentCount = 64;
+        constexpr uint32_t childCount = 256;
+
+        std::println("schedule: {} jobs of {} nested jobs each", parentCount, childCount);
+        for (const auto workerCount : getWorkerCounts())
+        {
+            JobSystem jobSystem(workerCount);
+            std::atomic<uint32_t> sum = 0;
+
+            const double time = measure([&] {
+                JobCounter parents;
+                for (uint32_t i = 0; i < parentCount; i++)
+                {
+                    jobSystem.schedule([&] {
+                        JobCounter children;
+                        for (uint32_t j = 0; j < childCount; j++)
+                            jobSystem.schedule([&sum] { sum.fetch_add(1, std::memory_order_relaxed); }, &children);
+                        jobSystem.wait(children);
+                    }, &parents);
+                }
+                jobSystem.wait(parents);
+            });
+
+            const double jobsPerMillisecond = static_cast<double>(parentCount * (childCount + 1)) / time;
+            std::println("  {} workers (+ main thread): {:.3f} ms, {:.0f} jobs/ms", workerCount, time, jobsPerMillisecond);
+        }
+    }
+}
+
+int main()
+{
+    benchmarkParallelFor();
+    benchmarkScheduling();
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+#version 450
+
+layout (local_size_x = 64) in;
+
+const uint OBJECT_METADATA_INDEX_BITS = 20;
+const uint OBJECT_METADATA_INDEX_MASK = (1u << OBJECT_METADATA_INDEX_BITS) - 1u;
+
+const uint CULL_FLAG_FRUSTUM = 1u;
+const uint CULL_FLAG_OCCLUSION = 2u;
+
+struct ObjectMetadata
+{
+    mat3x4 model; // affine model matrix, column i holds row i
+};
+
+struct DrawCommand // VkDrawIndexedIndirectCommand
+{
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
+
+// Every storage buffer lives in the same bindless array, the push constants select the slots
+layout (std430, set = 0, binding = 0) readonly buffer CullParamsBuffer
+{
+    vec4 frustumPlanes[6];
+    mat4 previousViewProjection; // the depth pyramid was rendered with it
+    vec2 depthPyramidSize;
+    uint drawCount;
+    uint flags;
+} b_cullParamsBuffers[];
+
+layout (std430, set = 0, binding = 0) readonly buffer ObjectMetadataBuffer
+{
+    ObjectMetadata metadata[];
+} b_objectMetadataBuffers[];
+
+layout (std430, set = 0, binding = 0) readonly buffer DrawCommandBuffer
+{
+    DrawCommand commands[];
+} b_drawCommandBuffers[];
+
+layout (std430, set = 0, binding = 0) readonly buffer InstanceBuffer
+{
+    uint packedIndices[]; // object metadata index | material slot << 20
+} b_instanceBuffers[];
+
+layout (std430, set = 0, binding = 0) readonly buffer BoundsBuffer
+{
+    vec4 spheres[]; // local space center and radius
+} b_boundsBuffers[];
+
+layout (std430, set = 0, binding = 0) writeonly buffer VisibleDrawCommandBuffer
+{
+    DrawCommand commands[];
+} b_visibleDrawCommandBuffers[];
+
+layout (std430, set = 0, binding = 0) buffer DrawCountBuffer
+{
+    uint drawCount;
+} b_drawCountBuffers[];
+
+// Max depth of the previous frame, one mip per halving
+layout (set = 1, binding = 0) uniform sampler2D u_depthPyramid;
+
+layout (push_constant) uniform CullPushConstants
+{
+    uint cullParamsBufferIndex;
+    uint objectMetadataBufferIndex;
+    uint drawCommandBufferIndex;
+    uint instanceBufferIndex;
+    uint boundsBufferIndex;
+    uint visibleDrawCommandBufferIndex;
+    uint drawCountBufferIndex;
+} pc;
+
+bool isOccluded(vec3 center, float radius)
+{
+    // Screen rectangle and nearest depth of the sphere's bounding box, as seen by the previous frame
+    vec2 uvMin = vec2(1.0);
+    vec2 uvMax = vec2(0.0);
+    float nearestDepth = 1.0;
+    for (int i = 0; i < 8; i++)
+    {
+        vec3 corner = center + radius * vec3((i & 1) != 0 ? 1.0 : -1.0,
+            (i & 2) != 0 ? 1.0 : -1.0,
+            (i & 4) != 0 ? 1.0 : -1.0);
+        vec4 clip = b_cullParamsBuffers[pc.cullParamsBufferIndex].previousViewProjection * vec4(corner, 1.0);
+
+        // Crossing the near plane, the projection isn't reliable anymore
+        if (clip.w <= 0.0)
+            return false;
+
+        vec3 ndc = clip.xyz / clip.w;
+        vec2 uv = ndc.xy * 0.5 + 0.5;
+        uvMin = min(uvMin, uv);
+        uvMax = max(uvMax, uv);
+        nearestDepth = min(nearestDepth, ndc.z);
+    }
+
+    uvMin = clamp(uvMin, vec2(0.0), vec2(1.0));
+    uvMax = clamp(uvMax, vec2(0.0), vec2(1.0));
+
+    // The level where the rectangle covers at most 2x2 texels, their max bounds every occluder below it
+    vec2 sizeInPixels = (uvMax - uvMin) * b_cullParamsBuffers[pc.cullParamsBufferIndex].depthPyramidSize;
+    float level = ceil(log2(max(max(sizeInPixels.x, sizeInPixels.y), 1.0)));
+
+    float occluderDepth = max(
+        max(textureLod(u_depthPyramid, uvMin, level).r, textureLod(u_depthPyramid, vec2(uvMax.x, uvMin.y), level).r),
+        max(textureLod(u_depthPyramid, vec2(uvMin.x, uvMax.y), level).r, textureLod(u_depthPyramid, uvMax, level).r));
+
+    return nearestDepth > occluderDepth;
+}
+
+void main()
+{
+    uint drawIndex = gl_GlobalInvocationID.x;
+    if (drawIndex >= b_cullParamsBuffers[pc.cullParamsBufferIndex].drawCount)
+        return;
+
+    // Destroyed renderables keep their slot with a zero instance count
+    DrawCommand command = b_drawCommandBuffers[pc.drawCommandBufferIndex].commands[drawIndex];
+    if (command.instanceCount == 0)
+        return;
+
+    uint objectMetadataIndex = b_instanceBuffers[pc.instanceBufferIndex].packedIndices[drawIndex] & OBJECT_METADATA_INDEX_MASK;
+    mat3x4 model = b_objectMetadataBuffers[pc.objectMetadataBufferIndex].metadata[objectMetadataIndex].model;
+    vec4 localSphere = b_boundsBuffers[pc.boundsBufferIndex].spheres[drawIndex];
+
+    // Conservative world space sphere, the radius grows with the largest scale axis
+    vec3 center = vec4(localSphere.xyz, 1.0) * model;
+    float scale = max(length(vec3(model[0][0], model[1][0], model[2][0])),
+        max(length(vec3(model[0][1], model[1][1], model[2][1])), length(vec3(model[0][2], model[1][2], model[2][2]))));
+    float radius = localSphere.w * scale;
+
+    uint flags = b_cullParamsBuffers[pc.cullParamsBufferIndex].flags;
+    bool visible = true;
+
+    if ((flags & CULL_FLAG_FRUSTUM) != 0u)
+    {
+        for (int i = 0; i < 6 && visible; i++)
+        {
+            vec4 plane = b_cullParamsBuffers[pc.cullParamsBufferIndex].frustumPlanes[i];
+            visible = dot(plane.xyz, center) + plane.w >= -radius;
+        }
+    }
+
+    if (visible && (flags & CULL_FLAG_OCCLUSION) != 0u)
+        visible = !isOccluded(center, radius);
+
+    if (!visible)
+        return;
+
+    uint visibleIndex = atomicAdd(b_drawCountBuffers[pc.drawCountBufferIndex].drawCount, 1u);
+    b_visibleDrawCommandBuffers[pc.visibleDrawCommandBufferIndex].commands[visibleIndex] = command;
+}
@@ -0,0 +1,38 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+// Position only variant of renderer.vertex.glsl for the depth pre-pass.
+// The main pass tests with eEqual afterwards, the position math must stay identical to it
+const uint OBJECT_METADATA_INDEX_BITS = 20;
+const uint OBJECT_METADATA_INDEX_MASK = (1u << OBJECT_METADATA_INDEX_BITS) - 1u;
+
+struct ObjectMetadata
+{
+    mat3x4 model; // affine model matrix, column i holds row i
+};
+
+layout (location = 0) in vec3 a_pos;
+layout (location = 1) in uint a_internalIndices; // object metadata index | material slot << 20
+
+layout (std430, set = 0, binding = 0) readonly buffer ObjectMetadataBuffer
+{
+    ObjectMetadata metadata[];
+} b_objectMetadataBuffers[];
+
+layout (push_constant) uniform DrawPushConstants
+{
+    mat4 viewProjection;
+    uint objectMetadataBufferIndex;
+} pc;
+
+invariant gl_Position;
+
+void main()
+{
+    uint objectMetadataIndex = a_internalIndices & OBJECT_METADATA_INDEX_MASK;
+    mat3x4 model = b_objectMetadataBuffers[pc.objectMetadataBufferIndex].metadata[objectMetadataIndex].model;
+
+    vec3 worldPos = vec4(a_pos, 1.0) * model;
+
+    gl_Position = pc.viewProjection * vec4(worldPos, 1.0);
+}
@@ -0,0 +1,35 @@
+#version 450
+
+layout (local_size_x = 8, local_size_y = 8) in;
+
+// One level of the depth pyramid: the source is the depth attachment or the previous level
+layout (set = 0, binding = 0) uniform sampler2D u_source;
+layout (set = 0, binding = 1, r32f) uniform writeonly image2D u_destination;
+
+layout (push_constant) uniform DepthPyramidPushConstants
+{
+    ivec2 sourceSize;
+    ivec2 destinationSize;
+} pc;
+
+void main()
+{
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(texel, pc.destinationSize)))
+        return;
+
+    // Odd source sizes leave a third row/column to the last texel, nothing may slip through the reduction
+    ivec2 begin = texel * pc.sourceSize / pc.destinationSize;
+    ivec2 end = max((texel + 1) * pc.sourceSize / pc.destinationSize, begin + 1);
+
+    float maxDepth = 0.0;
+    for (int y = begin.y; y < end.y; y++)
+    {
+        for (int x = begin.x; x < end.x; x++)
+        {
+            maxDepth = max(maxDepth, texelFetch(u_source, ivec2(x, y), 0).r);
+        }
+    }
+
+    imageStore(u_destination, texel, vec4(maxDepth));
+}
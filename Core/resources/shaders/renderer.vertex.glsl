@@ -1,37 +1,42 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
-struct CameraViewData
-{
-    mat4 projection;
-    mat4 view;
-};
+const uint OBJECT_METADATA_INDEX_BITS = 20;
+const uint OBJECT_METADATA_INDEX_MASK = (1u << OBJECT_METADATA_INDEX_BITS) - 1u;
 
 struct ObjectMetadata
 {
-    mat4 model;
+    mat3x4 model; // affine model matrix, column i holds row i
 };
 
 layout (location = 0) in vec3 a_pos;
-layout (location = 1) in int a_objectMetadataIndex;
+layout (location = 1) in uint a_internalIndices; // object metadata index | material slot << 20
 
-layout (set = 0, binding = 0) uniform CameraViewDataBuffer
+// Every storage buffer lives in the same bindless array, the push constants select the slots
+layout (std430, set = 0, binding = 0) readonly buffer ObjectMetadataBuffer
 {
-    CameraViewData cameraViewData;
-} u_cameraViewDataBuffer;
+    ObjectMetadata metadata[];
+} b_objectMetadataBuffers[];
 
-layout (std140, set = 0, binding = 1) readonly buffer ObjectMetadataBuffer
+layout (push_constant) uniform DrawPushConstants
 {
-    ObjectMetadata metadata[];
-} b_objectMetadataBuffer;
+    mat4 viewProjection; // projection * view, combined on the CPU once per frame
+    uint objectMetadataBufferIndex;
+} pc;
 
 layout (location = 0) out vec3 v_color;
 
+// Shared with depthprepass.vertex.glsl, the main pass must land on the pre-pass depth exactly
+invariant gl_Position;
+
 void main()
 {
-    mat4 proj = u_cameraViewDataBuffer.cameraViewData.projection;
-    mat4 view = u_cameraViewDataBuffer.cameraViewData.view;
-    mat4 model = b_objectMetadataBuffer.metadata[a_objectMetadataIndex].model;
+    uint objectMetadataIndex = a_internalIndices & OBJECT_METADATA_INDEX_MASK;
+    mat3x4 model = b_objectMetadataBuffers[pc.objectMetadataBufferIndex].metadata[objectMetadataIndex].model;
+
+    // Expand the 3x4 affine record: one dot product per row
+    vec3 worldPos = vec4(a_pos, 1.0) * model;
 
-    gl_Position = proj * view * model * vec4(a_pos, 1.0);
+    gl_Position = pc.viewProjection * vec4(worldPos, 1.0);
     v_color = (a_pos + 1.0) * 0.5;
 }
@@ -6,8 +6,16 @@
 
 #include <glfw/glfw3.h>
 
+#include <algorithm>
+#include <thread>
+
 namespace LearnVulkanRAII
 {
+    Application::Application()
+        : m_jobSystem(JobSystem::getShared())
+    {
+    }
+
     Window::Unique& Application::createWindow(const WindowSpecification &spec)
     {
         return m_windows.emplace_back(Utils::makeUnique<Window>(spec));
@@ -22,7 +30,9 @@ namespace LearnVulkanRAII
     {
         while (m_isRunning)
         {
-            glfwPollEvents();
+            processEvents();
+            m_jobSystem->runMainThreadJobs();
+
             bool isAllWindowClosed = true;
 
             for (const auto& window : m_windows)
@@ -43,8 +53,57 @@ namespace LearnVulkanRAII
             {
                 m_isRunning = false;
             }
+
+            waitForNextFrame();
         }
     }
+
+    void Application::setTargetFrameRate(double framesPerSecond)
+    {
+        m_targetFrameRate = framesPerSecond;
+        m_nextFrameTime = std::chrono::steady_clock::now();
+    }
+
+    void Application::setIdleTimeout(double seconds)
+    {
+        m_idleTimeout = seconds;
+    }
+
+    void Application::processEvents() const
+    {
+        // Minimized windows don't render, they don't keep the loop busy either
+        const bool redraws = std::any_of(m_windows.begin(), m_windows.end(), [](const Window::Unique& window) {
+            return !window->shouldClose() && !window->isMinimized() && window->needsContinuousRedraw();
+        });
+
+        if (redraws)
+            glfwPollEvents();
+        else
+            glfwWaitEventsTimeout(m_idleTimeout);
+    }
+
+    void Application::waitForNextFrame()
+    {
+        if (m_targetFrameRate <= 0.0)
+            return;
+
+        using Clock = std::chrono::steady_clock;
+        // The OS sleep overshoots by up to a scheduler tick, the last part of the wait is spun
+        constexpr auto spinDuration = std::chrono::milliseconds(2);
+
+        const auto frameDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_targetFrameRate));
+        const auto deadline = m_nextFrameTime;
+
+        auto now = Clock::now();
+        if (deadline - now > spinDuration)
+            std::this_thread::sleep_for(deadline - now - spinDuration);
+
+        while ((now = Clock::now()) < deadline)
+            std::this_thread::yield();
+
+        // A late frame doesn't make the next ones hurry
+        m_nextFrameTime = std::max(deadline + frameDuration, now);
+    }
 } // LearnVulkanRAII
 
 extern LearnVulkanRAII::Application::Unique createApplication(int argc, char* argv[]);
@@ -6,7 +6,9 @@
 #define LEARNVULKANRAII_APPLICATION_H
 
 #include "window.h"
+#include "jobsystem.h"
 
+#include <chrono>
 #include <vector>
 
 namespace LearnVulkanRAII
@@ -17,7 +19,7 @@ namespace LearnVulkanRAII
         DEFINE_SMART_POINTER_HELPERS(Application)
 
     public:
-        Application() = default;
+        Application();
         virtual ~Application() = default;
 
         Window::Unique& createWindow(const WindowSpecification& spec);
@@ -25,9 +27,26 @@ namespace LearnVulkanRAII
 
         void run();
 
+        // Frames per second the loop doesn't exceed, 0 for uncapped
+        void setTargetFrameRate(double framesPerSecond);
+        // Longest wait for events while no window needs continuous redraw
+        void setIdleTimeout(double seconds);
+
+    private:
+        // Polls while a window redraws continuously, waits for events otherwise
+        void processEvents() const;
+        // Sleeps until the next frame of the target frame rate
+        void waitForNextFrame();
+
     private:
+        // Kept for the application's lifetime, its main thread jobs run once per frame
+        JobSystem::Shared m_jobSystem;
         std::vector<Window::Unique> m_windows;
         bool m_isRunning = true;
+
+        double m_targetFrameRate = 0.0;
+        double m_idleTimeout = 0.5;
+        std::chrono::steady_clock::time_point m_nextFrameTime;
     };
 } // LearnVulkanRAII
 
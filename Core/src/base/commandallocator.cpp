@@ -0,0 +1,97 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#include "commandallocator.h"
+
+namespace LearnVulkanRAII
+{
+    CommandAllocator::CommandAllocator(const GraphicsContext::Shared& graphicsContext, uint32_t frameSlotCount)
+        : m_graphicsContext(graphicsContext),
+        m_frameSlotCount(frameSlotCount)
+    {
+        ASSERT(frameSlotCount > 0, "The command allocator needs at least one frame slot!");
+    }
+
+    const vk::raii::CommandBuffer& CommandAllocator::allocate(uint32_t frameSlot, vk::CommandBufferLevel level)
+    {
+        auto& pool = getThreadPool(frameSlot);
+
+        const bool primary = level == vk::CommandBufferLevel::ePrimary;
+        auto& buffers = primary ? pool.primaryBuffers : pool.secondaryBuffers;
+        auto& usedCount = primary ? pool.usedPrimaryCount : pool.usedSecondaryCount;
+
+        if (usedCount == buffers.size())
+        {
+            vk::CommandBufferAllocateInfo allocateInfo{ **pool.commandPool, level, 1 };
+            buffers.push_back(std::move(m_graphicsContext->getDevice().allocateCommandBuffers(allocateInfo).front()));
+        }
+
+        return buffers[usedCount++];
+    }
+
+    void CommandAllocator::reset(uint32_t frameSlot)
+    {
+        ASSERT(frameSlot < m_frameSlotCount, "Invalid frame slot!");
+
+        std::lock_guard lock(m_mutex);
+        for (auto& [_, pools] : m_threadPools)
+        {
+            auto& pool = pools[frameSlot];
+            if (pool.usedPrimaryCount == 0 && pool.usedSecondaryCount == 0)
+                continue;
+
+            // Every buffer of the pool goes back to the initial state, their memory is kept for the next frame
+            pool.commandPool->reset();
+            pool.usedPrimaryCount = 0;
+            pool.usedSecondaryCount = 0;
+        }
+    }
+
+    size_t CommandAllocator::getCommandBufferCount() const
+    {
+        std::lock_guard lock(m_mutex);
+
+        size_t count = 0;
+        for (const auto& [_, pools] : m_threadPools)
+        {
+            for (const auto& pool : pools)
+            {
+                count += pool.primaryBuffers.size() + pool.secondaryBuffers.size();
+            }
+        }
+
+        return count;
+    }
+
+    CommandAllocator::Shared CommandAllocator::create(const GraphicsContext::Shared& graphicsContext, uint32_t frameSlotCount)
+    {
+        return makeShared(graphicsContext, frameSlotCount);
+    }
+
+    CommandAllocator::Pool& CommandAllocator::getThreadPool(uint32_t frameSlot)
+    {
+        ASSERT(frameSlot < m_frameSlotCount, "Invalid frame slot!");
+
+        // Only the lookup is locked, the pool itself belongs to the calling thread
+        std::lock_guard lock(m_mutex);
+
+        auto [it, inserted] = m_threadPools.try_emplace(std::this_thread::get_id());
+        auto& pools = it->second;
+        if (inserted)
+        {
+            vk::CommandPoolCreateInfo commandPoolCreateInfo{
+                vk::CommandPoolCreateFlagBits::eTransient,
+                static_cast<uint32_t>(m_graphicsContext->getQueueFamilyIndices().graphicsQueueFamilyIndex)
+            };
+
+            pools.resize(m_frameSlotCount);
+            for (auto& pool : pools)
+            {
+                pool.commandPool = m_graphicsContext->getDevice().createCommandPool(commandPoolCreateInfo);
+            }
+        }
+
+        return pools[frameSlot];
+    }
+} // LearnVulkanRAII
\ No newline at end of file
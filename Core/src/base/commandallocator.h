@@ -0,0 +1,69 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#ifndef LEARNVULKANRAII_COMMANDALLOCATOR_H
+#define LEARNVULKANRAII_COMMANDALLOCATOR_H
+
+#include "utils.h"
+#include "graphicscontext.h"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace LearnVulkanRAII
+{
+    // Transient command buffers, one eTransient pool per frame slot and per recording thread.
+    // Buffers are never reset one by one: reset() resets every pool of a frame slot in one call once the slot's work
+    // is done, and its buffers are handed out again (in allocation order) for the next frame in that slot.
+    // Pools are externally synchronized, every thread allocates and records with its own
+    class CommandAllocator
+    {
+    public:
+        DEFINE_SMART_POINTER_HELPERS(CommandAllocator)
+
+    public:
+        CommandAllocator(const GraphicsContext::Shared& graphicsContext, uint32_t frameSlotCount);
+
+        // A buffer of the calling thread's pool, valid until the frame slot is reset. Thread safe
+        const vk::raii::CommandBuffer& allocate(uint32_t frameSlot,
+            vk::CommandBufferLevel level = vk::CommandBufferLevel::ePrimary);
+        // Nothing may record with, or execute, the frame slot's buffers anymore
+        void reset(uint32_t frameSlot);
+
+        // Buffers created so far, over every pool, handed out or not
+        [[nodiscard]] size_t getCommandBufferCount() const;
+
+        static Shared create(const GraphicsContext::Shared& graphicsContext, uint32_t frameSlotCount);
+
+    private:
+        struct Pool
+        {
+            Utils::Optional<vk::raii::CommandPool> commandPool;
+
+            // A deque keeps the handed out references valid while it grows.
+            // Buffers past the used count are the free list, reset with the pool
+            std::deque<vk::raii::CommandBuffer> primaryBuffers;
+            std::deque<vk::raii::CommandBuffer> secondaryBuffers;
+            size_t usedPrimaryCount = 0;
+            size_t usedSecondaryCount = 0;
+        };
+
+        Pool& getThreadPool(uint32_t frameSlot);
+
+    private:
+        GraphicsContext::Shared m_graphicsContext;
+        uint32_t m_frameSlotCount = 0;
+
+        // Every thread that recorded has a pool per frame slot
+        std::unordered_map<std::thread::id, std::vector<Pool>> m_threadPools;
+        mutable std::mutex m_mutex;
+    };
+} // LearnVulkanRAII
+
+#endif //LEARNVULKANRAII_COMMANDALLOCATOR_H
\ No newline at end of file
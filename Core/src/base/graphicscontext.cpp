@@ -13,29 +13,93 @@
 namespace LearnVulkanRAII
 {
     GraphicsContext::GraphicsContext(Window* window)
-        : m_window(window)
+        : GraphicsContext(window, GraphicsDevice::getShared(window->getTitle()))
+    {
+    }
+
+    GraphicsContext::GraphicsContext(Window* window, const GraphicsDevice::Shared& graphicsDevice)
+        : m_graphicsDevice(graphicsDevice),
+        m_window(window)
+    {
+        init();
+    }
+
+    GraphicsContext::GraphicsContext(const HeadlessContextSpecification& spec)
+        : m_graphicsDevice(GraphicsDevice::create(spec.applicationName, true)),
+        m_headlessSpec(spec)
     {
         init();
     }
 
     void GraphicsContext::resize(uint32_t width, uint32_t height)
     {
-        m_device->waitIdle();
+        m_requestedExtent = vk::Extent2D{ width, height };
+        m_swapchainOutOfDate = true;
+    }
 
-        m_swapchain.reset();
+    void GraphicsContext::invalidateSwapchain()
+    {
+        m_swapchainOutOfDate = true;
+    }
 
-        createSwapchain();
+    bool GraphicsContext::isSwapchainOutOfDate() const
+    {
+        return m_swapchainOutOfDate;
+    }
+
+    bool GraphicsContext::recreateSwapchain()
+    {
+        if (isHeadless())
+        {
+            m_swapchainExtent = m_requestedExtent;
+            m_swapchainOutOfDate = false;
+            return true;
+        }
+
+        // Minimized, a swapchain can't have a zero extent
+        const auto caps = getSurfaceCapabilities();
+        const vk::Extent2D extent = caps.currentExtent.width != UINT32_MAX ? caps.currentExtent : m_requestedExtent;
+        if (extent.width == 0 || extent.height == 0)
+            return false;
+
+        // The new swapchain is created from the old one, the presentation engine hands over without a gap.
+        // The frames in flight may still render into or present the old images
+        // The image count may change, the framebuffers follow it while the frame slots stay
+        RetiredSwapchain retired{ std::move(m_swapchain), std::move(m_swapchainImageViews), getFrameSlotCount() };
+        m_swapchainImageViews.clear();
+
+        createSwapchain(**retired.swapchain);
         createImageViews();
+
+        m_retiredSwapchains.push_back(std::move(retired));
+        m_swapchainOutOfDate = false;
+        return true;
+    }
+
+    void GraphicsContext::nextFrame()
+    {
+        for (auto& retired : m_retiredSwapchains)
+        {
+            if (retired.framesLeft > 0)
+                retired.framesLeft--;
+        }
+
+        std::erase_if(m_retiredSwapchains, [](const RetiredSwapchain& retired) { return retired.framesLeft == 0; });
+    }
+
+    const GraphicsDevice::Shared& GraphicsContext::getGraphicsDevice() const
+    {
+        return m_graphicsDevice;
     }
 
     const vk::raii::Instance& GraphicsContext::getInstance() const
     {
-        return *m_instance;
+        return m_graphicsDevice->getInstance();
     }
 
     const vk::raii::PhysicalDevice& GraphicsContext::getPhysicalDevice() const
     {
-        return *m_physicalDevice;
+        return m_graphicsDevice->getPhysicalDevice();
     }
 
     const vk::raii::SurfaceKHR& GraphicsContext::getSurface() const
@@ -45,7 +109,7 @@ namespace LearnVulkanRAII
 
     const vk::raii::Device& GraphicsContext::getDevice() const
     {
-        return *m_device;
+        return m_graphicsDevice->getDevice();
     }
 
     const vk::raii::SwapchainKHR& GraphicsContext::getSwapchain() const
@@ -55,22 +119,22 @@ namespace LearnVulkanRAII
 
     const vk::raii::CommandPool& GraphicsContext::getCommandPool() const
     {
-        return *m_commandPool;
+        return m_graphicsDevice->getCommandPool();
     }
 
     const vk::raii::Queue& GraphicsContext::getGraphicsQueue() const
     {
-        return *m_graphicsQueue;
+        return m_graphicsDevice->getGraphicsQueue();
     }
 
     const vk::raii::Queue& GraphicsContext::getPresentQueue() const
     {
-        return *m_presentQueue;
+        return m_graphicsDevice->getPresentQueue();
     }
 
     DeviceQueueFamilyIndices GraphicsContext::getQueueFamilyIndices() const
     {
-        return m_queueFamilyIndices;
+        return m_graphicsDevice->getQueueFamilyIndices();
     }
 
     vk::Format GraphicsContext::getSwapchainImageFormat() const
@@ -83,189 +147,103 @@ namespace LearnVulkanRAII
         return m_swapchainExtent;
     }
 
-    const std::vector<vk::raii::ImageView> & GraphicsContext::getSwapchainImageViews() const
+    const std::vector<vk::Image>& GraphicsContext::getSwapchainImages() const
     {
-        return m_swapchainImageViews;
+        return m_swapchainImages;
     }
 
-    vk::SurfaceCapabilitiesKHR GraphicsContext::getSurfaceCapabilities() const
+    const std::vector<vk::raii::ImageView> & GraphicsContext::getSwapchainImageViews() const
     {
-        return m_physicalDevice->getSurfaceCapabilitiesKHR(**m_surface);
+        return m_swapchainImageViews;
     }
 
-    uint32_t GraphicsContext::findMemoryType(uint32_t typeBits, vk::MemoryPropertyFlags properties) const
+    uint32_t GraphicsContext::getSwapchainImageCount() const
     {
-        auto memProperties = m_physicalDevice->getMemoryProperties();
-
-        for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
-        {
-            if ((typeBits & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
-                return i;
-        }
+        if (isHeadless())
+            return m_headlessSpec->frameSlotCount;
 
-        ASSERT(false, "Failed to find suitable memory type!");
-        return 0;
+        return static_cast<uint32_t>(m_swapchainImages.size());
     }
 
-    vk::Format GraphicsContext::findDepthFormat() const
+    uint32_t GraphicsContext::getFrameSlotCount() const
     {
-        static std::vector candidates = {
-            vk::Format::eD32SfloatS8Uint,
-            vk::Format::eD24UnormS8Uint,
-            vk::Format::eD32Sfloat,
-        };
-
-        for (auto& format : candidates)
-        {
-            auto props = m_physicalDevice->getFormatProperties(format);
-            if ((props.optimalTilingFeatures & vk::FormatFeatureFlagBits::eDepthStencilAttachment) ==
-                vk::FormatFeatureFlagBits::eDepthStencilAttachment)
-                return format;
-        }
-
-        ASSERT(false, "Failed to find suitable depth format!");
-        return vk::Format::eUndefined;
+        return m_frameSlotCount;
     }
 
-    GraphicsContext::Shared GraphicsContext::create(Window* window)
+    bool GraphicsContext::isHeadless() const
     {
-        return Utils::makeShared<GraphicsContext>(window);
+        return m_headlessSpec.has_value();
     }
 
-    void GraphicsContext::init()
+    vk::SurfaceCapabilitiesKHR GraphicsContext::getSurfaceCapabilities() const
     {
-        createInstance();
-        createSurface();
-        pickPhysicalDevice();
-        createLogicalDevice();
-        createSwapchain();
-        createImageViews();
-        createCommandPool();
+        ASSERT(!isHeadless(), "A headless context has no surface!");
+        return getPhysicalDevice().getSurfaceCapabilitiesKHR(**m_surface);
     }
 
-    void GraphicsContext::createInstance()
+    uint32_t GraphicsContext::findMemoryType(uint32_t typeBits, vk::MemoryPropertyFlags properties) const
     {
-        const std::string& title = m_window->getTitle();
-        vk::ApplicationInfo appInfo{
-            title.c_str(),
-            VK_MAKE_API_VERSION(0, 1, 0, 0),
-            "LearnVulkanRAII Engine",
-            VK_MAKE_API_VERSION(0, 1, 0, 0),
-            VK_API_VERSION_1_4,
-        };
-
-        vk::InstanceCreateInfo createInfo{
-            {},
-            &appInfo
-        };
-        uint32_t glfwRequiredExtensionCount = 0;
-        const char** glfwRequiredExtensions = glfwGetRequiredInstanceExtensions(&glfwRequiredExtensionCount);
-        createInfo.enabledExtensionCount = glfwRequiredExtensionCount;
-        createInfo.ppEnabledExtensionNames = glfwRequiredExtensions;
-
-        m_context = vk::raii::Context();
-        m_instance = vk::raii::Instance(*m_context, createInfo);
+        return m_graphicsDevice->findMemoryType(typeBits, properties);
     }
 
-    void GraphicsContext::createSurface()
+    vk::Format GraphicsContext::findDepthFormat() const
     {
-        VkSurfaceKHR surface = VK_NULL_HANDLE;
-        const auto result = glfwCreateWindowSurface(**m_instance,
-                                                    m_window->getNativeWindow(),
-                                                    nullptr,
-                                                    &surface);
-        ASSERT(result == VK_SUCCESS, "Failed to create GLFW window surface");
-
-        m_surface = vk::raii::SurfaceKHR(*m_instance, surface);
+        return m_graphicsDevice->findDepthFormat();
     }
 
-    void GraphicsContext::pickPhysicalDevice()
+    GraphicsContext::Shared GraphicsContext::create(Window* window)
     {
-        auto devices = m_instance->enumeratePhysicalDevices();
-        ASSERT(devices.size(), "No vulkan supported devices found");
-
-        for (auto& device : devices)
-        {
-            if (isDeviceSuitable(device))
-            {
-                m_physicalDevice = std::move(device);
-                break;
-            }
-        }
-
-        ASSERT(m_physicalDevice.has_value(), "No suitable device found");
-        LOG("Selected Device: {}", m_physicalDevice->getProperties().deviceName.data());
+        return Utils::makeShared<GraphicsContext>(window);
     }
 
-    void GraphicsContext::createLogicalDevice()
+    GraphicsContext::Shared GraphicsContext::create(Window* window, const GraphicsDevice::Shared& graphicsDevice)
     {
-        auto queueFamilies = m_physicalDevice->getQueueFamilyProperties();
+        return Utils::makeShared<GraphicsContext>(window, graphicsDevice);
+    }
 
-        int graphicsQueueFamilyIndex = -1;
-        int presentQueueFamilyIndex = -1;
+    GraphicsContext::Shared GraphicsContext::createHeadless(const HeadlessContextSpecification& spec)
+    {
+        return Utils::makeShared<GraphicsContext>(spec);
+    }
 
-        for (size_t i = 0; i < queueFamilies.size(); ++i)
+    void GraphicsContext::init()
+    {
+        if (!isHeadless())
+            createSurface();
+        m_graphicsDevice->initDevice(m_surface ? &*m_surface : nullptr);
+        if (isHeadless())
         {
-            auto& qf = queueFamilies[i];
-            if ((qf.queueFlags & vk::QueueFlagBits::eGraphics) && graphicsQueueFamilyIndex == -1)
-            {
-                graphicsQueueFamilyIndex = i;
-            }
-
-            VkBool32 supportsPresent = m_physicalDevice->getSurfaceSupportKHR(i, **m_surface);
-            if (supportsPresent && presentQueueFamilyIndex == -1)
-            {
-                presentQueueFamilyIndex = i;
-            }
-
-            if (graphicsQueueFamilyIndex != -1 && presentQueueFamilyIndex != -1)
-            {
-                break;
-            }
+            // Stands in for the swapchain, the renderer sizes its offscreen attachments after it
+            m_swapchainImageFormat = m_headlessSpec->colorFormat;
+            m_swapchainExtent = vk::Extent2D{ m_headlessSpec->width, m_headlessSpec->height };
         }
-
-        m_queueFamilyIndices = { graphicsQueueFamilyIndex, presentQueueFamilyIndex };
-
-        std::set uniqueQueueFamilies = { graphicsQueueFamilyIndex, presentQueueFamilyIndex };
-        float priority = 1.0f;
-        std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
-        queueCreateInfos.reserve(uniqueQueueFamilies.size());
-
-        for (const int qf: uniqueQueueFamilies)
+        else
         {
-            vk::DeviceQueueCreateInfo queueCreateInfo{
-                {},
-                static_cast<uint32_t>(qf),
-                1,
-                &priority
-            };
-            queueCreateInfos.push_back(queueCreateInfo);
+            m_requestedExtent = vk::Extent2D{ m_window->getWidth(), m_window->getHeight() };
+            createSwapchain();
+            createImageViews();
         }
 
-        static std::vector deviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+        m_frameSlotCount = getSwapchainImageCount();
+    }
 
-        vk::PhysicalDeviceFeatures deviceFeatures{};
-        vk::DeviceCreateInfo createInfo{
-            {},
-            static_cast<uint32_t>(queueCreateInfos.size()),
-            queueCreateInfos.data(),
-            0,
-            nullptr,
-            static_cast<uint32_t>(deviceExtensions.size()),
-            deviceExtensions.data(),
-            &deviceFeatures
-        };
+    void GraphicsContext::createSurface()
+    {
+        VkSurfaceKHR surface = VK_NULL_HANDLE;
+        const auto result = glfwCreateWindowSurface(*getInstance(),
+                                                    m_window->getNativeWindow(),
+                                                    nullptr,
+                                                    &surface);
+        ASSERT(result == VK_SUCCESS, "Failed to create GLFW window surface");
 
-        m_device = m_physicalDevice->createDevice(createInfo);
-        m_graphicsQueue = m_device->getQueue(graphicsQueueFamilyIndex, 0);
-        m_presentQueue = m_device->getQueue(presentQueueFamilyIndex, 0);
+        m_surface = vk::raii::SurfaceKHR(getInstance(), surface);
     }
 
-    void GraphicsContext::createSwapchain()
+    void GraphicsContext::createSwapchain(vk::SwapchainKHR oldSwapchain)
     {
         vk::SurfaceCapabilitiesKHR caps = getSurfaceCapabilities();
 
-        vk::Extent2D extent = { m_window->getWidth(), m_window->getHeight() };
+        vk::Extent2D extent = m_requestedExtent;
         if (caps.currentExtent.width != UINT32_MAX)
         {
             extent = caps.currentExtent;
@@ -289,7 +267,7 @@ namespace LearnVulkanRAII
             vk::ImageUsageFlagBits::eColorAttachment
         };
 
-        auto [graphicsQueueFamilyIndex, presentQueueFamilyIndex] = m_queueFamilyIndices;
+        auto [graphicsQueueFamilyIndex, presentQueueFamilyIndex] = getQueueFamilyIndices();
         if (graphicsQueueFamilyIndex != presentQueueFamilyIndex)
         {
             uint32_t queueFamilyIndices[] = {
@@ -309,8 +287,9 @@ namespace LearnVulkanRAII
         swapchainCreateInfo.compositeAlpha = vk::CompositeAlphaFlagBitsKHR::eOpaque;
         swapchainCreateInfo.presentMode = vk::PresentModeKHR::eFifo;
         swapchainCreateInfo.clipped = VK_TRUE;
+        swapchainCreateInfo.oldSwapchain = oldSwapchain;
 
-        m_swapchain = m_device->createSwapchainKHR(swapchainCreateInfo);
+        m_swapchain = getDevice().createSwapchainKHR(swapchainCreateInfo);
         m_swapchainImages = m_swapchain->getImages();
         m_swapchainImageFormat = imageFormat;
         m_swapchainExtent = extent;
@@ -330,48 +309,7 @@ namespace LearnVulkanRAII
                 { vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 }
             };
 
-            m_swapchainImageViews.emplace_back(*m_device, viewCreateInfo);
-        }
-    }
-
-    void GraphicsContext::createCommandPool()
-    {
-        vk::CommandPoolCreateInfo commandPoolCreateInfo{
-            vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
-            static_cast<uint32_t>(m_queueFamilyIndices.graphicsQueueFamilyIndex)
-        };
-
-        m_commandPool = m_device->createCommandPool(commandPoolCreateInfo);
-    }
-
-    bool GraphicsContext::isDeviceSuitable(const vk::raii::PhysicalDevice &physicalDevice) const
-    {
-        auto queueFamilies = physicalDevice.getQueueFamilyProperties();
-
-        bool foundGraphics = false;
-        bool foundPresent = false;
-
-        for (uint32_t i = 0; i < queueFamilies.size(); ++i)
-        {
-            const auto& qf = queueFamilies[i];
-            if (qf.queueFlags & vk::QueueFlagBits::eGraphics)
-            {
-                foundGraphics = true;
-            }
-
-            VkBool32 presentSupport = physicalDevice.getSurfaceSupportKHR(i, *m_surface.value());
-            if (presentSupport)
-            {
-                foundPresent = true;
-            }
-
-            if (foundGraphics && foundPresent)
-            {
-                break;
-            }
+            m_swapchainImageViews.emplace_back(getDevice(), viewCreateInfo);
         }
-
-        return foundGraphics && foundPresent;
     }
-
 } // LearnVulkanRAII
\ No newline at end of file
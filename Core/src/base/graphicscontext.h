@@ -6,20 +6,29 @@
 #define LEARNVULKANRAII_GRAPHICSCONTEXT_H
 
 #include <set>
+#include <string>
 
 #include "utils.h"
+#include "graphicsdevice.h"
 
 #include <vulkan/vulkan_raii.hpp>
 
 namespace LearnVulkanRAII
 {
-    struct DeviceQueueFamilyIndices
+    // Context without a window: no surface, no swapchain and no present queue.
+    // The renderer draws into offscreen framebuffers of this size and format instead
+    struct HeadlessContextSpecification
     {
-        int graphicsQueueFamilyIndex = -1;
-        int presentQueueFamilyIndex = -1;
+        std::string applicationName = "LearnVulkanRAII Headless";
+        uint32_t width = 1280;
+        uint32_t height = 720;
+        uint32_t frameSlotCount = 3;
+        vk::Format colorFormat = vk::Format::eB8G8R8A8Unorm;
     };
 
     class Window;
+    // Per window surface and swapchain on top of a GraphicsDevice, which windows share by default.
+    // The device getters forward to it, so the rest of the engine only ever deals with the context
     class GraphicsContext
     {
     public:
@@ -27,9 +36,22 @@ namespace LearnVulkanRAII
 
     public:
         explicit GraphicsContext(Window* window);
+        GraphicsContext(Window* window, const GraphicsDevice::Shared& graphicsDevice);
+        explicit GraphicsContext(const HeadlessContextSpecification& spec);
 
+        // Only records the size, the swapchain is recreated by recreateSwapchain() before the next frame.
+        // Any number of resizes between two frames make a single recreation
         void resize(uint32_t width, uint32_t height);
-
+        // Acquire or present reported the swapchain out of date or suboptimal
+        void invalidateSwapchain();
+        [[nodiscard]] bool isSwapchainOutOfDate() const;
+        // Hands the current swapchain over to a new one, the old one is retired until the frames in flight are done
+        // with it. Fails while the surface has no area (minimized), the request stays pending then
+        bool recreateSwapchain();
+        // Once per frame, after the frame slot's fence wait. Destroys the retired swapchains every frame slot is past
+        void nextFrame();
+
+        [[nodiscard]] const GraphicsDevice::Shared& getGraphicsDevice() const;
         [[nodiscard]] const vk::raii::Instance& getInstance() const;
         [[nodiscard]] const vk::raii::PhysicalDevice& getPhysicalDevice() const;
         [[nodiscard]] const vk::raii::SurfaceKHR& getSurface() const;
@@ -42,7 +64,14 @@ namespace LearnVulkanRAII
         [[nodiscard]] DeviceQueueFamilyIndices getQueueFamilyIndices() const;
         [[nodiscard]] vk::Format getSwapchainImageFormat() const;
         [[nodiscard]] vk::Extent2D getSwapchainExtent() const;
+        [[nodiscard]] const std::vector<vk::Image>& getSwapchainImages() const;
         [[nodiscard]] const std::vector<vk::raii::ImageView>& getSwapchainImageViews() const;
+        // The swapchain's images, the headless frame slot count stands in for them. Can change with a recreation
+        [[nodiscard]] uint32_t getSwapchainImageCount() const;
+        // Frames the renderer keeps resources for, fixed for the context's lifetime: the first swapchain's image count,
+        // or the headless frame slot count. Recreated swapchains may have more or fewer images
+        [[nodiscard]] uint32_t getFrameSlotCount() const;
+        [[nodiscard]] bool isHeadless() const;
 
         // Utility functions
         [[nodiscard]] vk::SurfaceCapabilitiesKHR getSurfaceCapabilities() const;
@@ -50,32 +79,24 @@ namespace LearnVulkanRAII
         [[nodiscard]] vk::Format findDepthFormat() const;
 
         static Shared create(Window* window);
+        static Shared create(Window* window, const GraphicsDevice::Shared& graphicsDevice);
+        static Shared createHeadless(const HeadlessContextSpecification& spec = {});
 
     private:
         void init();
 
-        void createInstance();
         void createSurface();
-        void pickPhysicalDevice();
-        void createLogicalDevice();
-        void createSwapchain();
+        void createSwapchain(vk::SwapchainKHR oldSwapchain = nullptr);
         void createImageViews();
-        void createCommandPool();
-
-        bool isDeviceSuitable(const vk::raii::PhysicalDevice& physicalDevice) const;
 
     private:
+        // Declared first, the device outlives the surface and swapchain created from it
+        GraphicsDevice::Shared m_graphicsDevice;
+
         Window* m_window = nullptr;
-        Utils::Optional<vk::raii::Context> m_context;
-        Utils::Optional<vk::raii::Instance> m_instance;
+        Utils::Optional<HeadlessContextSpecification> m_headlessSpec;
 
         Utils::Optional<vk::raii::SurfaceKHR> m_surface;
-        Utils::Optional<vk::raii::PhysicalDevice> m_physicalDevice;
-        Utils::Optional<vk::raii::Device> m_device;
-        Utils::Optional<vk::raii::Queue> m_graphicsQueue;
-        Utils::Optional<vk::raii::Queue> m_presentQueue;
-
-        DeviceQueueFamilyIndices m_queueFamilyIndices;
 
         Utils::Optional<vk::raii::SwapchainKHR> m_swapchain;
         std::vector<vk::Image> m_swapchainImages;
@@ -83,7 +104,17 @@ namespace LearnVulkanRAII
         vk::Extent2D m_swapchainExtent;
         std::vector<vk::raii::ImageView> m_swapchainImageViews;
 
-        Utils::Optional<vk::raii::CommandPool> m_commandPool;
+        struct RetiredSwapchain
+        {
+            Utils::Optional<vk::raii::SwapchainKHR> swapchain;
+            std::vector<vk::raii::ImageView> imageViews;
+            uint32_t framesLeft = 0;
+        };
+
+        std::vector<RetiredSwapchain> m_retiredSwapchains;
+        uint32_t m_frameSlotCount = 0;
+        vk::Extent2D m_requestedExtent;
+        bool m_swapchainOutOfDate = false;
 
         friend class Window;
     };
@@ -0,0 +1,336 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#include "graphicsdevice.h"
+
+#include <glfw/glfw3.h>
+
+#include <set>
+
+namespace LearnVulkanRAII
+{
+    GraphicsDevice::GraphicsDevice(const std::string& applicationName, bool headless)
+        : m_applicationName(applicationName),
+        m_headless(headless)
+    {
+        createInstance();
+    }
+
+    void GraphicsDevice::initDevice(const vk::raii::SurfaceKHR* surface)
+    {
+        ASSERT(m_headless || surface, "A device presenting to windows needs a surface to be created with!");
+
+        if (isDeviceCreated())
+        {
+            // Windows after the first present from the queue family chosen for it
+            if (surface)
+            {
+                const auto presentQueueFamilyIndex = static_cast<uint32_t>(m_queueFamilyIndices.presentQueueFamilyIndex);
+                ASSERT(m_physicalDevice->getSurfaceSupportKHR(presentQueueFamilyIndex, **surface),
+                    "The shared device can't present to this surface!");
+            }
+            return;
+        }
+
+        pickPhysicalDevice(surface);
+        createLogicalDevice(surface);
+        createCommandPool();
+    }
+
+    bool GraphicsDevice::isDeviceCreated() const
+    {
+        return m_device.has_value();
+    }
+
+    bool GraphicsDevice::isHeadless() const
+    {
+        return m_headless;
+    }
+
+    const vk::raii::Instance& GraphicsDevice::getInstance() const
+    {
+        return *m_instance;
+    }
+
+    const vk::raii::PhysicalDevice& GraphicsDevice::getPhysicalDevice() const
+    {
+        return *m_physicalDevice;
+    }
+
+    const vk::raii::Device& GraphicsDevice::getDevice() const
+    {
+        return *m_device;
+    }
+
+    const vk::raii::CommandPool& GraphicsDevice::getCommandPool() const
+    {
+        return *m_commandPool;
+    }
+
+    const vk::raii::Queue& GraphicsDevice::getGraphicsQueue() const
+    {
+        return *m_graphicsQueue;
+    }
+
+    const vk::raii::Queue& GraphicsDevice::getPresentQueue() const
+    {
+        return *m_presentQueue;
+    }
+
+    DeviceQueueFamilyIndices GraphicsDevice::getQueueFamilyIndices() const
+    {
+        return m_queueFamilyIndices;
+    }
+
+    uint32_t GraphicsDevice::findMemoryType(uint32_t typeBits, vk::MemoryPropertyFlags properties) const
+    {
+        auto memProperties = m_physicalDevice->getMemoryProperties();
+
+        for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
+        {
+            if ((typeBits & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
+                return i;
+        }
+
+        ASSERT(false, "Failed to find suitable memory type!");
+        return 0;
+    }
+
+    vk::Format GraphicsDevice::findDepthFormat() const
+    {
+        static std::vector candidates = {
+            vk::Format::eD32SfloatS8Uint,
+            vk::Format::eD24UnormS8Uint,
+            vk::Format::eD32Sfloat,
+        };
+
+        for (auto& format : candidates)
+        {
+            auto props = m_physicalDevice->getFormatProperties(format);
+            if ((props.optimalTilingFeatures & vk::FormatFeatureFlagBits::eDepthStencilAttachment) ==
+                vk::FormatFeatureFlagBits::eDepthStencilAttachment)
+                return format;
+        }
+
+        ASSERT(false, "Failed to find suitable depth format!");
+        return vk::Format::eUndefined;
+    }
+
+    GraphicsDevice::Shared GraphicsDevice::create(const std::string& applicationName, bool headless)
+    {
+        return Utils::makeShared<GraphicsDevice>(applicationName, headless);
+    }
+
+    GraphicsDevice::Shared GraphicsDevice::getShared(const std::string& applicationName)
+    {
+        static Weak sharedDevice;
+
+        auto device = sharedDevice.lock();
+        if (!device)
+        {
+            device = create(applicationName, false);
+            sharedDevice = device;
+        }
+
+        return device;
+    }
+
+    void GraphicsDevice::createInstance()
+    {
+        vk::ApplicationInfo appInfo{
+            m_applicationName.c_str(),
+            VK_MAKE_API_VERSION(0, 1, 0, 0),
+            "LearnVulkanRAII Engine",
+            VK_MAKE_API_VERSION(0, 1, 0, 0),
+            VK_API_VERSION_1_4,
+        };
+
+        vk::InstanceCreateInfo createInfo{
+            {},
+            &appInfo
+        };
+        // Surface extensions aren't needed (or available, without a display) when nothing is presented
+        if (!m_headless)
+        {
+            uint32_t glfwRequiredExtensionCount = 0;
+            const char** glfwRequiredExtensions = glfwGetRequiredInstanceExtensions(&glfwRequiredExtensionCount);
+            createInfo.enabledExtensionCount = glfwRequiredExtensionCount;
+            createInfo.ppEnabledExtensionNames = glfwRequiredExtensions;
+        }
+
+        m_context = vk::raii::Context();
+        m_instance = vk::raii::Instance(*m_context, createInfo);
+    }
+
+    void GraphicsDevice::pickPhysicalDevice(const vk::raii::SurfaceKHR* surface)
+    {
+        auto devices = m_instance->enumeratePhysicalDevices();
+        ASSERT(devices.size(), "No vulkan supported devices found");
+
+        for (auto& device : devices)
+        {
+            if (isDeviceSuitable(device, surface))
+            {
+                m_physicalDevice = std::move(device);
+                break;
+            }
+        }
+
+        ASSERT(m_physicalDevice.has_value(), "No suitable device found");
+        LOG("Selected Device: {}", m_physicalDevice->getProperties().deviceName.data());
+    }
+
+    void GraphicsDevice::createLogicalDevice(const vk::raii::SurfaceKHR* surface)
+    {
+        auto queueFamilies = m_physicalDevice->getQueueFamilyProperties();
+
+        int graphicsQueueFamilyIndex = -1;
+        int presentQueueFamilyIndex = -1;
+
+        for (size_t i = 0; i < queueFamilies.size(); ++i)
+        {
+            auto& qf = queueFamilies[i];
+            if ((qf.queueFlags & vk::QueueFlagBits::eGraphics) && graphicsQueueFamilyIndex == -1)
+            {
+                graphicsQueueFamilyIndex = i;
+            }
+
+            // Headless, the present queue is only an alias of the graphics queue
+            VkBool32 supportsPresent = m_headless
+                ? (qf.queueFlags & vk::QueueFlagBits::eGraphics) != vk::QueueFlags{}
+                : m_physicalDevice->getSurfaceSupportKHR(i, **surface);
+            if (supportsPresent && presentQueueFamilyIndex == -1)
+            {
+                presentQueueFamilyIndex = i;
+            }
+
+            if (graphicsQueueFamilyIndex != -1 && presentQueueFamilyIndex != -1)
+            {
+                break;
+            }
+        }
+
+        m_queueFamilyIndices = { graphicsQueueFamilyIndex, presentQueueFamilyIndex };
+
+        std::set uniqueQueueFamilies = { graphicsQueueFamilyIndex, presentQueueFamilyIndex };
+        float priority = 1.0f;
+        std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
+        queueCreateInfos.reserve(uniqueQueueFamilies.size());
+
+        for (const int qf: uniqueQueueFamilies)
+        {
+            vk::DeviceQueueCreateInfo queueCreateInfo{
+                {},
+                static_cast<uint32_t>(qf),
+                1,
+                &priority
+            };
+            queueCreateInfos.push_back(queueCreateInfo);
+        }
+
+        std::vector<const char*> deviceExtensions;
+        if (!m_headless)
+            deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+
+        // Descriptor indexing (Vulkan 1.2 core) backs the renderer's bindless descriptor set
+        vk::PhysicalDeviceVulkan12Features vulkan12Features{};
+        vulkan12Features.descriptorIndexing = VK_TRUE;
+        vulkan12Features.runtimeDescriptorArray = VK_TRUE;
+        vulkan12Features.descriptorBindingPartiallyBound = VK_TRUE;
+        vulkan12Features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+        // Frame slots register their buffers while the other slots' command buffers are still pending
+        vulkan12Features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+        vulkan12Features.shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+        // The GPU culling pass writes the draw count the retained scene is drawn with
+        vulkan12Features.drawIndirectCount = VK_TRUE;
+
+        // The renderer records its passes with dynamic rendering and synchronization2 barriers (Vulkan 1.3 core)
+        vk::PhysicalDeviceVulkan13Features vulkan13Features{};
+        vulkan13Features.dynamicRendering = VK_TRUE;
+        vulkan13Features.synchronization2 = VK_TRUE;
+        vulkan12Features.pNext = &vulkan13Features;
+
+        vk::PhysicalDeviceFeatures2 deviceFeatures{};
+        deviceFeatures.pNext = &vulkan12Features;
+
+        // Resident renderables are drawn with one indirect call, firstInstance selects their instance record
+        deviceFeatures.features.multiDrawIndirect = VK_TRUE;
+        deviceFeatures.features.drawIndirectFirstInstance = VK_TRUE;
+
+        vk::DeviceCreateInfo createInfo{
+            {},
+            static_cast<uint32_t>(queueCreateInfos.size()),
+            queueCreateInfos.data(),
+            0,
+            nullptr,
+            static_cast<uint32_t>(deviceExtensions.size()),
+            deviceExtensions.data(),
+            nullptr
+        };
+        createInfo.pNext = &deviceFeatures;
+
+        m_device = m_physicalDevice->createDevice(createInfo);
+        m_graphicsQueue = m_device->getQueue(graphicsQueueFamilyIndex, 0);
+        m_presentQueue = m_device->getQueue(presentQueueFamilyIndex, 0);
+    }
+
+    void GraphicsDevice::createCommandPool()
+    {
+        vk::CommandPoolCreateInfo commandPoolCreateInfo{
+            vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+            static_cast<uint32_t>(m_queueFamilyIndices.graphicsQueueFamilyIndex)
+        };
+
+        m_commandPool = m_device->createCommandPool(commandPoolCreateInfo);
+    }
+
+    bool GraphicsDevice::isDeviceSuitable(const vk::raii::PhysicalDevice& physicalDevice, const vk::raii::SurfaceKHR* surface) const
+    {
+        auto queueFamilies = physicalDevice.getQueueFamilyProperties();
+
+        bool foundGraphics = false;
+        bool foundPresent = false;
+
+        for (uint32_t i = 0; i < queueFamilies.size(); ++i)
+        {
+            const auto& qf = queueFamilies[i];
+            if (qf.queueFlags & vk::QueueFlagBits::eGraphics)
+            {
+                foundGraphics = true;
+            }
+
+            VkBool32 presentSupport = m_headless || physicalDevice.getSurfaceSupportKHR(i, **surface);
+            if (presentSupport)
+            {
+                foundPresent = true;
+            }
+
+            if (foundGraphics && foundPresent)
+            {
+                break;
+            }
+        }
+
+        auto features = physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2,
+            vk::PhysicalDeviceVulkan12Features,
+            vk::PhysicalDeviceVulkan13Features>();
+        const auto& vulkan12Features = features.get<vk::PhysicalDeviceVulkan12Features>();
+        const auto& vulkan13Features = features.get<vk::PhysicalDeviceVulkan13Features>();
+        bool supportsBindless = vulkan12Features.descriptorIndexing &&
+            vulkan12Features.runtimeDescriptorArray &&
+            vulkan12Features.descriptorBindingPartiallyBound &&
+            vulkan12Features.descriptorBindingStorageBufferUpdateAfterBind &&
+            vulkan12Features.descriptorBindingUpdateUnusedWhilePending &&
+            vulkan12Features.shaderStorageBufferArrayNonUniformIndexing;
+
+        const auto& coreFeatures = features.get<vk::PhysicalDeviceFeatures2>().features;
+        bool supportsIndirect = coreFeatures.multiDrawIndirect &&
+            coreFeatures.drawIndirectFirstInstance &&
+            vulkan12Features.drawIndirectCount;
+
+        bool supportsDynamicRendering = vulkan13Features.dynamicRendering && vulkan13Features.synchronization2;
+
+        return foundGraphics && foundPresent && supportsBindless && supportsIndirect && supportsDynamicRendering;
+    }
+} // LearnVulkanRAII
\ No newline at end of file
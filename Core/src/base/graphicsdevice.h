@@ -0,0 +1,80 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#ifndef LEARNVULKANRAII_GRAPHICSDEVICE_H
+#define LEARNVULKANRAII_GRAPHICSDEVICE_H
+
+#include "utils.h"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <string>
+
+namespace LearnVulkanRAII
+{
+    struct DeviceQueueFamilyIndices
+    {
+        int graphicsQueueFamilyIndex = -1;
+        int presentQueueFamilyIndex = -1;
+    };
+
+    // Instance, physical and logical device, queues and the command pool, shared by every window's GraphicsContext.
+    // The device is created with the first surface it's asked to present to, later surfaces must be presentable
+    // from the same queue family. Headless devices skip the surface extensions and never present
+    class GraphicsDevice
+    {
+    public:
+        DEFINE_SMART_POINTER_HELPERS(GraphicsDevice)
+
+    public:
+        GraphicsDevice(const std::string& applicationName, bool headless);
+
+        // Creates the logical device on the first call, checks present support of the surface on the later ones
+        void initDevice(const vk::raii::SurfaceKHR* surface);
+        [[nodiscard]] bool isDeviceCreated() const;
+        [[nodiscard]] bool isHeadless() const;
+
+        [[nodiscard]] const vk::raii::Instance& getInstance() const;
+        [[nodiscard]] const vk::raii::PhysicalDevice& getPhysicalDevice() const;
+        [[nodiscard]] const vk::raii::Device& getDevice() const;
+        [[nodiscard]] const vk::raii::CommandPool& getCommandPool() const;
+        [[nodiscard]] const vk::raii::Queue& getGraphicsQueue() const;
+        [[nodiscard]] const vk::raii::Queue& getPresentQueue() const;
+        [[nodiscard]] DeviceQueueFamilyIndices getQueueFamilyIndices() const;
+
+        // Utility functions
+        [[nodiscard]] uint32_t findMemoryType(uint32_t typeBits, vk::MemoryPropertyFlags properties) const;
+        [[nodiscard]] vk::Format findDepthFormat() const;
+
+        static Shared create(const std::string& applicationName, bool headless);
+        // The device the windows share, created with the first window and destroyed with the last one
+        static Shared getShared(const std::string& applicationName);
+
+    private:
+        void createInstance();
+        void pickPhysicalDevice(const vk::raii::SurfaceKHR* surface);
+        void createLogicalDevice(const vk::raii::SurfaceKHR* surface);
+        void createCommandPool();
+
+        bool isDeviceSuitable(const vk::raii::PhysicalDevice& physicalDevice, const vk::raii::SurfaceKHR* surface) const;
+
+    private:
+        std::string m_applicationName;
+        bool m_headless = false;
+
+        Utils::Optional<vk::raii::Context> m_context;
+        Utils::Optional<vk::raii::Instance> m_instance;
+
+        Utils::Optional<vk::raii::PhysicalDevice> m_physicalDevice;
+        Utils::Optional<vk::raii::Device> m_device;
+        Utils::Optional<vk::raii::Queue> m_graphicsQueue;
+        Utils::Optional<vk::raii::Queue> m_presentQueue;
+
+        DeviceQueueFamilyIndices m_queueFamilyIndices;
+
+        Utils::Optional<vk::raii::CommandPool> m_commandPool;
+    };
+} // LearnVulkanRAII
+
+#endif //LEARNVULKANRAII_GRAPHICSDEVICE_H
\ No newline at end of file
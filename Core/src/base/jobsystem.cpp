@@ -0,0 +1,347 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#include "jobsystem.h"
+
+#include <algorithm>
+
+namespace LearnVulkanRAII
+{
+    namespace
+    {
+        // Index of the worker running on this thread, threads without a deque have none
+        constexpr uint32_t NoWorkerIndex = ~0u;
+        thread_local uint32_t t_workerIndex = NoWorkerIndex;
+        thread_local const JobSystem* t_workerJobSystem = nullptr;
+
+        // Worker spins before sleeping, jobs often come in bursts
+        constexpr uint32_t IdleSpinCount = 64;
+    }
+
+    struct Job
+    {
+        JobFunction function;
+        JobCounter* counter = nullptr;
+        JobAffinity affinity = JobAffinity::Any;
+    };
+
+    JobCounter::~JobCounter()
+    {
+        // The job that finished it may still hold the lock
+        std::lock_guard lock(m_mutex);
+    }
+
+    bool JobCounter::isDone() const
+    {
+        return m_value.load(std::memory_order_acquire) == 0;
+    }
+
+    uint32_t JobCounter::getValue() const
+    {
+        return m_value.load(std::memory_order_acquire);
+    }
+
+    JobSystem::JobSystem(uint32_t workerCount)
+        : m_mainThreadId(std::this_thread::get_id())
+    {
+        if (workerCount == 0)
+            workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+        m_queues.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; i++)
+        {
+            m_queues.push_back(Utils::makeUnique<WorkStealingDeque<Job>>());
+        }
+
+        m_workers.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; i++)
+        {
+            m_workers.emplace_back(&JobSystem::workerMain, this, i);
+        }
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard lock(m_sleepMutex);
+            m_stopping.store(true);
+        }
+        m_wakeCondition.notify_all();
+
+        for (auto& worker : m_workers)
+        {
+            worker.join();
+        }
+
+        // Jobs still queued are dropped
+        for (auto& queue : m_queues)
+        {
+            while (Job* job = queue->pop())
+                delete job;
+        }
+        for (Job* job : m_injectionQueue)
+            delete job;
+        for (Job* job : m_mainThreadQueue)
+            delete job;
+    }
+
+    void JobSystem::schedule(const JobFunction& function,
+        JobCounter* counter,
+        JobCounter* dependency,
+        JobAffinity affinity)
+    {
+        // Counted right away, a wait() before the job is queued mustn't return early
+        if (counter)
+            counter->m_value.fetch_add(1, std::memory_order_relaxed);
+
+        auto* job = new Job{ function, counter, affinity };
+
+        if (dependency)
+        {
+            std::lock_guard lock(dependency->m_mutex);
+
+            // finish() drains the waiting jobs after the counter reached zero, under the same lock
+            if (!dependency->isDone())
+            {
+                dependency->m_waitingJobs.push_back(job);
+                return;
+            }
+        }
+
+        submit(job);
+    }
+
+    void JobSystem::wait(const JobCounter& counter)
+    {
+        const bool isWorker = t_workerJobSystem == this;
+        const uint32_t workerIndex = isWorker ? t_workerIndex : NoWorkerIndex;
+        const bool mainThread = isMainThread();
+
+        while (!counter.isDone())
+        {
+            if (mainThread && runMainThreadJob())
+                continue;
+
+            if (Job* job = findJob(workerIndex))
+            {
+                execute(job);
+                continue;
+            }
+
+            // The remaining jobs run on other threads
+            std::this_thread::yield();
+        }
+    }
+
+    void JobSystem::parallelFor(uint32_t count, uint32_t grainSize, const ParallelForFunction& function)
+    {
+        if (count == 0)
+            return;
+
+        grainSize = std::max(grainSize, 1u);
+        if (count <= grainSize || m_workers.empty())
+        {
+            function(0, count);
+            return;
+        }
+
+        JobCounter counter;
+        // The first range is kept for the calling thread
+        for (uint32_t begin = grainSize; begin < count; begin += grainSize)
+        {
+            const uint32_t end = std::min(begin + grainSize, count);
+            schedule([&function, begin, end] { function(begin, end); }, &counter);
+        }
+
+        function(0, grainSize);
+        wait(counter);
+    }
+
+    void JobSystem::runMainThreadJobs()
+    {
+        ASSERT(isMainThread(), "Main thread jobs must be run on the main thread!");
+
+        while (runMainThreadJob())
+        {
+        }
+    }
+
+    uint32_t JobSystem::getWorkerCount() const
+    {
+        return static_cast<uint32_t>(m_workers.size());
+    }
+
+    bool JobSystem::isMainThread() const
+    {
+        return std::this_thread::get_id() == m_mainThreadId;
+    }
+
+    JobSystem::Shared JobSystem::create(uint32_t workerCount)
+    {
+        return makeShared(workerCount);
+    }
+
+    JobSystem::Shared JobSystem::getShared()
+    {
+        static std::mutex mutex;
+        static Weak weakJobSystem;
+
+        std::lock_guard lock(mutex);
+        auto jobSystem = weakJobSystem.lock();
+        if (!jobSystem)
+        {
+            jobSystem = create();
+            weakJobSystem = jobSystem;
+        }
+
+        return jobSystem;
+    }
+
+    void JobSystem::workerMain(uint32_t workerIndex)
+    {
+        t_workerIndex = workerIndex;
+        t_workerJobSystem = this;
+
+        uint32_t idleCount = 0;
+        while (!m_stopping.load(std::memory_order_relaxed))
+        {
+            if (Job* job = findJob(workerIndex))
+            {
+                execute(job);
+                idleCount = 0;
+                continue;
+            }
+
+            if (++idleCount < IdleSpinCount)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock lock(m_sleepMutex);
+            m_sleepingWorkerCount.fetch_add(1);
+            m_wakeCondition.wait(lock, [this] {
+                return m_pendingJobCount.load() > 0 || m_stopping.load();
+            });
+            m_sleepingWorkerCount.fetch_sub(1);
+            idleCount = 0;
+        }
+
+        t_workerIndex = NoWorkerIndex;
+        t_workerJobSystem = nullptr;
+    }
+
+    void JobSystem::submit(Job* job)
+    {
+        if (job->affinity == JobAffinity::MainThread)
+        {
+            std::lock_guard lock(m_mainThreadMutex);
+            m_mainThreadQueue.push_back(job);
+            return;
+        }
+
+        if (m_workers.empty())
+        {
+            // Nobody to hand it to
+            execute(job);
+            return;
+        }
+
+        m_pendingJobCount.fetch_add(1);
+
+        if (t_workerJobSystem == this)
+        {
+            m_queues[t_workerIndex]->push(job);
+        }
+        else
+        {
+            std::lock_guard lock(m_injectionMutex);
+            m_injectionQueue.push_back(job);
+        }
+
+        if (m_sleepingWorkerCount.load() > 0)
+        {
+            // Under the lock, a worker between its check and its wait would miss the notification otherwise
+            std::lock_guard lock(m_sleepMutex);
+            m_wakeCondition.notify_one();
+        }
+    }
+
+    Job* JobSystem::findJob(uint32_t workerIndex)
+    {
+        Job* job = nullptr;
+
+        // Own jobs first, newest first
+        if (workerIndex != NoWorkerIndex)
+            job = m_queues[workerIndex]->pop();
+
+        if (!job)
+        {
+            std::lock_guard lock(m_injectionMutex);
+            if (!m_injectionQueue.empty())
+            {
+                job = m_injectionQueue.back();
+                m_injectionQueue.pop_back();
+            }
+        }
+
+        // Steal the oldest job of the others, starting past our own deque so the thieves spread out
+        const auto queueCount = static_cast<uint32_t>(m_queues.size());
+        const uint32_t start = workerIndex != NoWorkerIndex ? workerIndex + 1 : 0;
+        for (uint32_t i = 0; !job && i < queueCount; i++)
+        {
+            const uint32_t victim = (start + i) % queueCount;
+            if (victim != workerIndex)
+                job = m_queues[victim]->steal();
+        }
+
+        if (job)
+            m_pendingJobCount.fetch_sub(1);
+
+        return job;
+    }
+
+    void JobSystem::execute(Job* job)
+    {
+        job->function();
+
+        if (job->counter)
+            finish(*job->counter);
+
+        delete job;
+    }
+
+    void JobSystem::finish(JobCounter& counter)
+    {
+        std::vector<Job*> readyJobs;
+        {
+            // The counter isn't touched after the unlock, a waiter may destroy it as soon as it's done
+            std::lock_guard lock(counter.m_mutex);
+            if (counter.m_value.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                readyJobs.swap(counter.m_waitingJobs);
+        }
+
+        for (Job* job : readyJobs)
+        {
+            submit(job);
+        }
+    }
+
+    bool JobSystem::runMainThreadJob()
+    {
+        Job* job = nullptr;
+        {
+            std::lock_guard lock(m_mainThreadMutex);
+            if (m_mainThreadQueue.empty())
+                return false;
+
+            // Oldest first, main thread jobs are usually ordered requests
+            job = m_mainThreadQueue.front();
+            m_mainThreadQueue.erase(m_mainThreadQueue.begin());
+        }
+
+        execute(job);
+        return true;
+    }
+} // LearnVulkanRAII
\ No newline at end of file
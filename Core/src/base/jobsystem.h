@@ -0,0 +1,119 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#ifndef LEARNVULKANRAII_JOBSYSTEM_H
+#define LEARNVULKANRAII_JOBSYSTEM_H
+
+#include "utils.h"
+#include "workstealingdeque.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace LearnVulkanRAII
+{
+    using JobFunction = std::function<void()>;
+    using ParallelForFunction = std::function<void(uint32_t begin, uint32_t end)>;
+
+    enum class JobAffinity
+    {
+        Any,
+        // Only run by runMainThreadJobs() (and wait() on the main thread), for GLFW and other main thread APIs
+        MainThread
+    };
+
+    class JobSystem;
+    struct Job;
+
+    // Counts the unfinished jobs scheduled with it. Jobs scheduled with it as their dependency start once it's zero.
+    // Can be reused once done, it must outlive its jobs
+    class JobCounter
+    {
+    public:
+        JobCounter() = default;
+        ~JobCounter();
+
+        [[nodiscard]] bool isDone() const;
+        [[nodiscard]] uint32_t getValue() const;
+
+    private:
+        std::atomic<uint32_t> m_value = 0;
+
+        std::mutex m_mutex;
+        std::vector<Job*> m_waitingJobs;
+
+        friend class JobSystem;
+    };
+
+    // Work stealing thread pool.
+    // Every worker owns a Chase-Lev deque: jobs scheduled by a worker go to its own deque, idle workers steal from
+    // the others. Jobs scheduled from other threads (the main thread) go through a shared injection queue.
+    // Waiting threads run jobs while they wait, nested parallel work doesn't block a worker
+    class JobSystem
+    {
+    public:
+        DEFINE_SMART_POINTER_HELPERS(JobSystem)
+
+    public:
+        // 0 workers: one per hardware thread, minus the main thread
+        explicit JobSystem(uint32_t workerCount = 0);
+        ~JobSystem();
+
+        // The counter (if any) counts the job until it finished, the dependency (if any) must be done before it starts
+        void schedule(const JobFunction& function,
+            JobCounter* counter = nullptr,
+            JobCounter* dependency = nullptr,
+            JobAffinity affinity = JobAffinity::Any);
+        // Runs jobs until the counter is done
+        void wait(const JobCounter& counter);
+
+        // Splits [0, count) into ranges of grainSize and waits for all of them, the calling thread takes part
+        void parallelFor(uint32_t count, uint32_t grainSize, const ParallelForFunction& function);
+
+        // Main thread only, called once per frame by the application
+        void runMainThreadJobs();
+
+        [[nodiscard]] uint32_t getWorkerCount() const;
+        [[nodiscard]] bool isMainThread() const;
+
+        static Shared create(uint32_t workerCount = 0);
+        // The scheduler the engine's systems share, created with its first user
+        static Shared getShared();
+
+    private:
+        void workerMain(uint32_t workerIndex);
+
+        void submit(Job* job);
+        [[nodiscard]] Job* findJob(uint32_t workerIndex);
+        void execute(Job* job);
+        void finish(JobCounter& counter);
+        bool runMainThreadJob();
+
+    private:
+        std::vector<Utils::Unique<WorkStealingDeque<Job>>> m_queues;
+        std::vector<std::thread> m_workers;
+        std::thread::id m_mainThreadId;
+
+        // Jobs from threads without a deque
+        std::mutex m_injectionMutex;
+        std::vector<Job*> m_injectionQueue;
+
+        std::mutex m_mainThreadMutex;
+        std::vector<Job*> m_mainThreadQueue;
+
+        // Queued jobs workers can run, idle workers sleep while it's zero
+        std::atomic<uint32_t> m_pendingJobCount = 0;
+        std::atomic<uint32_t> m_sleepingWorkerCount = 0;
+        std::mutex m_sleepMutex;
+        std::condition_variable m_wakeCondition;
+        std::atomic<bool> m_stopping = false;
+    };
+} // LearnVulkanRAII
+
+#endif //LEARNVULKANRAII_JOBSYSTEM_H
\ No newline at end of file
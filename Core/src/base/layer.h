@@ -25,6 +25,10 @@ namespace LearnVulkanRAII
 
         virtual void onUpdate(Timestep ts) {}
         virtual void onEvent(Event& e) {}
+
+        // Layers with something changing every frame (animation, benchmarks) say so, the application only wakes up
+        // for events (or the idle timeout) while no layer does
+        [[nodiscard]] virtual bool needsContinuousRedraw() const { return false; }
     };
 } // LearnVulkanRAII
 
@@ -54,6 +54,13 @@ namespace LearnVulkanRAII
         }
     }
 
+    bool LayerStack::needsContinuousRedraw() const
+    {
+        return std::any_of(m_layers.begin(), m_layers.end(), [](const Layer::Shared& layer) {
+            return layer->needsContinuousRedraw();
+        });
+    }
+
     void LayerStack::onUpdate(Timestep ts)
     {
         for (const auto& layer : m_layers)
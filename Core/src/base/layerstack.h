@@ -29,6 +29,8 @@ namespace LearnVulkanRAII
         void pushOverlay(const Layer::Shared& layer);
         void popOverlay(const Layer::Shared& layer);
 
+        [[nodiscard]] bool needsContinuousRedraw() const;
+
         // TODO: Need to implement the push/pop later
         // - pushLayerLater()
         // - popLayerLater()
@@ -37,6 +37,28 @@ namespace LearnVulkanRAII::Utils
     {
         return std::make_shared<T>(std::forward<Args>(args)...);
     }
+
+    // Folds the hash of value into seed, as boost::hash_combine does
+    template <typename T>
+    void hashCombine(size_t& seed, const T& value)
+    {
+        seed ^= std::hash<T>{}(value) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+    }
+
+    // FNV-1a over raw bytes, for trivially copyable data without padding
+    inline size_t hashBytes(const void* data, size_t size)
+    {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+
+        size_t hash = 0xcbf29ce484222325ull;
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ull;
+        }
+
+        return hash;
+    }
 }
 
 #define LOG(fmt, ...) std::println(fmt, ##__VA_ARGS__)
@@ -72,6 +72,16 @@ namespace LearnVulkanRAII
         return glfwWindowShouldClose(m_window);
     }
 
+    bool Window::isMinimized() const
+    {
+        return m_data.minimized || m_data.width == 0 || m_data.height == 0;
+    }
+
+    bool Window::needsContinuousRedraw() const
+    {
+        return m_layerStack.needsContinuousRedraw();
+    }
+
     const LayerStack& Window::getLayerStack() const
     {
         return m_layerStack;
@@ -89,6 +99,14 @@ namespace LearnVulkanRAII
 
     void Window::onUpdate()
     {
+        float time = glfwGetTime();
+        if (isMinimized())
+        {
+            // The time spent minimized isn't a frame
+            m_lastFrameTime = time;
+            return;
+        }
+
         glm::ivec2 currWinPos;
         glfwGetWindowPos(m_window, &currWinPos.x, &currWinPos.y);
         if (currWinPos != m_data.windowPos)
@@ -99,7 +117,6 @@ namespace LearnVulkanRAII
             onEvent(e);
         }
 
-        float time = glfwGetTime();
         Timestep timestep = time - m_lastFrameTime;
         m_lastFrameTime = time;
 
@@ -181,6 +198,7 @@ namespace LearnVulkanRAII
         glfwSetWindowIconifyCallback(m_window, [](GLFWwindow* window, int iconified)
         {
             auto* windowData = static_cast<WindowData*>(glfwGetWindowUserPointer(window));
+            windowData->minimized = iconified == GLFW_TRUE;
 
             if (iconified)
             {
@@ -218,19 +236,19 @@ namespace LearnVulkanRAII
             {
                 case GLFW_PRESS:
                 {
-                    KeyPressedEvent e(scancode, false);
+                    KeyPressedEvent e(key, false);
                     windowData->onEvent(e);
                     break;
                 }
                 case GLFW_RELEASE:
                 {
-                    KeyReleasedEvent e(scancode);
+                    KeyReleasedEvent e(key);
                     windowData->onEvent(e);
                     break;
                 }
                 case GLFW_REPEAT:
                 {
-                    KeyPressedEvent e(scancode, true);
+                    KeyPressedEvent e(key, true);
                     windowData->onEvent(e);
                     break;
                 }
@@ -46,6 +46,9 @@ namespace LearnVulkanRAII
 
         [[nodiscard]] GLFWwindow* getNativeWindow() const;
         [[nodiscard]] bool shouldClose() const;
+        // Iconified, or a zero sized framebuffer. Nothing is updated nor rendered until it's restored
+        [[nodiscard]] bool isMinimized() const;
+        [[nodiscard]] bool needsContinuousRedraw() const;
 
         [[nodiscard]] const LayerStack& getLayerStack() const;
         [[nodiscard]] LayerStack& getLayerStack();
@@ -66,6 +69,7 @@ namespace LearnVulkanRAII
             bool fullscreen;
             std::string title;
             glm::ivec2 windowPos;
+            bool minimized = false;
 
             EventCallbackType onEvent;
         };
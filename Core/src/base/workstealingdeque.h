@@ -0,0 +1,141 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#ifndef LEARNVULKANRAII_WORKSTEALINGDEQUE_H
+#define LEARNVULKANRAII_WORKSTEALINGDEQUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace LearnVulkanRAII
+{
+    // Chase-Lev deque of pointers, after "Correct and Efficient Work-Stealing for Weak Memory Models"
+    // (Lê, Pop, Cohen, Zappa Nardelli). The owner pushes and pops at the bottom (LIFO, cache warm), any thread steals
+    // from the top (FIFO). The ring starts at the given capacity (a power of two) and doubles when full
+    template <typename T>
+    class WorkStealingDeque
+    {
+    public:
+        explicit WorkStealingDeque(uint32_t capacity = 4096)
+        {
+            auto ring = std::make_unique<Ring>(capacity);
+            m_ring.store(ring.get(), std::memory_order_relaxed);
+            m_rings.push_back(std::move(ring));
+        }
+
+        // Owner only
+        void push(T* item)
+        {
+            const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+            const int64_t top = m_top.load(std::memory_order_acquire);
+            Ring* ring = m_ring.load(std::memory_order_relaxed);
+            if (bottom - top >= ring->capacity)
+                ring = grow(ring, top, bottom);
+
+            ring->store(bottom, item);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        // Owner only
+        T* pop()
+        {
+            const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+            Ring* ring = m_ring.load(std::memory_order_relaxed);
+            m_bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top = m_top.load(std::memory_order_relaxed);
+
+            if (top > bottom)
+            {
+                // Empty
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            T* item = ring->load(bottom);
+            if (top == bottom)
+            {
+                // Last item, race the thieves for it
+                if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    item = nullptr;
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+
+            return item;
+        }
+
+        // Any thread. Returns nullptr when empty or when another thread won the item
+        T* steal()
+        {
+            int64_t top = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+            if (top >= bottom)
+                return nullptr;
+
+            T* item = m_ring.load(std::memory_order_acquire)->load(top);
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return nullptr;
+
+            return item;
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return m_top.load(std::memory_order_relaxed) >= m_bottom.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] int64_t getCapacity() const
+        {
+            return m_ring.load(std::memory_order_relaxed)->capacity;
+        }
+
+    private:
+        struct Ring
+        {
+            explicit Ring(int64_t capacity)
+                : capacity(capacity),
+                mask(capacity - 1),
+                items(std::make_unique<std::atomic<T*>[]>(capacity))
+            {
+            }
+
+            T* load(int64_t index) const { return items[index & mask].load(std::memory_order_relaxed); }
+            void store(int64_t index, T* item) { items[index & mask].store(item, std::memory_order_relaxed); }
+
+            const int64_t capacity;
+            const int64_t mask;
+            std::unique_ptr<std::atomic<T*>[]> items;
+        };
+
+        // Owner only. Thieves may still read the previous ring, it's kept until the deque goes
+        Ring* grow(Ring* ring, int64_t top, int64_t bottom)
+        {
+            auto grown = std::make_unique<Ring>(ring->capacity * 2);
+            for (int64_t i = top; i < bottom; i++)
+            {
+                grown->store(i, ring->load(i));
+            }
+
+            Ring* result = grown.get();
+            m_ring.store(result, std::memory_order_release);
+            m_rings.push_back(std::move(grown));
+            return result;
+        }
+
+    private:
+        std::atomic<Ring*> m_ring = nullptr;
+        // Every ring the deque had, owner only
+        std::vector<std::unique_ptr<Ring>> m_rings;
+
+        // Apart, the owner and the thieves write different cache lines
+        alignas(64) std::atomic<int64_t> m_top = 0;
+        alignas(64) std::atomic<int64_t> m_bottom = 0;
+    };
+} // LearnVulkanRAII
+
+#endif //LEARNVULKANRAII_WORKSTEALINGDEQUE_H
\ No newline at end of file
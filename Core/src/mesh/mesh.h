@@ -9,23 +9,40 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtx/quaternion.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 namespace LearnVulkanRAII
 {
     struct Transform
     {
         glm::vec3 translate = glm::vec3(0.0f);
-        glm::vec3 rotate = glm::vec3(0.0f);
+        glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
         glm::vec3 scale = glm::vec3(1.0f);
 
-        glm::mat4 toMat4() const
+        // Euler angles (in radians) helpers, the rotation itself is kept as a quaternion
+        void setRotation(const glm::vec3& eulerAngles) { rotation = glm::quat(eulerAngles); }
+        [[nodiscard]] glm::vec3 getRotation() const { return glm::eulerAngles(rotation); }
+
+        // Top three rows of the model matrix, stored one row per column (the last row is always 0, 0, 0, 1)
+        [[nodiscard]] glm::mat3x4 toAffine3x4() const
         {
-            auto t = glm::translate(glm::mat4(1.0f), translate);
-            auto r = glm::toMat4(glm::quat(rotate));
-            auto s = glm::scale(glm::mat4(1.0f), scale);
+            const glm::mat3 r = glm::mat3_cast(rotation);
 
-            return t * r * s;
+            return glm::mat3x4(
+                glm::vec4(r[0][0] * scale.x, r[1][0] * scale.y, r[2][0] * scale.z, translate.x),
+                glm::vec4(r[0][1] * scale.x, r[1][1] * scale.y, r[2][1] * scale.z, translate.y),
+                glm::vec4(r[0][2] * scale.x, r[1][2] * scale.y, r[2][2] * scale.z, translate.z));
+        }
+
+        [[nodiscard]] glm::mat4 toMat4() const
+        {
+            const glm::mat3 r = glm::mat3_cast(rotation);
+
+            return glm::mat4(
+                glm::vec4(r[0] * scale.x, 0.0f),
+                glm::vec4(r[1] * scale.y, 0.0f),
+                glm::vec4(r[2] * scale.z, 0.0f),
+                glm::vec4(translate, 1.0f));
         }
     };
 
@@ -34,6 +51,42 @@ namespace LearnVulkanRAII
         glm::vec3 position;
     };
 
+    struct BoundingBox
+    {
+        glm::vec3 min = glm::vec3(0.0f);
+        glm::vec3 max = glm::vec3(0.0f);
+
+        [[nodiscard]] glm::vec3 getCenter() const { return (min + max) * 0.5f; }
+        [[nodiscard]] glm::vec3 getExtents() const { return (max - min) * 0.5f; }
+    };
+
+    struct BoundingSphere
+    {
+        glm::vec3 center = glm::vec3(0.0f);
+        float radius = 0.0f;
+
+        // Conservative world space bounds, the radius grows with the largest scale axis
+        [[nodiscard]] BoundingSphere transformed(const Transform& transform) const
+        {
+            const glm::vec3 absScale = glm::abs(transform.scale);
+            return BoundingSphere{
+                transform.translate + transform.rotation * (transform.scale * center),
+                radius * glm::max(absScale.x, glm::max(absScale.y, absScale.z))
+            };
+        }
+
+        [[nodiscard]] BoundingSphere transformed(const glm::mat3x4& affine) const
+        {
+            const float scaleX = glm::length(glm::vec3(affine[0][0], affine[1][0], affine[2][0]));
+            const float scaleY = glm::length(glm::vec3(affine[0][1], affine[1][1], affine[2][1]));
+            const float scaleZ = glm::length(glm::vec3(affine[0][2], affine[1][2], affine[2][2]));
+            return BoundingSphere{
+                glm::vec4(center, 1.0f) * affine,
+                radius * glm::max(scaleX, glm::max(scaleY, scaleZ))
+            };
+        }
+    };
+
     struct Mesh
     {
         std::vector<Vertex> vertices;
@@ -47,14 +100,53 @@ namespace LearnVulkanRAII
 
         size_t getFaceCount() const { return indices.size() / 3; }
 
+        // Bounds are cached, call updateBounds() after editing the vertices directly.
+        // The getters only read: recorder jobs on other threads cull against the same mesh
+        const BoundingBox& getBoundingBox() const { return m_boundingBox; }
+        const BoundingSphere& getBoundingSphere() const { return m_boundingSphere; }
+
+        void updateBounds()
+        {
+            BoundingBox box{};
+            BoundingSphere sphere{};
+            if (!vertices.empty())
+            {
+                box.min = box.max = vertices.front().position;
+                for (const auto& v : vertices)
+                {
+                    box.min = glm::min(box.min, v.position);
+                    box.max = glm::max(box.max, v.position);
+                }
+
+                // Centered on the box, the radius reaches the farthest vertex (tighter than the box corner)
+                sphere.center = box.getCenter();
+                float radiusSquared = 0.0f;
+                for (const auto& v : vertices)
+                {
+                    const glm::vec3 d = v.position - sphere.center;
+                    radiusSquared = glm::max(radiusSquared, glm::dot(d, d));
+                }
+                sphere.radius = glm::sqrt(radiusSquared);
+            }
+
+            m_boundingBox = box;
+            m_boundingSphere = sphere;
+        }
+
         void applyTransform(const Transform& transform)
         {
-            const auto model = transform.toMat4();
+            const auto model = transform.toAffine3x4();
             for (auto& v : vertices)
             {
-                v.position = model * glm::vec4(v.position, 1.0f);
+                v.position = glm::vec4(v.position, 1.0f) * model;
             }
+
+            updateBounds();
         }
+
+    private:
+        BoundingBox m_boundingBox;
+        BoundingSphere m_boundingSphere;
     };
 }
 
@@ -0,0 +1,449 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#include "transformarray.h"
+
+#include "base/utils.h"
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define LEARNVULKANRAII_TRANSFORM_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define LEARNVULKANRAII_TARGET_AVX2
+    #else
+        #define LEARNVULKANRAII_TARGET_AVX2 __attribute__((target("avx2,fma")))
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define LEARNVULKANRAII_TRANSFORM_NEON 1
+    #include <arm_neon.h>
+#endif
+
+namespace LearnVulkanRAII
+{
+    void TransformArray::push(const Transform& transform)
+    {
+        translateX.push_back(transform.translate.x);
+        translateY.push_back(transform.translate.y);
+        translateZ.push_back(transform.translate.z);
+        rotationX.push_back(transform.rotation.x);
+        rotationY.push_back(transform.rotation.y);
+        rotationZ.push_back(transform.rotation.z);
+        rotationW.push_back(transform.rotation.w);
+        scaleX.push_back(transform.scale.x);
+        scaleY.push_back(transform.scale.y);
+        scaleZ.push_back(transform.scale.z);
+    }
+
+    void TransformArray::set(size_t index, const Transform& transform)
+    {
+        translateX[index] = transform.translate.x;
+        translateY[index] = transform.translate.y;
+        translateZ[index] = transform.translate.z;
+        rotationX[index] = transform.rotation.x;
+        rotationY[index] = transform.rotation.y;
+        rotationZ[index] = transform.rotation.z;
+        rotationW[index] = transform.rotation.w;
+        scaleX[index] = transform.scale.x;
+        scaleY[index] = transform.scale.y;
+        scaleZ[index] = transform.scale.z;
+    }
+
+    Transform TransformArray::get(size_t index) const
+    {
+        Transform transform;
+        transform.translate = { translateX[index], translateY[index], translateZ[index] };
+        transform.rotation = glm::quat(rotationW[index], rotationX[index], rotationY[index], rotationZ[index]);
+        transform.scale = { scaleX[index], scaleY[index], scaleZ[index] };
+        return transform;
+    }
+
+    void TransformArray::reserve(size_t count)
+    {
+        for (auto* component : { &translateX, &translateY, &translateZ,
+                                  &rotationX, &rotationY, &rotationZ, &rotationW,
+                                  &scaleX, &scaleY, &scaleZ })
+        {
+            component->reserve(count);
+        }
+    }
+
+    void TransformArray::resize(size_t count)
+    {
+        translateX.resize(count, 0.0f);
+        translateY.resize(count, 0.0f);
+        translateZ.resize(count, 0.0f);
+        rotationX.resize(count, 0.0f);
+        rotationY.resize(count, 0.0f);
+        rotationZ.resize(count, 0.0f);
+        rotationW.resize(count, 1.0f);
+        scaleX.resize(count, 1.0f);
+        scaleY.resize(count, 1.0f);
+        scaleZ.resize(count, 1.0f);
+    }
+
+    void TransformArray::clear()
+    {
+        for (auto* component : { &translateX, &translateY, &translateZ,
+                                  &rotationX, &rotationY, &rotationZ, &rotationW,
+                                  &scaleX, &scaleY, &scaleZ })
+        {
+            component->clear();
+        }
+    }
+
+    void TransformArray::toAffine3x4(size_t first, size_t count, glm::mat3x4* out) const
+    {
+        TransformKernels::toAffine3x4(*this, first, count, out);
+    }
+
+    namespace
+    {
+        // Component pointers already offset to the first transform to convert
+        struct TransformStreams
+        {
+            const float* tx; const float* ty; const float* tz;
+            const float* qx; const float* qy; const float* qz; const float* qw;
+            const float* sx; const float* sy; const float* sz;
+
+            TransformStreams(const TransformArray& transforms, size_t first)
+                : tx(transforms.translateX.data() + first),
+                ty(transforms.translateY.data() + first),
+                tz(transforms.translateZ.data() + first),
+                qx(transforms.rotationX.data() + first),
+                qy(transforms.rotationY.data() + first),
+                qz(transforms.rotationZ.data() + first),
+                qw(transforms.rotationW.data() + first),
+                sx(transforms.scaleX.data() + first),
+                sy(transforms.scaleY.data() + first),
+                sz(transforms.scaleZ.data() + first)
+            {
+            }
+        };
+
+        // Each output matrix is 12 floats: row 0, row 1 and row 2 of the affine model matrix
+        constexpr size_t FloatsPerMatrix = 12;
+
+        void convertScalar(const TransformStreams& s, size_t begin, size_t count, float* out)
+        {
+            for (size_t i = begin; i < count; i++)
+            {
+                const float x = s.qx[i], y = s.qy[i], z = s.qz[i], w = s.qw[i];
+                const float xx = x * x, yy = y * y, zz = z * z;
+                const float xy = x * y, xz = x * z, yz = y * z;
+                const float wx = w * x, wy = w * y, wz = w * z;
+
+                float* m = out + i * FloatsPerMatrix;
+
+                m[0]  = (1.0f - 2.0f * (yy + zz)) * s.sx[i];
+                m[1]  = 2.0f * (xy - wz) * s.sy[i];
+                m[2]  = 2.0f * (xz + wy) * s.sz[i];
+                m[3]  = s.tx[i];
+
+                m[4]  = 2.0f * (xy + wz) * s.sx[i];
+                m[5]  = (1.0f - 2.0f * (xx + zz)) * s.sy[i];
+                m[6]  = 2.0f * (yz - wx) * s.sz[i];
+                m[7]  = s.ty[i];
+
+                m[8]  = 2.0f * (xz - wy) * s.sx[i];
+                m[9]  = 2.0f * (yz + wx) * s.sy[i];
+                m[10] = (1.0f - 2.0f * (xx + yy)) * s.sz[i];
+                m[11] = s.tz[i];
+            }
+        }
+
+#if defined(LEARNVULKANRAII_TRANSFORM_X86)
+        // Transposes one row of four matrices from component-major to matrix-major and stores it
+        inline void storeRowSSE(__m128 cx, __m128 cy, __m128 cz, __m128 cw, float* out, size_t row)
+        {
+            _MM_TRANSPOSE4_PS(cx, cy, cz, cw);
+            _mm_storeu_ps(out + 0 * FloatsPerMatrix + row * 4, cx);
+            _mm_storeu_ps(out + 1 * FloatsPerMatrix + row * 4, cy);
+            _mm_storeu_ps(out + 2 * FloatsPerMatrix + row * 4, cz);
+            _mm_storeu_ps(out + 3 * FloatsPerMatrix + row * 4, cw);
+        }
+
+        void convertSSE(const TransformStreams& s, size_t count, float* out)
+        {
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 two = _mm_set1_ps(2.0f);
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 x = _mm_loadu_ps(s.qx + i), y = _mm_loadu_ps(s.qy + i);
+                const __m128 z = _mm_loadu_ps(s.qz + i), w = _mm_loadu_ps(s.qw + i);
+                const __m128 sx = _mm_loadu_ps(s.sx + i), sy = _mm_loadu_ps(s.sy + i), sz = _mm_loadu_ps(s.sz + i);
+
+                const __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+                const __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+                const __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+                float* m = out + i * FloatsPerMatrix;
+
+                storeRowSSE(
+                    _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx),
+                    _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy),
+                    _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz),
+                    _mm_loadu_ps(s.tx + i),
+                    m, 0);
+
+                storeRowSSE(
+                    _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx),
+                    _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy),
+                    _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz),
+                    _mm_loadu_ps(s.ty + i),
+                    m, 1);
+
+                storeRowSSE(
+                    _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx),
+                    _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy),
+                    _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz),
+                    _mm_loadu_ps(s.tz + i),
+                    m, 2);
+            }
+
+            convertScalar(s, i, count, out);
+        }
+
+        LEARNVULKANRAII_TARGET_AVX2
+        inline void storeRowAVX2(__m256 cx, __m256 cy, __m256 cz, __m256 cw, float* out, size_t row)
+        {
+            // Two 4x4 transposes, one per 128 bit lane
+            __m128 lx = _mm256_castps256_ps128(cx), ly = _mm256_castps256_ps128(cy);
+            __m128 lz = _mm256_castps256_ps128(cz), lw = _mm256_castps256_ps128(cw);
+            __m128 hx = _mm256_extractf128_ps(cx, 1), hy = _mm256_extractf128_ps(cy, 1);
+            __m128 hz = _mm256_extractf128_ps(cz, 1), hw = _mm256_extractf128_ps(cw, 1);
+
+            _MM_TRANSPOSE4_PS(lx, ly, lz, lw);
+            _MM_TRANSPOSE4_PS(hx, hy, hz, hw);
+
+            _mm_storeu_ps(out + 0 * FloatsPerMatrix + row * 4, lx);
+            _mm_storeu_ps(out + 1 * FloatsPerMatrix + row * 4, ly);
+            _mm_storeu_ps(out + 2 * FloatsPerMatrix + row * 4, lz);
+            _mm_storeu_ps(out + 3 * FloatsPerMatrix + row * 4, lw);
+            _mm_storeu_ps(out + 4 * FloatsPerMatrix + row * 4, hx);
+            _mm_storeu_ps(out + 5 * FloatsPerMatrix + row * 4, hy);
+            _mm_storeu_ps(out + 6 * FloatsPerMatrix + row * 4, hz);
+            _mm_storeu_ps(out + 7 * FloatsPerMatrix + row * 4, hw);
+        }
+
+        LEARNVULKANRAII_TARGET_AVX2
+        void convertAVX2(const TransformStreams& s, size_t count, float* out)
+        {
+            const __m256 one = _mm256_set1_ps(1.0f);
+            const __m256 minusTwo = _mm256_set1_ps(-2.0f);
+            const __m256 two = _mm256_set1_ps(2.0f);
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256 x = _mm256_loadu_ps(s.qx + i), y = _mm256_loadu_ps(s.qy + i);
+                const __m256 z = _mm256_loadu_ps(s.qz + i), w = _mm256_loadu_ps(s.qw + i);
+                const __m256 sx = _mm256_loadu_ps(s.sx + i), sy = _mm256_loadu_ps(s.sy + i), sz = _mm256_loadu_ps(s.sz + i);
+
+                const __m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+                const __m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+                const __m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+
+                float* m = out + i * FloatsPerMatrix;
+
+                storeRowAVX2(
+                    _mm256_mul_ps(_mm256_fmadd_ps(minusTwo, _mm256_add_ps(yy, zz), one), sx),
+                    _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy),
+                    _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz),
+                    _mm256_loadu_ps(s.tx + i),
+                    m, 0);
+
+                storeRowAVX2(
+                    _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx),
+                    _mm256_mul_ps(_mm256_fmadd_ps(minusTwo, _mm256_add_ps(xx, zz), one), sy),
+                    _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz),
+                    _mm256_loadu_ps(s.ty + i),
+                    m, 1);
+
+                storeRowAVX2(
+                    _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx),
+                    _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy),
+                    _mm256_mul_ps(_mm256_fmadd_ps(minusTwo, _mm256_add_ps(xx, yy), one), sz),
+                    _mm256_loadu_ps(s.tz + i),
+                    m, 2);
+            }
+
+            convertScalar(s, i, count, out);
+        }
+
+        bool cpuSupportsAVX2()
+        {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7)
+                return false;
+
+            __cpuid(info, 1);
+            const bool hasFMA = (info[2] & (1 << 12)) != 0;
+            const bool hasOSXSave = (info[2] & (1 << 27)) != 0;
+            if (!hasFMA || !hasOSXSave)
+                return false;
+
+            // The OS has to save the YMM registers on context switches
+            if ((_xgetbv(0) & 0x6) != 0x6)
+                return false;
+
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+        }
+#endif
+
+#if defined(LEARNVULKANRAII_TRANSFORM_NEON)
+        inline void storeRowNEON(float32x4_t cx, float32x4_t cy, float32x4_t cz, float32x4_t cw, float* out, size_t row)
+        {
+            const float32x4x2_t xy = vtrnq_f32(cx, cy);
+            const float32x4x2_t zw = vtrnq_f32(cz, cw);
+
+            vst1q_f32(out + 0 * FloatsPerMatrix + row * 4, vcombine_f32(vget_low_f32(xy.val[0]), vget_low_f32(zw.val[0])));
+            vst1q_f32(out + 1 * FloatsPerMatrix + row * 4, vcombine_f32(vget_low_f32(xy.val[1]), vget_low_f32(zw.val[1])));
+            vst1q_f32(out + 2 * FloatsPerMatrix + row * 4, vcombine_f32(vget_high_f32(xy.val[0]), vget_high_f32(zw.val[0])));
+            vst1q_f32(out + 3 * FloatsPerMatrix + row * 4, vcombine_f32(vget_high_f32(xy.val[1]), vget_high_f32(zw.val[1])));
+        }
+
+        void convertNEON(const TransformStreams& s, size_t count, float* out)
+        {
+            const float32x4_t one = vdupq_n_f32(1.0f);
+            const float32x4_t two = vdupq_n_f32(2.0f);
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const float32x4_t x = vld1q_f32(s.qx + i), y = vld1q_f32(s.qy + i);
+                const float32x4_t z = vld1q_f32(s.qz + i), w = vld1q_f32(s.qw + i);
+                const float32x4_t sx = vld1q_f32(s.sx + i), sy = vld1q_f32(s.sy + i), sz = vld1q_f32(s.sz + i);
+
+                const float32x4_t xx = vmulq_f32(x, x), yy = vmulq_f32(y, y), zz = vmulq_f32(z, z);
+                const float32x4_t xy = vmulq_f32(x, y), xz = vmulq_f32(x, z), yz = vmulq_f32(y, z);
+                const float32x4_t wx = vmulq_f32(w, x), wy = vmulq_f32(w, y), wz = vmulq_f32(w, z);
+
+                float* m = out + i * FloatsPerMatrix;
+
+                storeRowNEON(
+                    vmulq_f32(vmlsq_f32(one, two, vaddq_f32(yy, zz)), sx),
+                    vmulq_f32(vmulq_f32(two, vsubq_f32(xy, wz)), sy),
+                    vmulq_f32(vmulq_f32(two, vaddq_f32(xz, wy)), sz),
+                    vld1q_f32(s.tx + i),
+                    m, 0);
+
+                storeRowNEON(
+                    vmulq_f32(vmulq_f32(two, vaddq_f32(xy, wz)), sx),
+                    vmulq_f32(vmlsq_f32(one, two, vaddq_f32(xx, zz)), sy),
+                    vmulq_f32(vmulq_f32(two, vsubq_f32(yz, wx)), sz),
+                    vld1q_f32(s.ty + i),
+                    m, 1);
+
+                storeRowNEON(
+                    vmulq_f32(vmulq_f32(two, vsubq_f32(xz, wy)), sx),
+                    vmulq_f32(vmulq_f32(two, vaddq_f32(yz, wx)), sy),
+                    vmulq_f32(vmlsq_f32(one, two, vaddq_f32(xx, yy)), sz),
+                    vld1q_f32(s.tz + i),
+                    m, 2);
+            }
+
+            convertScalar(s, i, count, out);
+        }
+#endif
+
+        TransformKernelType selectBestKernel()
+        {
+#if defined(LEARNVULKANRAII_TRANSFORM_X86)
+            if (cpuSupportsAVX2())
+                return TransformKernelType::AVX2;
+            return TransformKernelType::SSE; // SSE2 is part of the x86-64 baseline
+#elif defined(LEARNVULKANRAII_TRANSFORM_NEON)
+            return TransformKernelType::NEON;
+#else
+            return TransformKernelType::Scalar;
+#endif
+        }
+
+        // Read by the worker threads converting transforms, may be switched from the main thread meanwhile
+        std::atomic<TransformKernelType> s_activeKernel = selectBestKernel();
+    }
+
+    namespace TransformKernels
+    {
+        TransformKernelType getActiveKernel()
+        {
+            return s_activeKernel.load(std::memory_order_relaxed);
+        }
+
+        void setActiveKernel(TransformKernelType kernelType)
+        {
+            ASSERT(isKernelSupported(kernelType), "Transform kernel is not supported on this CPU!");
+            s_activeKernel.store(isKernelSupported(kernelType) ? kernelType : TransformKernelType::Scalar, std::memory_order_relaxed);
+        }
+
+        bool isKernelSupported(TransformKernelType kernelType)
+        {
+            switch (kernelType)
+            {
+                case TransformKernelType::Scalar: return true;
+#if defined(LEARNVULKANRAII_TRANSFORM_X86)
+                case TransformKernelType::SSE: return true;
+                case TransformKernelType::AVX2: return cpuSupportsAVX2();
+#elif defined(LEARNVULKANRAII_TRANSFORM_NEON)
+                case TransformKernelType::NEON: return true;
+#endif
+                default: return false;
+            }
+        }
+
+        const char* getKernelName(TransformKernelType kernelType)
+        {
+            switch (kernelType)
+            {
+                case TransformKernelType::Scalar: return "Scalar";
+                case TransformKernelType::SSE: return "SSE";
+                case TransformKernelType::AVX2: return "AVX2";
+                case TransformKernelType::NEON: return "NEON";
+            }
+
+            return "Unknown";
+        }
+
+        void toAffine3x4(const TransformArray& transforms, size_t first, size_t count, glm::mat3x4* out)
+        {
+            ASSERT(first + count <= transforms.size(), "Transform range out of bounds!");
+            if (count == 0)
+                return;
+
+            const TransformStreams streams(transforms, first);
+            float* outFloats = &out[0][0][0];
+
+            switch (s_activeKernel.load(std::memory_order_relaxed))
+            {
+#if defined(LEARNVULKANRAII_TRANSFORM_X86)
+                case TransformKernelType::SSE: convertSSE(streams, count, outFloats); return;
+                case TransformKernelType::AVX2: convertAVX2(streams, count, outFloats); return;
+#elif defined(LEARNVULKANRAII_TRANSFORM_NEON)
+                case TransformKernelType::NEON: convertNEON(streams, count, outFloats); return;
+#endif
+                default: convertScalar(streams, 0, count, outFloats); return;
+            }
+        }
+
+        void toAffine3x4Scalar(const TransformArray& transforms, size_t first, size_t count, glm::mat3x4* out)
+        {
+            ASSERT(first + count <= transforms.size(), "Transform range out of bounds!");
+            if (count == 0)
+                return;
+
+            convertScalar(TransformStreams(transforms, first), 0, count, &out[0][0][0]);
+        }
+    }
+} // LearnVulkanRAII
\ No newline at end of file
@@ -0,0 +1,68 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#ifndef LEARNVULKANRAII_TRANSFORMARRAY_H
+#define LEARNVULKANRAII_TRANSFORMARRAY_H
+
+#include "mesh.h"
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace LearnVulkanRAII
+{
+    // Transforms stored as separate component arrays so that the conversion kernels
+    // can load the same component of several transforms with a single vector load
+    class TransformArray
+    {
+    public:
+        std::vector<float> translateX, translateY, translateZ;
+        std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+        std::vector<float> scaleX, scaleY, scaleZ;
+
+    public:
+        TransformArray() = default;
+
+        void push(const Transform& transform);
+        void set(size_t index, const Transform& transform);
+        [[nodiscard]] Transform get(size_t index) const;
+
+        void reserve(size_t count);
+        void resize(size_t count);
+        void clear();
+
+        [[nodiscard]] size_t size() const { return translateX.size(); }
+        [[nodiscard]] bool empty() const { return translateX.empty(); }
+
+        // Writes the affine rows (see Transform::toAffine3x4) of 'count' transforms starting at 'first'
+        void toAffine3x4(size_t first, size_t count, glm::mat3x4* out) const;
+        void toAffine3x4(glm::mat3x4* out) const { toAffine3x4(0, size(), out); }
+    };
+
+    enum class TransformKernelType
+    {
+        Scalar = 0,
+        SSE,
+        AVX2,
+        NEON
+    };
+
+    namespace TransformKernels
+    {
+        // Kernel picked from the CPU features at startup
+        [[nodiscard]] TransformKernelType getActiveKernel();
+        // Overrides the kernel, falls back to the scalar one if the CPU can't run the requested kernel
+        void setActiveKernel(TransformKernelType kernelType);
+        [[nodiscard]] bool isKernelSupported(TransformKernelType kernelType);
+        [[nodiscard]] const char* getKernelName(TransformKernelType kernelType);
+
+        void toAffine3x4(const TransformArray& transforms, size_t first, size_t count, glm::mat3x4* out);
+
+        // Reference implementation the vectorized kernels must match
+        void toAffine3x4Scalar(const TransformArray& transforms, size_t first, size_t count, glm::mat3x4* out);
+    }
+} // LearnVulkanRAII
+
+#endif //LEARNVULKANRAII_TRANSFORMARRAY_H
\ No newline at end of file
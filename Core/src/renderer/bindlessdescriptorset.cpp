@@ -0,0 +1,186 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#include "bindlessdescriptorset.h"
+
+#include <algorithm>
+
+namespace LearnVulkanRAII
+{
+    BindlessDescriptorSet::BindlessDescriptorSet(const GraphicsContext::Shared& graphicsContext,
+        uint32_t maxStorageBuffers)
+        : m_graphicsContext(graphicsContext),
+        m_storageBufferCapacity(maxStorageBuffers)
+    {
+        init();
+    }
+
+    uint32_t BindlessDescriptorSet::registerStorageBuffer(const Buffer::Shared& buffer)
+    {
+        ASSERT(!m_freeStorageBufferIndices.empty(), "Bindless storage buffer slots exhausted!");
+        if (m_freeStorageBufferIndices.empty())
+            return InvalidIndex;
+
+        uint32_t index = m_freeStorageBufferIndices.back();
+        m_freeStorageBufferIndices.pop_back();
+
+        updateStorageBuffer(index, buffer);
+        return index;
+    }
+
+    void BindlessDescriptorSet::updateStorageBuffer(uint32_t index, const Buffer::Shared& buffer)
+    {
+        ASSERT(index < m_storageBufferCapacity, "Invalid bindless storage buffer index!");
+
+        m_storageBuffers[index] = buffer;
+        writeStorageBuffer(index, buffer);
+    }
+
+    void BindlessDescriptorSet::releaseStorageBuffer(uint32_t index)
+    {
+        if (index == InvalidIndex)
+            return;
+
+        ASSERT(index < m_storageBufferCapacity, "Invalid bindless storage buffer index!");
+
+        // The descriptor itself is left stale, the binding is partially bound so unused slots are never read
+        m_storageBuffers[index].reset();
+        m_freeStorageBufferIndices.push_back(index);
+    }
+
+    uint32_t BindlessDescriptorSet::getStorageBufferCapacity() const
+    {
+        return m_storageBufferCapacity;
+    }
+
+    const vk::raii::DescriptorSetLayout& BindlessDescriptorSet::getLayout() const
+    {
+        return *m_descriptorSetLayout;
+    }
+
+    const vk::raii::DescriptorSet& BindlessDescriptorSet::getDescriptorSet() const
+    {
+        return *m_descriptorSet;
+    }
+
+    BindlessDescriptorSet::Shared BindlessDescriptorSet::create(const GraphicsContext::Shared& graphicsContext,
+        uint32_t maxStorageBuffers)
+    {
+        return makeShared(graphicsContext, maxStorageBuffers);
+    }
+
+    void BindlessDescriptorSet::init()
+    {
+        auto& physicalDevice = m_graphicsContext->getPhysicalDevice();
+        auto properties = physicalDevice.getProperties2<vk::PhysicalDeviceProperties2,
+            vk::PhysicalDeviceVulkan12Properties>();
+        const auto& vulkan12Properties = properties.get<vk::PhysicalDeviceVulkan12Properties>();
+
+        m_storageBufferCapacity = std::min({
+            m_storageBufferCapacity,
+            vulkan12Properties.maxDescriptorSetUpdateAfterBindStorageBuffers,
+            vulkan12Properties.maxPerStageDescriptorUpdateAfterBindStorageBuffers
+        });
+
+        m_storageBuffers.resize(m_storageBufferCapacity);
+        m_freeStorageBufferIndices.reserve(m_storageBufferCapacity);
+        for (uint32_t i = m_storageBufferCapacity; i > 0; i--)
+        {
+            m_freeStorageBufferIndices.push_back(i - 1);
+        }
+
+        createDescriptorSetLayout();
+        createDescriptorPool();
+        allocateDescriptorSet();
+    }
+
+    void BindlessDescriptorSet::createDescriptorSetLayout()
+    {
+        auto& device = m_graphicsContext->getDevice();
+
+        vk::DescriptorSetLayoutBinding storageBufferBinding{
+            StorageBufferBinding,
+            vk::DescriptorType::eStorageBuffer,
+            m_storageBufferCapacity,
+            vk::ShaderStageFlagBits::eAll,
+        };
+
+        // Slots no pending command buffer uses can be written while other frames are in flight
+        vk::DescriptorBindingFlags bindingFlags =
+            vk::DescriptorBindingFlagBits::ePartiallyBound |
+            vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+            vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending;
+
+        vk::DescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCreateInfo{};
+        bindingFlagsCreateInfo.setBindingFlags(bindingFlags);
+
+        vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo{
+            vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool,
+            1,
+            &storageBufferBinding
+        };
+        descriptorSetLayoutCreateInfo.pNext = &bindingFlagsCreateInfo;
+
+        m_descriptorSetLayout = device.createDescriptorSetLayout(descriptorSetLayoutCreateInfo);
+    }
+
+    void BindlessDescriptorSet::createDescriptorPool()
+    {
+        auto& device = m_graphicsContext->getDevice();
+
+        vk::DescriptorPoolSize storageBufferPoolSize{
+            vk::DescriptorType::eStorageBuffer,
+            m_storageBufferCapacity
+        };
+
+        vk::DescriptorPoolCreateInfo descriptorPoolCreateInfo{
+            vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind | vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
+            1,
+            1,
+            &storageBufferPoolSize
+        };
+
+        m_descriptorPool = device.createDescriptorPool(descriptorPoolCreateInfo);
+    }
+
+    void BindlessDescriptorSet::allocateDescriptorSet()
+    {
+        auto& device = m_graphicsContext->getDevice();
+
+        vk::DescriptorSetLayout descriptorSetLayout = **m_descriptorSetLayout;
+        vk::DescriptorSetAllocateInfo descriptorSetAllocateInfo{
+            **m_descriptorPool,
+            1,
+            &descriptorSetLayout
+        };
+
+        auto descriptorSets = device.allocateDescriptorSets(descriptorSetAllocateInfo);
+        ASSERT(descriptorSets.size(), "Failed to allocate bindless descriptor set!");
+
+        m_descriptorSet = std::move(descriptorSets.front());
+    }
+
+    void BindlessDescriptorSet::writeStorageBuffer(uint32_t index, const Buffer::Shared& buffer) const
+    {
+        auto& device = m_graphicsContext->getDevice();
+
+        vk::DescriptorBufferInfo bufferInfo{
+            *buffer->getNativeBuffer(),
+            0,
+            buffer->getSize()
+        };
+
+        vk::WriteDescriptorSet writeDescriptorSet{
+            **m_descriptorSet,
+            StorageBufferBinding,
+            index,
+            1,
+            vk::DescriptorType::eStorageBuffer,
+            nullptr,
+            &bufferInfo
+        };
+
+        device.updateDescriptorSets(writeDescriptorSet, nullptr);
+    }
+} // LearnVulkanRAII
\ No newline at end of file
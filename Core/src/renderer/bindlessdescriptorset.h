@@ -0,0 +1,67 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#ifndef LEARNVULKANRAII_BINDLESSDESCRIPTORSET_H
+#define LEARNVULKANRAII_BINDLESSDESCRIPTORSET_H
+
+#include "base/utils.h"
+#include "base/graphicscontext.h"
+
+#include "buffer.h"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <vector>
+
+namespace LearnVulkanRAII
+{
+    // A single update-after-bind descriptor set holding a large array of storage buffers.
+    // Buffers are registered once and addressed from the shaders by their slot index,
+    // so the set is bound once per command buffer instead of once per batch.
+    class BindlessDescriptorSet
+    {
+    public:
+        DEFINE_SMART_POINTER_HELPERS(BindlessDescriptorSet)
+
+        static constexpr uint32_t InvalidIndex = UINT32_MAX;
+        static constexpr uint32_t StorageBufferBinding = 0;
+
+    public:
+        BindlessDescriptorSet(const GraphicsContext::Shared& graphicsContext, uint32_t maxStorageBuffers);
+
+        uint32_t registerStorageBuffer(const Buffer::Shared& buffer);
+        void updateStorageBuffer(uint32_t index, const Buffer::Shared& buffer);
+        void releaseStorageBuffer(uint32_t index);
+
+        [[nodiscard]] uint32_t getStorageBufferCapacity() const;
+
+        [[nodiscard]] const vk::raii::DescriptorSetLayout& getLayout() const;
+        [[nodiscard]] const vk::raii::DescriptorSet& getDescriptorSet() const;
+
+        static Shared create(const GraphicsContext::Shared& graphicsContext, uint32_t maxStorageBuffers = 1024);
+
+    private:
+        void init();
+
+        void createDescriptorSetLayout();
+        void createDescriptorPool();
+        void allocateDescriptorSet();
+
+        void writeStorageBuffer(uint32_t index, const Buffer::Shared& buffer) const;
+
+    private:
+        GraphicsContext::Shared m_graphicsContext;
+        uint32_t m_storageBufferCapacity = 0;
+
+        Utils::Optional<vk::raii::DescriptorSetLayout> m_descriptorSetLayout;
+        Utils::Optional<vk::raii::DescriptorPool> m_descriptorPool;
+        Utils::Optional<vk::raii::DescriptorSet> m_descriptorSet;
+
+        // Keeps the registered buffers alive for as long as they are reachable from the set
+        std::vector<Buffer::Shared> m_storageBuffers;
+        std::vector<uint32_t> m_freeStorageBufferIndices;
+    };
+} // LearnVulkanRAII
+
+#endif //LEARNVULKANRAII_BINDLESSDESCRIPTORSET_H
\ No newline at end of file
@@ -52,6 +52,26 @@ namespace LearnVulkanRAII
         device.unmapMemory2(memoryUnmapInfo);
     }
 
+    void Buffer::invalidate() const
+    {
+        if (m_memoryPropertyFlags & vk::MemoryPropertyFlagBits::eHostCoherent)
+            return;
+
+        auto& device = m_graphicsContext->getDevice();
+
+        vk::MappedMemoryRange memoryRange{
+            **m_bufferMemory,
+            0,
+            VK_WHOLE_SIZE
+        };
+        device.invalidateMappedMemoryRanges(memoryRange);
+    }
+
+    vk::DeviceSize Buffer::getSize() const
+    {
+        return m_bufferSize;
+    }
+
     const vk::raii::Buffer& Buffer::getNativeBuffer() const
     {
         return *m_buffer;
@@ -25,7 +25,10 @@ namespace LearnVulkanRAII
         void* map() const;
         void* map(vk::DeviceSize bufferSize, vk::DeviceSize offset) const;
         void unmap() const;
+        // Makes device writes visible to a mapping of non coherent memory, the buffer must be mapped
+        void invalidate() const;
 
+        vk::DeviceSize getSize() const;
         const vk::raii::Buffer& getNativeBuffer() const;
 
         static Shared create(const GraphicsContext::Shared& graphicsContext,
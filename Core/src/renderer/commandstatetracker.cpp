@@ -0,0 +1,167 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#include "commandstatetracker.h"
+
+#include <cstring>
+
+namespace LearnVulkanRAII
+{
+    namespace
+    {
+        uint32_t getBindPointSlot(vk::PipelineBindPoint bindPoint)
+        {
+            ASSERT(bindPoint == vk::PipelineBindPoint::eGraphics || bindPoint == vk::PipelineBindPoint::eCompute,
+                "Only the graphics and compute bind points are tracked!");
+            return bindPoint == vk::PipelineBindPoint::eCompute ? 1 : 0;
+        }
+    }
+
+    CommandStateTracker::CommandStateTracker(const vk::raii::CommandBuffer& commandBuffer)
+        : m_commandBuffer(commandBuffer)
+    {
+    }
+
+    void CommandStateTracker::setViewport(const vk::Viewport& viewport)
+    {
+        if (!track(m_viewport && *m_viewport == viewport))
+            return;
+
+        m_commandBuffer.setViewport(0, viewport);
+        m_viewport = viewport;
+    }
+
+    void CommandStateTracker::setScissor(const vk::Rect2D& scissor)
+    {
+        if (!track(m_scissor && *m_scissor == scissor))
+            return;
+
+        m_commandBuffer.setScissor(0, scissor);
+        m_scissor = scissor;
+    }
+
+    void CommandStateTracker::bindPipeline(vk::PipelineBindPoint bindPoint, const vk::raii::Pipeline& pipeline)
+    {
+        auto& state = m_bindPoints[getBindPointSlot(bindPoint)];
+        if (!track(state.pipeline == *pipeline))
+            return;
+
+        m_commandBuffer.bindPipeline(bindPoint, *pipeline);
+        state.pipeline = *pipeline;
+    }
+
+    void CommandStateTracker::bindDescriptorSet(vk::PipelineBindPoint bindPoint,
+        const vk::raii::PipelineLayout& layout,
+        uint32_t setIndex,
+        vk::DescriptorSet descriptorSet)
+    {
+        ASSERT(setIndex < MaxDescriptorSets, "Descriptor set index isn't tracked!");
+
+        // A set bound with another layout may have been disturbed, it's only known bound for the same layout
+        auto& state = m_bindPoints[getBindPointSlot(bindPoint)];
+        if (!track(state.layout == *layout && state.descriptorSets[setIndex] == descriptorSet))
+            return;
+
+        m_commandBuffer.bindDescriptorSets(bindPoint, *layout, setIndex, descriptorSet, nullptr);
+        if (state.layout != *layout)
+            state.descriptorSets.fill(nullptr);
+        state.layout = *layout;
+        state.descriptorSets[setIndex] = descriptorSet;
+    }
+
+    void CommandStateTracker::bindVertexBuffers(uint32_t firstBinding,
+        vk::ArrayProxy<const vk::Buffer> buffers,
+        vk::ArrayProxy<const vk::DeviceSize> offsets)
+    {
+        ASSERT(buffers.size() == offsets.size(), "Every vertex buffer needs an offset!");
+        ASSERT(firstBinding + buffers.size() <= MaxVertexBindings, "Vertex binding isn't tracked!");
+
+        bool redundant = true;
+        for (uint32_t i = 0; i < buffers.size(); i++)
+        {
+            const uint32_t binding = firstBinding + i;
+            redundant = redundant &&
+                m_vertexBuffers[binding] == buffers.data()[i] &&
+                m_vertexBufferOffsets[binding] == offsets.data()[i];
+        }
+
+        if (!track(redundant))
+            return;
+
+        m_commandBuffer.bindVertexBuffers(firstBinding, buffers, offsets);
+        for (uint32_t i = 0; i < buffers.size(); i++)
+        {
+            m_vertexBuffers[firstBinding + i] = buffers.data()[i];
+            m_vertexBufferOffsets[firstBinding + i] = offsets.data()[i];
+        }
+    }
+
+    void CommandStateTracker::bindIndexBuffer(vk::Buffer buffer, vk::DeviceSize offset, vk::IndexType indexType)
+    {
+        if (!track(m_indexBuffer == buffer && m_indexBufferOffset == offset && m_indexType == indexType))
+            return;
+
+        m_commandBuffer.bindIndexBuffer(buffer, offset, indexType);
+        m_indexBuffer = buffer;
+        m_indexBufferOffset = offset;
+        m_indexType = indexType;
+    }
+
+    void CommandStateTracker::pushConstants(const vk::raii::PipelineLayout& layout,
+        vk::ShaderStageFlags stages,
+        uint32_t offset,
+        const void* data,
+        uint32_t size)
+    {
+        const bool redundant = m_pushConstantLayout == *layout &&
+            m_pushConstantStages == stages &&
+            m_pushConstantOffset == offset &&
+            m_pushConstantData.size() == size &&
+            std::memcmp(m_pushConstantData.data(), data, size) == 0;
+
+        if (!track(redundant))
+            return;
+
+        m_commandBuffer.pushConstants(*layout, stages, offset, size, data);
+        m_pushConstantLayout = *layout;
+        m_pushConstantStages = stages;
+        m_pushConstantOffset = offset;
+        m_pushConstantData.assign(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+    }
+
+    void CommandStateTracker::invalidate()
+    {
+        m_viewport.reset();
+        m_scissor.reset();
+        m_bindPoints = {};
+        m_vertexBuffers = {};
+        m_vertexBufferOffsets = {};
+        m_indexBuffer = nullptr;
+        m_indexBufferOffset = 0;
+        m_pushConstantLayout = nullptr;
+        m_pushConstantData.clear();
+    }
+
+    const vk::raii::CommandBuffer& CommandStateTracker::getCommandBuffer() const
+    {
+        return m_commandBuffer;
+    }
+
+    const CommandStateStatistics& CommandStateTracker::getStats() const
+    {
+        return m_stats;
+    }
+
+    bool CommandStateTracker::track(bool redundant)
+    {
+        if (redundant)
+        {
+            m_stats.elidedCommandCount++;
+            return false;
+        }
+
+        m_stats.emittedCommandCount++;
+        return true;
+    }
+} // LearnVulkanRAII
\ No newline at end of file
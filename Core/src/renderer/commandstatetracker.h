@@ -0,0 +1,107 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#ifndef LEARNVULKANRAII_COMMANDSTATETRACKER_H
+#define LEARNVULKANRAII_COMMANDSTATETRACKER_H
+
+#include "base/utils.h"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace LearnVulkanRAII
+{
+    struct CommandStateStatistics
+    {
+        // State setting calls that reached the command buffer, and the ones dropped as redundant
+        size_t emittedCommandCount = 0;
+        size_t elidedCommandCount = 0;
+
+        CommandStateStatistics& operator+=(const CommandStateStatistics& other)
+        {
+            emittedCommandCount += other.emittedCommandCount;
+            elidedCommandCount += other.elidedCommandCount;
+            return *this;
+        }
+    };
+
+    // Records state setting commands into a command buffer, the ones that wouldn't change the bound state are dropped.
+    // Starts with nothing known. State recorded around it (executeCommands, direct binds) must be followed by invalidate().
+    // Draws go to the command buffer directly
+    class CommandStateTracker
+    {
+    public:
+        explicit CommandStateTracker(const vk::raii::CommandBuffer& commandBuffer);
+
+        void setViewport(const vk::Viewport& viewport);
+        void setScissor(const vk::Rect2D& scissor);
+
+        void bindPipeline(vk::PipelineBindPoint bindPoint, const vk::raii::Pipeline& pipeline);
+        void bindDescriptorSet(vk::PipelineBindPoint bindPoint,
+            const vk::raii::PipelineLayout& layout,
+            uint32_t setIndex,
+            vk::DescriptorSet descriptorSet);
+        void bindVertexBuffers(uint32_t firstBinding,
+            vk::ArrayProxy<const vk::Buffer> buffers,
+            vk::ArrayProxy<const vk::DeviceSize> offsets);
+        void bindIndexBuffer(vk::Buffer buffer, vk::DeviceSize offset, vk::IndexType indexType);
+
+        template <typename T>
+        void pushConstants(const vk::raii::PipelineLayout& layout, vk::ShaderStageFlags stages, uint32_t offset, const T& value)
+        {
+            pushConstants(layout, stages, offset, &value, sizeof(T));
+        }
+        void pushConstants(const vk::raii::PipelineLayout& layout,
+            vk::ShaderStageFlags stages,
+            uint32_t offset,
+            const void* data,
+            uint32_t size);
+
+        // Forgets everything, the next call of each kind is emitted
+        void invalidate();
+
+        [[nodiscard]] const vk::raii::CommandBuffer& getCommandBuffer() const;
+        [[nodiscard]] const CommandStateStatistics& getStats() const;
+
+    private:
+        // Counts the call, returns whether it has to be emitted
+        bool track(bool redundant);
+
+    private:
+        static constexpr uint32_t MaxVertexBindings = 4;
+        static constexpr uint32_t MaxDescriptorSets = 4;
+        // Graphics and compute
+        static constexpr uint32_t BindPointCount = 2;
+
+        struct BindPointState
+        {
+            vk::Pipeline pipeline = nullptr;
+            vk::PipelineLayout layout = nullptr;
+            std::array<vk::DescriptorSet, MaxDescriptorSets> descriptorSets{};
+        };
+
+        const vk::raii::CommandBuffer& m_commandBuffer;
+
+        Utils::Optional<vk::Viewport> m_viewport;
+        Utils::Optional<vk::Rect2D> m_scissor;
+        std::array<BindPointState, BindPointCount> m_bindPoints{};
+        std::array<vk::Buffer, MaxVertexBindings> m_vertexBuffers{};
+        std::array<vk::DeviceSize, MaxVertexBindings> m_vertexBufferOffsets{};
+        vk::Buffer m_indexBuffer = nullptr;
+        vk::DeviceSize m_indexBufferOffset = 0;
+        vk::IndexType m_indexType = vk::IndexType::eUint32;
+
+        vk::PipelineLayout m_pushConstantLayout = nullptr;
+        vk::ShaderStageFlags m_pushConstantStages;
+        uint32_t m_pushConstantOffset = 0;
+        std::vector<uint8_t> m_pushConstantData;
+
+        CommandStateStatistics m_stats;
+    };
+} // LearnVulkanRAII
+
+#endif //LEARNVULKANRAII_COMMANDSTATETRACKER_H
\ No newline at end of file
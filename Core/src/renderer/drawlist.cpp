@@ -0,0 +1,293 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#include "drawlist.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace LearnVulkanRAII
+{
+    uint32_t DrawKey::quantizeDepth(float viewDepth)
+    {
+        // Behind the camera (or NaN) sorts first, it only happens for objects crossing the near plane
+        if (!(viewDepth > 0.0f))
+            return 0;
+
+        return std::bit_cast<uint32_t>(viewDepth) >> (32 - DepthBits);
+    }
+
+    uint64_t DrawKey::make(uint32_t pipeline, float viewDepth, uint32_t material, uint32_t mesh)
+    {
+        constexpr uint64_t pipelineMask = (1ull << PipelineBits) - 1;
+        constexpr uint64_t materialMask = (1ull << MaterialBits) - 1;
+        constexpr uint64_t meshMask = (1ull << MeshBits) - 1;
+
+        return ((pipeline & pipelineMask) << PipelineShift) |
+            (static_cast<uint64_t>(quantizeDepth(viewDepth)) << DepthShift) |
+            ((material & materialMask) << MaterialShift) |
+            ((mesh & meshMask) << MeshShift);
+    }
+
+    uint32_t DrawKey::getPipeline(uint64_t key)
+    {
+        return static_cast<uint32_t>(key >> PipelineShift) & ((1u << PipelineBits) - 1);
+    }
+
+    uint32_t DrawKey::getMesh(uint64_t key)
+    {
+        return static_cast<uint32_t>(key >> MeshShift) & ((1u << MeshBits) - 1);
+    }
+
+    void DrawList::add(const Mesh& mesh, const Transform& transform, uint32_t materialIndex, float viewDepth)
+    {
+        m_transforms.push_back(transform);
+        addItem(DrawItem{
+            &mesh,
+            static_cast<uint32_t>(m_transforms.size() - 1),
+            materialIndex,
+            DrawPipeline::ImmediateTransforms
+        }, viewDepth);
+    }
+
+    void DrawList::add(const Mesh& mesh, TransformId transformId, uint32_t materialIndex, float viewDepth)
+    {
+        addItem(DrawItem{ &mesh, transformId, materialIndex, DrawPipeline::RetainedTransforms }, viewDepth);
+    }
+
+    void DrawList::append(const DrawList& other)
+    {
+        // Mesh ids are local to a list, the other list's ones are mapped to ours
+        m_meshIdRemap.resize(other.m_meshIds.size());
+        for (const auto& [mesh, meshId] : other.m_meshIds)
+        {
+            m_meshIdRemap[meshId] = getMeshId(*mesh);
+        }
+
+        const auto transformOffset = static_cast<uint32_t>(m_transforms.size());
+        m_transforms.insert(m_transforms.end(), other.m_transforms.begin(), other.m_transforms.end());
+
+        constexpr uint64_t meshMask = ((1ull << DrawKey::MeshBits) - 1) << DrawKey::MeshShift;
+        m_items.reserve(m_items.size() + other.m_items.size());
+        m_keys.reserve(m_keys.size() + other.m_keys.size());
+        for (size_t i = 0; i < other.m_items.size(); i++)
+        {
+            auto item = other.m_items[i];
+            if (item.pipeline == DrawPipeline::ImmediateTransforms)
+                item.transformIndex += transformOffset;
+            m_items.push_back(item);
+
+            const uint64_t key = other.m_keys[i];
+            const uint64_t meshId = m_meshIdRemap[DrawKey::getMesh(key)];
+            m_keys.push_back((key & ~meshMask) | (meshId << DrawKey::MeshShift));
+        }
+    }
+
+    void DrawList::sort(bool sortByKey, bool groupByMesh)
+    {
+        m_order.resize(m_items.size());
+        for (uint32_t i = 0; i < m_order.size(); i++)
+        {
+            m_order[i] = i;
+        }
+
+        if (sortByKey)
+        {
+            // The submitted keys stay in submission order, only the copy is permuted
+            m_sortedKeys.assign(m_keys.begin(), m_keys.end());
+            radixSort(m_sortedKeys, m_order, m_keyScratch, m_orderScratch);
+        }
+
+        if (groupByMesh)
+            this->groupByMesh();
+
+        buildRuns();
+    }
+
+    void DrawList::clear()
+    {
+        m_items.clear();
+        m_transforms.clear();
+        m_keys.clear();
+        m_sortedKeys.clear();
+        m_order.clear();
+        m_runs.clear();
+        m_meshIds.clear();
+    }
+
+    size_t DrawList::size() const
+    {
+        return m_items.size();
+    }
+
+    bool DrawList::empty() const
+    {
+        return m_items.empty();
+    }
+
+    const DrawItem& DrawList::getSorted(size_t index) const
+    {
+        return m_items[m_order[index]];
+    }
+
+    size_t DrawList::getRunCount() const
+    {
+        return m_runs.size();
+    }
+
+    const DrawRun& DrawList::getRun(size_t index) const
+    {
+        return m_runs[index];
+    }
+
+    const Transform& DrawList::getTransform(const DrawItem& item) const
+    {
+        ASSERT(item.pipeline == DrawPipeline::ImmediateTransforms, "Retained draws don't keep their transform in the list!");
+        return m_transforms[item.transformIndex];
+    }
+
+    void DrawList::radixSort(std::vector<uint64_t>& keys,
+        std::vector<uint32_t>& values,
+        std::vector<uint64_t>& keyScratch,
+        std::vector<uint32_t>& valueScratch)
+    {
+        constexpr uint32_t digitBits = 8;
+        constexpr uint32_t bucketCount = 1u << digitBits;
+        constexpr uint32_t passCount = 64 / digitBits;
+
+        const size_t count = keys.size();
+        ASSERT(values.size() == count, "Every key needs a value!");
+        if (count < 2)
+            return;
+
+        keyScratch.resize(count);
+        valueScratch.resize(count);
+
+        // All the digit histograms in a single read of the keys
+        std::array<std::array<uint32_t, bucketCount>, passCount> histograms{};
+        for (const auto key : keys)
+        {
+            for (uint32_t pass = 0; pass < passCount; pass++)
+            {
+                histograms[pass][(key >> (pass * digitBits)) & (bucketCount - 1)]++;
+            }
+        }
+
+        for (uint32_t pass = 0; pass < passCount; pass++)
+        {
+            auto& histogram = histograms[pass];
+            const uint32_t shift = pass * digitBits;
+
+            // Every key has the same digit, the pass wouldn't move anything
+            if (histogram[(keys.front() >> shift) & (bucketCount - 1)] == count)
+                continue;
+
+            uint32_t offset = 0;
+            for (auto& bucket : histogram)
+            {
+                const uint32_t bucketSize = bucket;
+                bucket = offset;
+                offset += bucketSize;
+            }
+
+            for (size_t i = 0; i < count; i++)
+            {
+                const uint32_t destination = histogram[(keys[i] >> shift) & (bucketCount - 1)]++;
+                keyScratch[destination] = keys[i];
+                valueScratch[destination] = values[i];
+            }
+
+            keys.swap(keyScratch);
+            values.swap(valueScratch);
+        }
+    }
+
+    void DrawList::addItem(const DrawItem& item, float viewDepth)
+    {
+        m_items.push_back(item);
+        m_keys.push_back(DrawKey::make(static_cast<uint32_t>(item.pipeline),
+            viewDepth,
+            item.materialIndex,
+            getMeshId(*item.mesh)));
+    }
+
+    uint32_t DrawList::getMeshId(const Mesh& mesh)
+    {
+        auto [it, _] = m_meshIds.try_emplace(&mesh, static_cast<uint32_t>(m_meshIds.size()));
+        return it->second;
+    }
+
+    void DrawList::groupByMesh()
+    {
+        // Mesh ids are dense within the frame, so every (pipeline, mesh) pair has a slot in a flat table.
+        // A counting sort on the slots, numbered by first appearance, keeps the current order within a group
+        constexpr uint32_t invalidGroup = UINT32_MAX;
+        const size_t meshCount = m_meshIds.size();
+        const size_t count = m_order.size();
+
+        auto& groupOfSlot = m_groupSlots;
+        groupOfSlot.assign((size_t(1) << DrawKey::PipelineBits) * meshCount, invalidGroup);
+        m_groupOffsets.clear();
+
+        // The group of every draw is kept in the key scratch, it isn't needed after the radix sort
+        m_keyScratch.resize(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            const uint64_t key = m_keys[m_order[i]];
+            const size_t slot = DrawKey::getPipeline(key) * meshCount + DrawKey::getMesh(key);
+            if (groupOfSlot[slot] == invalidGroup)
+            {
+                groupOfSlot[slot] = static_cast<uint32_t>(m_groupOffsets.size());
+                m_groupOffsets.push_back(0);
+            }
+
+            m_keyScratch[i] = groupOfSlot[slot];
+            m_groupOffsets[groupOfSlot[slot]]++;
+        }
+
+        if (m_groupOffsets.size() == count)
+            return;
+
+        uint32_t offset = 0;
+        for (auto& group : m_groupOffsets)
+        {
+            const uint32_t groupSize = group;
+            group = offset;
+            offset += groupSize;
+        }
+
+        auto& grouped = m_orderScratch;
+        grouped.resize(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            grouped[m_groupOffsets[m_keyScratch[i]]++] = m_order[i];
+        }
+
+        m_order.swap(grouped);
+    }
+
+    void DrawList::buildRuns()
+    {
+        m_runs.clear();
+
+        uint32_t previousPipeline = UINT32_MAX;
+        uint32_t previousMesh = UINT32_MAX;
+        for (uint32_t i = 0; i < m_order.size(); i++)
+        {
+            const uint64_t key = m_keys[m_order[i]];
+            const uint32_t pipeline = DrawKey::getPipeline(key);
+            const uint32_t mesh = DrawKey::getMesh(key);
+
+            if (pipeline != previousPipeline || mesh != previousMesh)
+            {
+                m_runs.push_back(DrawRun{ i, 0 });
+                previousPipeline = pipeline;
+                previousMesh = mesh;
+            }
+
+            m_runs.back().count++;
+        }
+    }
+} // LearnVulkanRAII
\ No newline at end of file
@@ -0,0 +1,126 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#ifndef LEARNVULKANRAII_DRAWLIST_H
+#define LEARNVULKANRAII_DRAWLIST_H
+
+#include "base/utils.h"
+
+#include "mesh/mesh.h"
+
+#include "bindlessdescriptorset.h"
+#include "transformstore.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace LearnVulkanRAII
+{
+    // 64 bit sort key, most significant field first:
+    // pipeline (4) | quantized view depth (24) | material (12) | mesh (24)
+    // Draws sharing a pipeline stay together (a pipeline change breaks the batch), then go front to back
+    struct DrawKey
+    {
+        static constexpr uint32_t PipelineBits = 4;
+        static constexpr uint32_t DepthBits = 24;
+        static constexpr uint32_t MaterialBits = 12;
+        static constexpr uint32_t MeshBits = 24;
+
+        static constexpr uint32_t MeshShift = 0;
+        static constexpr uint32_t MaterialShift = MeshShift + MeshBits;
+        static constexpr uint32_t DepthShift = MaterialShift + MaterialBits;
+        static constexpr uint32_t PipelineShift = DepthShift + DepthBits;
+        static_assert(PipelineShift + PipelineBits == 64, "DrawKey fields must fill 64 bits!");
+
+        // The bits of a non negative float grow with its value, the top bits are a monotonic quantization
+        static uint32_t quantizeDepth(float viewDepth);
+
+        static uint64_t make(uint32_t pipeline, float viewDepth, uint32_t material, uint32_t mesh);
+
+        static uint32_t getPipeline(uint64_t key);
+        static uint32_t getMesh(uint64_t key);
+    };
+
+    // Pipelines the batched draws can end up in, a batch only ever uses one of them
+    enum class DrawPipeline : uint32_t
+    {
+        ImmediateTransforms = 0,
+        RetainedTransforms = 1
+    };
+
+    struct DrawItem
+    {
+        const Mesh* mesh = nullptr;
+        // Index into the list's transforms, or the TransformId for retained transforms
+        uint32_t transformIndex = 0;
+        uint32_t materialIndex = BindlessDescriptorSet::InvalidIndex;
+        DrawPipeline pipeline = DrawPipeline::ImmediateTransforms;
+    };
+
+    // Consecutive sorted draws sharing the pipeline and the mesh, candidates for a single instanced draw
+    struct DrawRun
+    {
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+
+    // Frame local list of draws, sorted by DrawKey with a LSD radix sort (8 bit digits) before batching.
+    // The sorted draws can be regrouped by mesh so repeated geometry ends up in runs.
+    // Meshes are referenced, they must stay alive until the list is cleared
+    class DrawList
+    {
+    public:
+        void add(const Mesh& mesh, const Transform& transform, uint32_t materialIndex, float viewDepth);
+        void add(const Mesh& mesh, TransformId transformId, uint32_t materialIndex, float viewDepth);
+        // Adds the other list's draws after ours, its mesh ids are renumbered into this list's
+        void append(const DrawList& other);
+
+        // Orders the draws for submission, both steps are stable and linear in the draw count.
+        // sortByKey: DrawKey order, digits shared by every key are skipped. Submission order otherwise.
+        // groupByMesh: draws of the same pipeline and mesh move next to the first of them
+        void sort(bool sortByKey = true, bool groupByMesh = false);
+        void clear();
+
+        [[nodiscard]] size_t size() const;
+        [[nodiscard]] bool empty() const;
+
+        // Valid after sort(), index 0 is the first draw to submit
+        [[nodiscard]] const DrawItem& getSorted(size_t index) const;
+        [[nodiscard]] size_t getRunCount() const;
+        [[nodiscard]] const DrawRun& getRun(size_t index) const;
+        [[nodiscard]] const Transform& getTransform(const DrawItem& item) const;
+
+        static void radixSort(std::vector<uint64_t>& keys,
+            std::vector<uint32_t>& values,
+            std::vector<uint64_t>& keyScratch,
+            std::vector<uint32_t>& valueScratch);
+
+    private:
+        void addItem(const DrawItem& item, float viewDepth);
+        uint32_t getMeshId(const Mesh& mesh);
+
+        void groupByMesh();
+        void buildRuns();
+
+    private:
+        std::vector<DrawItem> m_items;
+        std::vector<Transform> m_transforms;
+
+        std::vector<uint64_t> m_keys;
+        std::vector<uint64_t> m_sortedKeys;
+        std::vector<uint32_t> m_order;
+        std::vector<uint64_t> m_keyScratch;
+        std::vector<uint32_t> m_orderScratch;
+        std::vector<uint32_t> m_groupSlots;
+        std::vector<uint32_t> m_groupOffsets;
+        std::vector<DrawRun> m_runs;
+
+        // Mesh identity within the frame, draws of the same mesh end up next to each other at equal depth
+        std::unordered_map<const Mesh*, uint32_t> m_meshIds;
+        std::vector<uint32_t> m_meshIdRemap;
+    };
+} // LearnVulkanRAII
+
+#endif //LEARNVULKANRAII_DRAWLIST_H
\ No newline at end of file
@@ -0,0 +1,79 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#include "drawrecorder.h"
+
+namespace LearnVulkanRAII
+{
+    DrawRecorder::DrawRecorder(const TransformStore::Shared& transformStore)
+        : m_transformStore(transformStore)
+    {
+    }
+
+    void DrawRecorder::drawMesh(const Mesh& mesh, const Transform& transform, uint32_t materialIndex)
+    {
+        const auto bounds = mesh.getBoundingSphere().transformed(transform);
+        if (!cull(bounds))
+            return;
+
+        m_drawList.add(mesh, transform, materialIndex, getViewDepth(bounds.center));
+    }
+
+    void DrawRecorder::drawMesh(const Mesh& mesh, TransformId transformId, uint32_t materialIndex)
+    {
+        ASSERT(m_transformStore->isValid(transformId), "Invalid transform id!");
+        ASSERT(transformId <= InternalVertex::ObjectMetadataIndexMask, "Transform id doesn't fit in the packed internal vertex!");
+
+        // getAffine3x4() may recompute the cached record, getTransform() only reads
+        const auto bounds = mesh.getBoundingSphere().transformed(m_transformStore->getTransform(transformId));
+        if (!cull(bounds))
+            return;
+
+        m_drawList.add(mesh, transformId, materialIndex, getViewDepth(bounds.center));
+    }
+
+    void DrawRecorder::reset(const glm::mat4& viewProjection, const Frustum& frustum, bool frustumCullingEnabled)
+    {
+        // Clip space w of a perspective projection is the distance along the view axis
+        m_viewDepthRow = glm::vec4(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+        m_frustum = frustum;
+        m_frustumCullingEnabled = frustumCullingEnabled;
+
+        m_drawList.clear();
+        m_visibleObjectCount = 0;
+        m_culledObjectCount = 0;
+    }
+
+    const DrawList& DrawRecorder::getDrawList() const
+    {
+        return m_drawList;
+    }
+
+    size_t DrawRecorder::getVisibleObjectCount() const
+    {
+        return m_visibleObjectCount;
+    }
+
+    size_t DrawRecorder::getCulledObjectCount() const
+    {
+        return m_culledObjectCount;
+    }
+
+    bool DrawRecorder::cull(const BoundingSphere& bounds)
+    {
+        if (m_frustumCullingEnabled && !m_frustum.intersects(bounds))
+        {
+            m_culledObjectCount++;
+            return false;
+        }
+
+        m_visibleObjectCount++;
+        return true;
+    }
+
+    float DrawRecorder::getViewDepth(const glm::vec3& worldPosition) const
+    {
+        return glm::dot(m_viewDepthRow, glm::vec4(worldPosition, 1.0f));
+    }
+} // LearnVulkanRAII
\ No newline at end of file
@@ -0,0 +1,65 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#ifndef LEARNVULKANRAII_DRAWRECORDER_H
+#define LEARNVULKANRAII_DRAWRECORDER_H
+
+#include "base/utils.h"
+
+#include "mesh/mesh.h"
+
+#include "bindlessdescriptorset.h"
+#include "drawlist.h"
+#include "frustum.h"
+#include "renderertypes.h"
+#include "transformstore.h"
+
+#include <glm/glm.hpp>
+
+namespace LearnVulkanRAII
+{
+    // Culls and collects draws away from the renderer, so the scene can be walked on several threads at once.
+    // A recorder belongs to one thread (or one job) for the frame, the renderer appends its draws at endFrame().
+    // Retained transforms are only read, they mustn't change while recorders are in use
+    class DrawRecorder
+    {
+    public:
+        DEFINE_SMART_POINTER_HELPERS(DrawRecorder)
+
+    public:
+        explicit DrawRecorder(const TransformStore::Shared& transformStore);
+
+        void drawMesh(const Mesh& mesh,
+            const Transform& transform,
+            uint32_t materialIndex = BindlessDescriptorSet::InvalidIndex);
+        void drawMesh(const Mesh& mesh,
+            TransformId transformId,
+            uint32_t materialIndex = BindlessDescriptorSet::InvalidIndex);
+
+        // Renderer side, at the start and the end of the recorder's frame
+        void reset(const glm::mat4& viewProjection, const Frustum& frustum, bool frustumCullingEnabled);
+
+        [[nodiscard]] const DrawList& getDrawList() const;
+        [[nodiscard]] size_t getVisibleObjectCount() const;
+        [[nodiscard]] size_t getCulledObjectCount() const;
+
+    private:
+        // Returns false when the bounds are culled
+        bool cull(const BoundingSphere& bounds);
+        [[nodiscard]] float getViewDepth(const glm::vec3& worldPosition) const;
+
+    private:
+        TransformStore::Shared m_transformStore;
+
+        glm::vec4 m_viewDepthRow = glm::vec4(0.0f);
+        Frustum m_frustum;
+        bool m_frustumCullingEnabled = true;
+
+        DrawList m_drawList;
+        size_t m_visibleObjectCount = 0;
+        size_t m_culledObjectCount = 0;
+    };
+} // LearnVulkanRAII
+
+#endif //LEARNVULKANRAII_DRAWRECORDER_H
\ No newline at end of file
@@ -51,10 +51,8 @@ namespace LearnVulkanRAII
     // }
 
     Framebuffer::Framebuffer(const GraphicsContext::Shared &graphicsContext,
-        const vk::raii::RenderPass &renderPass,
         const FramebufferSpecification &spec)
             : m_graphicsContext(graphicsContext),
-        m_renderPass(renderPass),
         m_spec(spec)
     {
         init();
@@ -78,9 +76,19 @@ namespace LearnVulkanRAII
         return m_spec.height;
     }
 
-    const vk::raii::Framebuffer& Framebuffer::getBuffer() const
+    size_t Framebuffer::getAttachmentCount() const
     {
-        return *m_framebuffer;
+        return m_imageViews.size();
+    }
+
+    vk::Image Framebuffer::getAttachmentImage(size_t index) const
+    {
+        return m_images[index] ? *m_images[index]->getImage() : m_spec.attachments[index].existingImage;
+    }
+
+    vk::ImageView Framebuffer::getAttachmentImageView(size_t index) const
+    {
+        return m_imageViews[index];
     }
 
     const std::vector<vk::ClearValue>& Framebuffer::getClearValues() const
@@ -88,6 +96,17 @@ namespace LearnVulkanRAII
         return m_clearValues;
     }
 
+    Image::Shared Framebuffer::getDepthImage() const
+    {
+        for (size_t i = 0; i < m_spec.attachments.size(); i++)
+        {
+            if (m_images[i] && (m_spec.attachments[i].aspectFlags & vk::ImageAspectFlagBits::eDepth))
+                return m_images[i];
+        }
+
+        return nullptr;
+    }
+
     const FramebufferSpecification& Framebuffer::getFramebufferSpecification() const
     {
         return m_spec;
@@ -95,21 +114,18 @@ namespace LearnVulkanRAII
 
     void Framebuffer::init()
     {
-        // TODO: Need to check for the attachment order from the RenderPass
-        auto& device = m_graphicsContext->getDevice();
-
         m_images.clear();
+        m_imageViews.clear();
         m_clearValues.clear();
-        m_framebuffer.reset();
 
         m_clearValues.reserve(m_spec.attachments.size());
-        std::vector<vk::ImageView> imageViews;
-        imageViews.reserve(m_spec.attachments.size());
+        m_imageViews.reserve(m_spec.attachments.size());
         for (const auto& attachment : m_spec.attachments)
         {
             if (attachment.existingImageView)
             {
-                imageViews.push_back(attachment.existingImageView);
+                ASSERT(attachment.existingImage, "Existing attachments need their image as well!");
+                m_imageViews.push_back(attachment.existingImageView);
                 m_images.push_back(nullptr);
             }
             else
@@ -123,30 +139,16 @@ namespace LearnVulkanRAII
 
                 auto image = Image::makeShared(m_graphicsContext, attachmentImageSpecification);
                 m_images.push_back(image);
-                imageViews.push_back(image->getImageView());
+                m_imageViews.push_back(*image->getImageView());
             }
 
             m_clearValues.push_back(attachment.clearValue);
         }
-
-        vk::FramebufferCreateInfo framebufferCreateInfo{
-            {},
-            *m_renderPass,
-            static_cast<uint32_t>(imageViews.size()),
-            imageViews.data(),
-            m_spec.width,
-            m_spec.height,
-            1
-        };
-
-        m_framebuffer = device.createFramebuffer(framebufferCreateInfo);
     }
 
     SwapchainFramebuffer::SwapchainFramebuffer(const GraphicsContext::Shared& graphicsContext,
-        const vk::raii::RenderPass& renderPass,
         const Utils::Optional<FramebufferAttachmentInfo>& depthAttachment)
         : m_graphicsContext(graphicsContext),
-        m_renderPass(renderPass),
         m_framebufferType(SwapchainFramebufferType::SWAPCHAIN)
     {
         if (depthAttachment.has_value())
@@ -158,10 +160,8 @@ namespace LearnVulkanRAII
     }
 
     SwapchainFramebuffer::SwapchainFramebuffer(const GraphicsContext::Shared &graphicsContext,
-        const vk::raii::RenderPass &renderPass,
         const FramebufferSpecification &spec)
         : m_graphicsContext(graphicsContext),
-        m_renderPass(renderPass),
         m_framebufferType(SwapchainFramebufferType::OFFSCREEN),
         m_spec(spec)
     {
@@ -195,19 +195,20 @@ namespace LearnVulkanRAII
     {
         m_framebuffers.clear();
 
+        auto& swapchainImages = m_graphicsContext->getSwapchainImages();
         auto& swapchainImageViews = m_graphicsContext->getSwapchainImageViews();
         auto swapchainImageFormat = m_graphicsContext->getSwapchainImageFormat();
 
         // Generate specifications
         std::vector<FramebufferSpecification> swapchainFramebufferSpecifications;
-        swapchainFramebufferSpecifications.reserve(swapchainImageViews.size());
+        swapchainFramebufferSpecifications.reserve(m_graphicsContext->getSwapchainImageCount());
         if (m_framebufferType == SwapchainFramebufferType::SWAPCHAIN)
         {
             auto swapchainExtent = m_graphicsContext->getSwapchainExtent();
             m_spec.width = swapchainExtent.width;
             m_spec.height = swapchainExtent.height;
 
-            for (const auto & swapchainImageView : swapchainImageViews)
+            for (size_t i = 0; i < swapchainImageViews.size(); i++)
             {
                 FramebufferSpecification spec{
                     m_spec.width,
@@ -215,7 +216,7 @@ namespace LearnVulkanRAII
                 };
 
                 // Create a swapchain image view attachment info
-                vk::ImageView ivRaw = *swapchainImageView;
+                vk::ImageView ivRaw = *swapchainImageViews[i];
                 FramebufferAttachmentInfo swapchainImageAttachmentInfo;
                 swapchainImageAttachmentInfo.format = swapchainImageFormat;
                 swapchainImageAttachmentInfo.usageFlags = vk::ImageUsageFlagBits::eColorAttachment;
@@ -223,9 +224,10 @@ namespace LearnVulkanRAII
                 swapchainImageAttachmentInfo.clearValue = vk::ClearValue{
                     vk::ClearColorValue(std::array{ 0.0f, 0.0f, 0.0f, 1.0f })
                 };
+                swapchainImageAttachmentInfo.existingImage = swapchainImages[i];
                 swapchainImageAttachmentInfo.existingImageView = ivRaw;
 
-                // TODO: Somehow need to handle the order of the attachments based on the RenderPass attachment order
+                // The renderer picks the attachments up by their aspect, the order doesn't matter
                 spec.attachments.emplace_back(swapchainImageAttachmentInfo);
                 spec.attachments.insert(spec.attachments.end(),
                     m_spec.attachments.begin(),
@@ -236,14 +238,15 @@ namespace LearnVulkanRAII
         }
         else if (m_framebufferType == SwapchainFramebufferType::OFFSCREEN)
         {
-            std::ranges::fill(swapchainFramebufferSpecifications, m_spec);
+            // One set of attachments per frame slot (the headless stand-in for an image), frames in flight never share them
+            swapchainFramebufferSpecifications.assign(m_graphicsContext->getSwapchainImageCount(), m_spec);
         }
 
         // Create the framebuffers
         for (auto& swapchainFramebufferSpecification : swapchainFramebufferSpecifications)
         {
             m_framebuffers.push_back(
-                Framebuffer::makeShared(m_graphicsContext, m_renderPass, swapchainFramebufferSpecification));
+                Framebuffer::makeShared(m_graphicsContext, swapchainFramebufferSpecification));
         }
     }
 
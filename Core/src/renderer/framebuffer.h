@@ -28,6 +28,8 @@ namespace LearnVulkanRAII
         vk::ImageAspectFlags aspectFlags;
         vk::ClearValue clearValue{};
 
+        // Both set for an attachment owned elsewhere (a swapchain image), the image is needed for its layout transitions
+        vk::Image existingImage = nullptr;
         vk::ImageView existingImageView = nullptr;
     };
 
@@ -38,6 +40,8 @@ namespace LearnVulkanRAII
         std::vector<FramebufferAttachmentInfo> attachments{};
     };
 
+    // Attachment set of a dynamic rendering pass, no render pass or VkFramebuffer object behind it:
+    // a resize only re-creates the owned images
     class Framebuffer
     {
     public:
@@ -45,7 +49,6 @@ namespace LearnVulkanRAII
 
     public:
         Framebuffer(const GraphicsContext::Shared& graphicsContext,
-            const vk::raii::RenderPass& renderPass,
             const FramebufferSpecification& spec);
 
         void resize(uint32_t width, uint32_t height);
@@ -53,8 +56,13 @@ namespace LearnVulkanRAII
         [[nodiscard]] uint32_t getWidth() const;
         [[nodiscard]] uint32_t getHeight() const;
 
-        [[nodiscard]] const vk::raii::Framebuffer& getBuffer() const;
+        // In the specification's attachment order
+        [[nodiscard]] size_t getAttachmentCount() const;
+        [[nodiscard]] vk::Image getAttachmentImage(size_t index) const;
+        [[nodiscard]] vk::ImageView getAttachmentImageView(size_t index) const;
         [[nodiscard]] const std::vector<vk::ClearValue>& getClearValues() const;
+        // First attachment owned by the framebuffer with a depth aspect, nullptr when there is none
+        [[nodiscard]] Image::Shared getDepthImage() const;
 
         const FramebufferSpecification& getFramebufferSpecification() const;
 
@@ -63,13 +71,11 @@ namespace LearnVulkanRAII
 
     private:
         GraphicsContext::Shared m_graphicsContext;
-        const vk::raii::RenderPass& m_renderPass;
         FramebufferSpecification m_spec;
 
         std::vector<Image::Shared> m_images;
+        std::vector<vk::ImageView> m_imageViews;
         std::vector<vk::ClearValue> m_clearValues;
-
-        Utils::Optional<vk::raii::Framebuffer> m_framebuffer;
     };
 
     class SwapchainFramebuffer
@@ -78,12 +84,10 @@ namespace LearnVulkanRAII
         DEFINE_SMART_POINTER_HELPERS(SwapchainFramebuffer)
 
     public:
-        SwapchainFramebuffer(const GraphicsContext::Shared& graphicsContext,
-            const vk::raii::RenderPass& renderPass,
+        explicit SwapchainFramebuffer(const GraphicsContext::Shared& graphicsContext,
             const Utils::Optional<FramebufferAttachmentInfo>& depthAttachment = Utils::NullOptional);
 
         SwapchainFramebuffer(const GraphicsContext::Shared& graphicsContext,
-            const vk::raii::RenderPass& renderPass,
             const FramebufferSpecification& spec);
 
         void resize(uint32_t width, uint32_t height);
@@ -98,7 +102,6 @@ namespace LearnVulkanRAII
 
     private:
         GraphicsContext::Shared m_graphicsContext;
-        const vk::raii::RenderPass& m_renderPass;
         SwapchainFramebufferType m_framebufferType = SwapchainFramebufferType::None;
         FramebufferSpecification m_spec;
 
@@ -0,0 +1,184 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#include "frameslotbuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace LearnVulkanRAII
+{
+    FrameSlotBuffer::FrameSlotBuffer(const GraphicsContext::Shared& graphicsContext,
+        const BindlessDescriptorSet::Shared& bindlessDescriptorSet,
+        vk::BufferUsageFlags usage,
+        size_t recordSize,
+        uint32_t frameSlotCount,
+        uint32_t initialCapacity)
+        : m_graphicsContext(graphicsContext),
+        m_bindlessDescriptorSet(bindlessDescriptorSet),
+        m_usage(usage),
+        m_recordSize(recordSize),
+        m_capacity(std::max(initialCapacity, 1u)),
+        m_frameSlots(frameSlotCount)
+    {
+        init();
+    }
+
+    FrameSlotBuffer::~FrameSlotBuffer()
+    {
+        if (!m_bindlessDescriptorSet)
+            return;
+
+        for (const auto& slot : m_frameSlots)
+        {
+            m_bindlessDescriptorSet->releaseStorageBuffer(slot.bindlessIndex);
+        }
+    }
+
+    void FrameSlotBuffer::resize(size_t recordCount)
+    {
+        if (recordCount > m_recordCount)
+        {
+            m_records.resize(recordCount * m_recordSize);
+            m_uploadMask.resize(recordCount, 0);
+        }
+        m_recordCount = recordCount;
+
+        while (m_capacity < m_recordCount)
+            m_capacity *= 2;
+    }
+
+    size_t FrameSlotBuffer::size() const
+    {
+        return m_recordCount;
+    }
+
+    void FrameSlotBuffer::markDirty(size_t index)
+    {
+        ASSERT(index < m_recordCount, "Record index out of bounds!");
+
+        const auto id = static_cast<uint32_t>(index);
+        for (uint32_t slot = 0; slot < m_frameSlots.size(); slot++)
+        {
+            const uint32_t slotBit = 1u << slot;
+            if ((m_uploadMask[id] & slotBit) == 0)
+            {
+                m_uploadMask[id] |= slotBit;
+                m_frameSlots[slot].pendingUploads.push_back(id);
+            }
+        }
+    }
+
+    size_t FrameSlotBuffer::flush(uint32_t frameSlot)
+    {
+        ASSERT(frameSlot < m_frameSlots.size(), "Invalid frame slot!");
+
+        ensureSlotCapacity(frameSlot);
+
+        auto& slot = m_frameSlots[frameSlot];
+        if (slot.pendingUploads.empty())
+            return 0;
+
+        auto& pending = slot.pendingUploads;
+        std::ranges::sort(pending);
+
+        // The whole buffer is mapped once, only the changed ranges are written
+        auto* mapped = static_cast<std::byte*>(slot.buffer->map());
+
+        size_t bytesUploaded = 0;
+        size_t runBegin = 0;
+        for (size_t i = 1; i <= pending.size(); i++)
+        {
+            if (i < pending.size() && pending[i] == pending[i - 1] + 1)
+                continue;
+
+            const size_t first = pending[runBegin];
+            const size_t count = std::min(i - runBegin, m_recordCount - std::min(first, m_recordCount));
+            memcpy(mapped + first * m_recordSize, m_records.data() + first * m_recordSize, count * m_recordSize);
+            bytesUploaded += count * m_recordSize;
+            runBegin = i;
+        }
+
+        slot.buffer->unmap();
+
+        for (const auto id : pending)
+        {
+            m_uploadMask[id] &= ~(1u << frameSlot);
+        }
+        pending.clear();
+
+        return bytesUploaded;
+    }
+
+    const Buffer::Shared& FrameSlotBuffer::getBuffer(uint32_t frameSlot) const
+    {
+        return m_frameSlots[frameSlot].buffer;
+    }
+
+    uint32_t FrameSlotBuffer::getBindlessIndex(uint32_t frameSlot) const
+    {
+        return m_frameSlots[frameSlot].bindlessIndex;
+    }
+
+    uint64_t FrameSlotBuffer::getGeneration() const
+    {
+        return m_generation;
+    }
+
+    FrameSlotBuffer::Shared FrameSlotBuffer::create(const GraphicsContext::Shared& graphicsContext,
+        const BindlessDescriptorSet::Shared& bindlessDescriptorSet,
+        vk::BufferUsageFlags usage,
+        size_t recordSize,
+        uint32_t frameSlotCount,
+        uint32_t initialCapacity)
+    {
+        return makeShared(graphicsContext, bindlessDescriptorSet, usage, recordSize, frameSlotCount, initialCapacity);
+    }
+
+    void FrameSlotBuffer::init()
+    {
+        ASSERT(m_frameSlots.size() <= 32, "The upload mask only tracks 32 frame slots!");
+        ASSERT(m_recordSize > 0, "Invalid record size!");
+
+        m_records.reserve(m_capacity * m_recordSize);
+        m_uploadMask.reserve(m_capacity);
+
+        for (uint32_t i = 0; i < m_frameSlots.size(); i++)
+        {
+            ensureSlotCapacity(i);
+        }
+    }
+
+    void FrameSlotBuffer::ensureSlotCapacity(uint32_t frameSlot)
+    {
+        auto& slot = m_frameSlots[frameSlot];
+        if (slot.capacity >= m_capacity)
+            return;
+
+        slot.buffer = Buffer::create(
+            m_graphicsContext,
+            static_cast<vk::DeviceSize>(m_capacity * m_recordSize),
+            m_usage,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+        slot.capacity = m_capacity;
+        m_generation++;
+
+        if (m_bindlessDescriptorSet)
+        {
+            if (slot.bindlessIndex == BindlessDescriptorSet::InvalidIndex)
+                slot.bindlessIndex = m_bindlessDescriptorSet->registerStorageBuffer(slot.buffer);
+            else
+                m_bindlessDescriptorSet->updateStorageBuffer(slot.bindlessIndex, slot.buffer);
+        }
+
+        // The new buffer starts empty, every record has to be written again
+        const uint32_t slotBit = 1u << frameSlot;
+        slot.pendingUploads.clear();
+        for (uint32_t id = 0; id < m_recordCount; id++)
+        {
+            m_uploadMask[id] |= slotBit;
+            slot.pendingUploads.push_back(id);
+        }
+    }
+} // LearnVulkanRAII
\ No newline at end of file
@@ -0,0 +1,103 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#ifndef LEARNVULKANRAII_FRAMESLOTBUFFER_H
+#define LEARNVULKANRAII_FRAMESLOTBUFFER_H
+
+#include "base/utils.h"
+#include "base/graphicscontext.h"
+
+#include "buffer.h"
+#include "bindlessdescriptorset.h"
+
+#include <vector>
+
+namespace LearnVulkanRAII
+{
+    // Fixed size records kept on the CPU and mirrored into one host visible buffer per frame in flight.
+    // Changed records are queued for every frame slot and written the next time that slot is flushed,
+    // coalesced into contiguous ranges, so unchanged records are never copied again.
+    class FrameSlotBuffer
+    {
+    public:
+        DEFINE_SMART_POINTER_HELPERS(FrameSlotBuffer)
+
+    public:
+        // Storage buffers are registered in the bindless set when one is given
+        FrameSlotBuffer(const GraphicsContext::Shared& graphicsContext,
+            const BindlessDescriptorSet::Shared& bindlessDescriptorSet,
+            vk::BufferUsageFlags usage,
+            size_t recordSize,
+            uint32_t frameSlotCount,
+            uint32_t initialCapacity);
+        ~FrameSlotBuffer();
+
+        // Slot buffers are grown lazily in flush(), once the GPU is done with them
+        void resize(size_t recordCount);
+        [[nodiscard]] size_t size() const;
+
+        template<typename T>
+        T* data()
+        {
+            ASSERT(sizeof(T) == m_recordSize, "Record type doesn't match the record size!");
+            return reinterpret_cast<T*>(m_records.data());
+        }
+
+        template<typename T>
+        T& at(size_t index)
+        {
+            return data<T>()[index];
+        }
+
+        void markDirty(size_t index);
+
+        // Writes the records the slot hasn't seen yet, returns the uploaded byte count.
+        // The caller must make sure the GPU is done with the slot buffer
+        size_t flush(uint32_t frameSlot);
+
+        [[nodiscard]] const Buffer::Shared& getBuffer(uint32_t frameSlot) const;
+        [[nodiscard]] uint32_t getBindlessIndex(uint32_t frameSlot) const;
+        // Bumped whenever a slot buffer is re-created, a destroyed buffer's handle value may come back
+        [[nodiscard]] uint64_t getGeneration() const;
+
+        static Shared create(const GraphicsContext::Shared& graphicsContext,
+            const BindlessDescriptorSet::Shared& bindlessDescriptorSet,
+            vk::BufferUsageFlags usage,
+            size_t recordSize,
+            uint32_t frameSlotCount,
+            uint32_t initialCapacity = 1024);
+
+    private:
+        void init();
+
+        void ensureSlotCapacity(uint32_t frameSlot);
+
+    private:
+        struct FrameSlot
+        {
+            Buffer::Shared buffer;
+            uint32_t bindlessIndex = BindlessDescriptorSet::InvalidIndex;
+            size_t capacity = 0;
+
+            // Records that haven't reached this slot's buffer yet
+            std::vector<uint32_t> pendingUploads;
+        };
+
+        GraphicsContext::Shared m_graphicsContext;
+        BindlessDescriptorSet::Shared m_bindlessDescriptorSet;
+        vk::BufferUsageFlags m_usage;
+        size_t m_recordSize = 0;
+        size_t m_capacity = 0;
+        size_t m_recordCount = 0;
+
+        std::vector<std::byte> m_records;
+        // One bit per frame slot, set while the slot's copy of the record is stale
+        std::vector<uint32_t> m_uploadMask;
+
+        std::vector<FrameSlot> m_frameSlots;
+        uint64_t m_generation = 0;
+    };
+} // LearnVulkanRAII
+
+#endif //LEARNVULKANRAII_FRAMESLOTBUFFER_H
\ No newline at end of file
@@ -0,0 +1,123 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#include "frustum.h"
+
+#include <bit>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define LEARNVULKANRAII_FRUSTUM_SSE 1
+    #include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define LEARNVULKANRAII_FRUSTUM_NEON 1
+    #include <arm_neon.h>
+#endif
+
+namespace LearnVulkanRAII
+{
+    Frustum Frustum::fromViewProjection(const glm::mat4& viewProjection)
+    {
+        // Gribb/Hartmann: the planes are sums of the matrix rows
+        const glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+        const glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+        const glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+        const glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+        Frustum frustum;
+        frustum.planes[Left] = row3 + row0;
+        frustum.planes[Right] = row3 - row0;
+        frustum.planes[Bottom] = row3 + row1;
+        frustum.planes[Top] = row3 - row1;
+        frustum.planes[Near] = row2; // 0 <= z
+        frustum.planes[Far] = row3 - row2;
+
+        for (auto& plane : frustum.planes)
+        {
+            plane /= glm::length(glm::vec3(plane));
+        }
+
+        return frustum;
+    }
+
+    bool Frustum::intersects(const BoundingSphere& sphere) const
+    {
+        for (const auto& plane : planes)
+        {
+            if (glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius)
+                return false;
+        }
+
+        return true;
+    }
+
+    size_t Frustum::cullSpheres(const float* centerX,
+        const float* centerY,
+        const float* centerZ,
+        const float* radius,
+        size_t count,
+        uint8_t* visible) const
+    {
+        size_t visibleCount = 0;
+        size_t i = 0;
+
+#if defined(LEARNVULKANRAII_FRUSTUM_SSE)
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 cx = _mm_loadu_ps(centerX + i);
+            const __m128 cy = _mm_loadu_ps(centerY + i);
+            const __m128 cz = _mm_loadu_ps(centerZ + i);
+            const __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (const auto& plane : planes)
+            {
+                __m128 distance = _mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(plane.x)), _mm_set1_ps(plane.w));
+                distance = _mm_add_ps(distance, _mm_mul_ps(cy, _mm_set1_ps(plane.y)));
+                distance = _mm_add_ps(distance, _mm_mul_ps(cz, _mm_set1_ps(plane.z)));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+            }
+
+            const int mask = _mm_movemask_ps(inside);
+            for (size_t j = 0; j < 4; j++)
+            {
+                visible[i + j] = static_cast<uint8_t>((mask >> j) & 1);
+            }
+            visibleCount += static_cast<size_t>(std::popcount(static_cast<unsigned>(mask)));
+        }
+#elif defined(LEARNVULKANRAII_FRUSTUM_NEON)
+        for (; i + 4 <= count; i += 4)
+        {
+            const float32x4_t cx = vld1q_f32(centerX + i);
+            const float32x4_t cy = vld1q_f32(centerY + i);
+            const float32x4_t cz = vld1q_f32(centerZ + i);
+            const float32x4_t negRadius = vnegq_f32(vld1q_f32(radius + i));
+
+            uint32x4_t inside = vdupq_n_u32(UINT32_MAX);
+            for (const auto& plane : planes)
+            {
+                float32x4_t distance = vmlaq_n_f32(vdupq_n_f32(plane.w), cx, plane.x);
+                distance = vmlaq_n_f32(distance, cy, plane.y);
+                distance = vmlaq_n_f32(distance, cz, plane.z);
+                inside = vandq_u32(inside, vcgeq_f32(distance, negRadius));
+            }
+
+            uint32_t lanes[4];
+            vst1q_u32(lanes, vshrq_n_u32(inside, 31));
+            for (size_t j = 0; j < 4; j++)
+            {
+                visible[i + j] = static_cast<uint8_t>(lanes[j]);
+                visibleCount += lanes[j];
+            }
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            visible[i] = intersects(BoundingSphere{ { centerX[i], centerY[i], centerZ[i] }, radius[i] }) ? 1 : 0;
+            visibleCount += visible[i];
+        }
+
+        return visibleCount;
+    }
+} // LearnVulkanRAII
\ No newline at end of file
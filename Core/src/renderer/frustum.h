@@ -0,0 +1,40 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#ifndef LEARNVULKANRAII_FRUSTUM_H
+#define LEARNVULKANRAII_FRUSTUM_H
+
+#include "mesh/mesh.h"
+
+#include <array>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+namespace LearnVulkanRAII
+{
+    // View frustum as six normalized planes (xyz = inward normal, w = distance), in world space
+    struct Frustum
+    {
+        enum Plane { Left = 0, Right, Bottom, Top, Near, Far, PlaneCount };
+
+        std::array<glm::vec4, PlaneCount> planes{};
+
+        // Expects a Vulkan style projection, depth in [0, 1]
+        static Frustum fromViewProjection(const glm::mat4& viewProjection);
+
+        [[nodiscard]] bool intersects(const BoundingSphere& sphere) const;
+
+        // Tests 'count' spheres given as separate component arrays, four (or more) spheres per plane test.
+        // Writes 1 to 'visible' for the spheres touching the frustum, 0 for the others. Returns the visible count
+        size_t cullSpheres(const float* centerX,
+            const float* centerY,
+            const float* centerZ,
+            const float* radius,
+            size_t count,
+            uint8_t* visible) const;
+    };
+} // LearnVulkanRAII
+
+#endif //LEARNVULKANRAII_FRUSTUM_H
\ No newline at end of file
@@ -0,0 +1,627 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#include "gpuculler.h"
+
+#include "renderer/utils/utils.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace LearnVulkanRAII
+{
+    static constexpr uint32_t CullWorkGroupSize = 64;
+    static constexpr uint32_t DepthPyramidWorkGroupSize = 8;
+    // A pyramid's reduce and cull sets plus the depth attachments' sets, for the live and the retired pyramids
+    static constexpr uint32_t MaxDescriptorSetsPerPyramid = 32;
+
+    static vk::Extent2D getMipExtent(const vk::Extent3D& extent, uint32_t mipLevel)
+    {
+        return vk::Extent2D{ std::max(extent.width >> mipLevel, 1u), std::max(extent.height >> mipLevel, 1u) };
+    }
+
+    GpuCuller::GpuCuller(const GraphicsContext::Shared& graphicsContext,
+        const BindlessDescriptorSet::Shared& bindlessDescriptorSet,
+        uint32_t frameSlotCount)
+        : m_graphicsContext(graphicsContext),
+        m_bindlessDescriptorSet(bindlessDescriptorSet),
+        m_frameSlots(frameSlotCount)
+    {
+        init();
+    }
+
+    GpuCuller::~GpuCuller()
+    {
+        for (const auto& slot : m_frameSlots)
+        {
+            m_bindlessDescriptorSet->releaseStorageBuffer(slot.cullParamsBufferIndex);
+            m_bindlessDescriptorSet->releaseStorageBuffer(slot.drawCommandBufferIndex);
+            m_bindlessDescriptorSet->releaseStorageBuffer(slot.drawCountBufferIndex);
+        }
+    }
+
+    void GpuCuller::setOcclusionCullingEnabled(bool enabled)
+    {
+        m_occlusionCullingEnabled = enabled;
+    }
+
+    bool GpuCuller::isOcclusionCullingEnabled() const
+    {
+        return m_occlusionCullingEnabled;
+    }
+
+    void GpuCuller::prepare(uint32_t frameSlot,
+        const Frustum& frustum,
+        bool frustumCullingEnabled,
+        uint32_t drawCount,
+        const Image::Shared& depthImage)
+    {
+        ASSERT(frameSlot < m_frameSlots.size(), "Invalid frame slot!");
+
+        m_frameIndex++;
+        releaseRetiredResources();
+
+        auto& slot = m_frameSlots[frameSlot];
+        ensureFrameSlotCapacity(slot, drawCount);
+
+        // Re-created before anything is recorded, the culling pass of this frame already reads the new pyramid
+        if (depthImage && m_occlusionCullingEnabled)
+        {
+            const auto& depthExtent = depthImage->getSpecification().extent;
+            const auto& pyramidExtent = m_depthPyramid->getSpecification().extent;
+            if (pyramidExtent.width != depthExtent.width || pyramidExtent.height != depthExtent.height)
+                createDepthPyramid(depthExtent);
+
+            getDepthReduceDescriptorSet(depthImage);
+        }
+
+        CullParams params{};
+        std::ranges::copy(frustum.planes, params.frustumPlanes);
+        params.previousViewProjection = m_depthPyramidViewProjection;
+        params.drawCount = drawCount;
+
+        const auto& pyramidExtent = m_depthPyramid->getSpecification().extent;
+        params.depthPyramidSize = glm::vec2(static_cast<float>(pyramidExtent.width), static_cast<float>(pyramidExtent.height));
+
+        if (frustumCullingEnabled)
+            params.flags |= CullFlagFrustum;
+        // Only a pyramid built by the previous frame is tested against, an older one would be stale
+        if (m_occlusionCullingEnabled && m_depthPyramidValid)
+            params.flags |= CullFlagOcclusion;
+        m_depthPyramidValid = false;
+
+        void* data = slot.cullParamsBuffer->map();
+        memcpy(data, &params, sizeof(CullParams));
+        slot.cullParamsBuffer->unmap();
+    }
+
+    void GpuCuller::recordCulling(const vk::raii::CommandBuffer& cb, uint32_t frameSlot, const GpuCullInputs& inputs)
+    {
+        const auto& slot = m_frameSlots[frameSlot];
+
+        if (!m_depthPyramidInitialized)
+        {
+            // The pyramid stays in the general layout, written as a storage image and sampled by the culling pass
+            vk::ImageMemoryBarrier pyramidBarrier{
+                vk::AccessFlagBits::eNone,
+                vk::AccessFlagBits::eShaderRead,
+                vk::ImageLayout::eUndefined,
+                vk::ImageLayout::eGeneral,
+                VK_QUEUE_FAMILY_IGNORED,
+                VK_QUEUE_FAMILY_IGNORED,
+                *m_depthPyramid->getImage(),
+                { vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, 1 }
+            };
+            cb.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                vk::PipelineStageFlagBits::eComputeShader,
+                {}, nullptr, nullptr, pyramidBarrier);
+
+            m_depthPyramidInitialized = true;
+        }
+
+        cb.fillBuffer(*slot.drawCountBuffer->getNativeBuffer(), 0, sizeof(uint32_t), 0);
+
+        vk::MemoryBarrier clearBarrier{
+            vk::AccessFlagBits::eTransferWrite,
+            vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite
+        };
+        cb.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+            vk::PipelineStageFlagBits::eComputeShader,
+            {}, clearBarrier, nullptr, nullptr);
+
+        cb.bindPipeline(vk::PipelineBindPoint::eCompute, **m_cullPipeline);
+
+        std::array descriptorSets{ *m_bindlessDescriptorSet->getDescriptorSet(), **m_cullDescriptorSet };
+        cb.bindDescriptorSets(vk::PipelineBindPoint::eCompute, **m_cullPipelineLayout, 0, descriptorSets, nullptr);
+
+        CullPushConstants pushConstants{
+            slot.cullParamsBufferIndex,
+            inputs.objectMetadataBufferIndex,
+            inputs.drawCommandBufferIndex,
+            inputs.instanceBufferIndex,
+            inputs.boundsBufferIndex,
+            slot.drawCommandBufferIndex,
+            slot.drawCountBufferIndex
+        };
+        cb.pushConstants<CullPushConstants>(**m_cullPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, pushConstants);
+
+        cb.dispatch((inputs.drawCount + CullWorkGroupSize - 1) / CullWorkGroupSize, 1, 1);
+
+        vk::MemoryBarrier cullBarrier{
+            vk::AccessFlagBits::eShaderWrite,
+            vk::AccessFlagBits::eIndirectCommandRead
+        };
+        cb.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+            vk::PipelineStageFlagBits::eDrawIndirect,
+            {}, cullBarrier, nullptr, nullptr);
+    }
+
+    void GpuCuller::recordDepthPyramid(const vk::raii::CommandBuffer& cb,
+        const Image::Shared& depthImage,
+        const glm::mat4& viewProjection)
+    {
+        const auto& depthSpec = depthImage->getSpecification();
+        ASSERT(m_depthPyramid->getSpecification().extent == depthSpec.extent,
+            "Depth pyramid doesn't match the depth attachment, prepare() must see it first!");
+
+        const auto& depthDescriptorSet = getDepthReduceDescriptorSet(depthImage);
+        const auto& pyramidSpec = m_depthPyramid->getSpecification();
+        const vk::ImageSubresourceRange depthRange{ Utils::getDepthBarrierAspect(depthSpec.imageFormat), 0, 1, 0, 1 };
+
+        // Depth writes become visible to the reduction, the last culling pass is done reading the pyramid
+        std::array beginBarriers{
+            vk::ImageMemoryBarrier{
+                vk::AccessFlagBits::eDepthStencilAttachmentWrite,
+                vk::AccessFlagBits::eShaderRead,
+                vk::ImageLayout::eDepthStencilAttachmentOptimal,
+                vk::ImageLayout::eDepthStencilReadOnlyOptimal,
+                VK_QUEUE_FAMILY_IGNORED,
+                VK_QUEUE_FAMILY_IGNORED,
+                *depthImage->getImage(),
+                depthRange
+            },
+            vk::ImageMemoryBarrier{
+                vk::AccessFlagBits::eShaderRead,
+                vk::AccessFlagBits::eShaderWrite,
+                m_depthPyramidInitialized ? vk::ImageLayout::eGeneral : vk::ImageLayout::eUndefined,
+                vk::ImageLayout::eGeneral,
+                VK_QUEUE_FAMILY_IGNORED,
+                VK_QUEUE_FAMILY_IGNORED,
+                *m_depthPyramid->getImage(),
+                { vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, 1 }
+            }
+        };
+        cb.pipelineBarrier(vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests |
+                vk::PipelineStageFlagBits::eComputeShader,
+            vk::PipelineStageFlagBits::eComputeShader,
+            {}, nullptr, nullptr, beginBarriers);
+        m_depthPyramidInitialized = true;
+
+        cb.bindPipeline(vk::PipelineBindPoint::eCompute, **m_reducePipeline);
+
+        for (uint32_t mipLevel = 0; mipLevel < pyramidSpec.mipLevels; mipLevel++)
+        {
+            const auto& descriptorSet = mipLevel == 0 ? depthDescriptorSet : m_pyramidReduceDescriptorSets[mipLevel - 1];
+            const vk::Extent2D sourceExtent = mipLevel == 0
+                ? vk::Extent2D{ depthSpec.extent.width, depthSpec.extent.height }
+                : getMipExtent(pyramidSpec.extent, mipLevel - 1);
+            const vk::Extent2D destinationExtent = getMipExtent(pyramidSpec.extent, mipLevel);
+
+            cb.bindDescriptorSets(vk::PipelineBindPoint::eCompute, **m_reducePipelineLayout, 0, *descriptorSet, nullptr);
+
+            DepthPyramidPushConstants pushConstants{
+                glm::ivec2(sourceExtent.width, sourceExtent.height),
+                glm::ivec2(destinationExtent.width, destinationExtent.height)
+            };
+            cb.pushConstants<DepthPyramidPushConstants>(**m_reducePipelineLayout,
+                vk::ShaderStageFlagBits::eCompute, 0, pushConstants);
+
+            cb.dispatch((destinationExtent.width + DepthPyramidWorkGroupSize - 1) / DepthPyramidWorkGroupSize,
+                (destinationExtent.height + DepthPyramidWorkGroupSize - 1) / DepthPyramidWorkGroupSize,
+                1);
+
+            // The next level (and the next frame's culling pass) reads this one
+            vk::ImageMemoryBarrier levelBarrier{
+                vk::AccessFlagBits::eShaderWrite,
+                vk::AccessFlagBits::eShaderRead,
+                vk::ImageLayout::eGeneral,
+                vk::ImageLayout::eGeneral,
+                VK_QUEUE_FAMILY_IGNORED,
+                VK_QUEUE_FAMILY_IGNORED,
+                *m_depthPyramid->getImage(),
+                { vk::ImageAspectFlagBits::eColor, mipLevel, 1, 0, 1 }
+            };
+            cb.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                vk::PipelineStageFlagBits::eComputeShader,
+                {}, nullptr, nullptr, levelBarrier);
+        }
+
+        // Back to the layout the rendering passes expect
+        vk::ImageMemoryBarrier endBarrier{
+            vk::AccessFlagBits::eShaderRead,
+            vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite,
+            vk::ImageLayout::eDepthStencilReadOnlyOptimal,
+            vk::ImageLayout::eDepthStencilAttachmentOptimal,
+            VK_QUEUE_FAMILY_IGNORED,
+            VK_QUEUE_FAMILY_IGNORED,
+            *depthImage->getImage(),
+            depthRange
+        };
+        cb.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+            vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests,
+            {}, nullptr, nullptr, endBarrier);
+
+        m_depthPyramidValid = true;
+        m_depthPyramidViewProjection = viewProjection;
+    }
+
+    const Buffer::Shared& GpuCuller::getDrawCommandBuffer(uint32_t frameSlot) const
+    {
+        return m_frameSlots[frameSlot].drawCommandBuffer;
+    }
+
+    const Buffer::Shared& GpuCuller::getDrawCountBuffer(uint32_t frameSlot) const
+    {
+        return m_frameSlots[frameSlot].drawCountBuffer;
+    }
+
+    uint64_t GpuCuller::getBufferGeneration() const
+    {
+        return m_bufferGeneration;
+    }
+
+    GpuCuller::Shared GpuCuller::create(const GraphicsContext::Shared& graphicsContext,
+        const BindlessDescriptorSet::Shared& bindlessDescriptorSet,
+        uint32_t frameSlotCount)
+    {
+        return makeShared(graphicsContext, bindlessDescriptorSet, frameSlotCount);
+    }
+
+    void GpuCuller::init()
+    {
+        createSampler();
+        createDescriptorSetLayouts();
+        createDescriptorPool();
+        createPipelines();
+        createFrameSlots();
+
+        auto swapchainExtent = m_graphicsContext->getSwapchainExtent();
+        createDepthPyramid(vk::Extent3D{ swapchainExtent.width, swapchainExtent.height, 1 });
+    }
+
+    void GpuCuller::createSampler()
+    {
+        auto& device = m_graphicsContext->getDevice();
+
+        // Texels are read as they are, the shaders pick the mip level explicitly
+        vk::SamplerCreateInfo samplerCreateInfo{
+            {},
+            vk::Filter::eNearest,
+            vk::Filter::eNearest,
+            vk::SamplerMipmapMode::eNearest,
+            vk::SamplerAddressMode::eClampToEdge,
+            vk::SamplerAddressMode::eClampToEdge,
+            vk::SamplerAddressMode::eClampToEdge,
+            0.0f,
+            VK_FALSE,
+            1.0f,
+            VK_FALSE,
+            vk::CompareOp::eAlways,
+            0.0f,
+            VK_LOD_CLAMP_NONE
+        };
+
+        m_sampler = device.createSampler(samplerCreateInfo);
+    }
+
+    void GpuCuller::createDescriptorSetLayouts()
+    {
+        auto& device = m_graphicsContext->getDevice();
+
+        vk::DescriptorSetLayoutBinding depthPyramidBinding{
+            0,
+            vk::DescriptorType::eCombinedImageSampler,
+            1,
+            vk::ShaderStageFlagBits::eCompute
+        };
+
+        vk::DescriptorSetLayoutCreateInfo cullLayoutCreateInfo{};
+        cullLayoutCreateInfo.setBindings(depthPyramidBinding);
+        m_cullDescriptorSetLayout = device.createDescriptorSetLayout(cullLayoutCreateInfo);
+
+        std::array reduceBindings{
+            vk::DescriptorSetLayoutBinding{ 0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eCompute },
+            vk::DescriptorSetLayoutBinding{ 1, vk::DescriptorType::eStorageImage, 1, vk::ShaderStageFlagBits::eCompute }
+        };
+
+        vk::DescriptorSetLayoutCreateInfo reduceLayoutCreateInfo{};
+        reduceLayoutCreateInfo.setBindings(reduceBindings);
+        m_reduceDescriptorSetLayout = device.createDescriptorSetLayout(reduceLayoutCreateInfo);
+    }
+
+    void GpuCuller::createDescriptorPool()
+    {
+        auto& device = m_graphicsContext->getDevice();
+
+        // One cull set, one reduce set per pyramid level and per depth attachment in use.
+        // Every frame slot may hold on to a retired pyramid's sets besides the live ones
+        const uint32_t maxDescriptorSets = MaxDescriptorSetsPerPyramid * (static_cast<uint32_t>(m_frameSlots.size()) + 1);
+        std::array poolSizes{
+            vk::DescriptorPoolSize{ vk::DescriptorType::eCombinedImageSampler, maxDescriptorSets },
+            vk::DescriptorPoolSize{ vk::DescriptorType::eStorageImage, maxDescriptorSets }
+        };
+
+        vk::DescriptorPoolCreateInfo descriptorPoolCreateInfo{
+            vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
+            maxDescriptorSets
+        };
+        descriptorPoolCreateInfo.setPoolSizes(poolSizes);
+
+        m_descriptorPool = device.createDescriptorPool(descriptorPoolCreateInfo);
+    }
+
+    void GpuCuller::createPipelines()
+    {
+        auto& device = m_graphicsContext->getDevice();
+
+        const std::string cullGlslSrc = Utils::readFile("Core/resources/shaders/culling.compute.glsl");
+        const std::string reduceGlslSrc = Utils::readFile("Core/resources/shaders/depthpyramid.compute.glsl");
+
+        vk::raii::ShaderModule cullShaderModule = Utils::createShaderModule(device,
+            vk::ShaderStageFlagBits::eCompute,
+            cullGlslSrc);
+        vk::raii::ShaderModule reduceShaderModule = Utils::createShaderModule(device,
+            vk::ShaderStageFlagBits::eCompute,
+            reduceGlslSrc);
+
+        // Culling: bindless records in set 0, the depth pyramid in set 1
+        vk::PushConstantRange cullPushConstantRange{
+            vk::ShaderStageFlagBits::eCompute,
+            0,
+            sizeof(CullPushConstants)
+        };
+
+        std::array cullSetLayouts{ *m_bindlessDescriptorSet->getLayout(), **m_cullDescriptorSetLayout };
+        vk::PipelineLayoutCreateInfo cullPipelineLayoutInfo{};
+        cullPipelineLayoutInfo.setSetLayouts(cullSetLayouts);
+        cullPipelineLayoutInfo.setPushConstantRanges(cullPushConstantRange);
+
+        m_cullPipelineLayout = device.createPipelineLayout(cullPipelineLayoutInfo);
+
+        vk::ComputePipelineCreateInfo cullPipelineCreateInfo{
+            {},
+            vk::PipelineShaderStageCreateInfo{ {}, vk::ShaderStageFlagBits::eCompute, cullShaderModule, "main" },
+            **m_cullPipelineLayout
+        };
+        m_cullPipeline = device.createComputePipeline(VK_NULL_HANDLE, cullPipelineCreateInfo);
+
+        // Depth pyramid reduction, one dispatch per level
+        vk::PushConstantRange reducePushConstantRange{
+            vk::ShaderStageFlagBits::eCompute,
+            0,
+            sizeof(DepthPyramidPushConstants)
+        };
+
+        vk::PipelineLayoutCreateInfo reducePipelineLayoutInfo{};
+        reducePipelineLayoutInfo.setSetLayouts(**m_reduceDescriptorSetLayout);
+        reducePipelineLayoutInfo.setPushConstantRanges(reducePushConstantRange);
+
+        m_reducePipelineLayout = device.createPipelineLayout(reducePipelineLayoutInfo);
+
+        vk::ComputePipelineCreateInfo reducePipelineCreateInfo{
+            {},
+            vk::PipelineShaderStageCreateInfo{ {}, vk::ShaderStageFlagBits::eCompute, reduceShaderModule, "main" },
+            **m_reducePipelineLayout
+        };
+        m_reducePipeline = device.createComputePipeline(VK_NULL_HANDLE, reducePipelineCreateInfo);
+    }
+
+    void GpuCuller::createFrameSlots()
+    {
+        for (auto& slot : m_frameSlots)
+        {
+            slot.cullParamsBuffer = Buffer::create(
+                m_graphicsContext,
+                sizeof(CullParams),
+                vk::BufferUsageFlagBits::eStorageBuffer,
+                vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+            slot.cullParamsBufferIndex = m_bindlessDescriptorSet->registerStorageBuffer(slot.cullParamsBuffer);
+
+            // Only ever touched by the GPU: cleared, counted up by the culling pass, read by the draw
+            slot.drawCountBuffer = Buffer::create(
+                m_graphicsContext,
+                sizeof(uint32_t),
+                vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer |
+                    vk::BufferUsageFlagBits::eTransferDst,
+                vk::MemoryPropertyFlagBits::eDeviceLocal);
+            slot.drawCountBufferIndex = m_bindlessDescriptorSet->registerStorageBuffer(slot.drawCountBuffer);
+
+            ensureFrameSlotCapacity(slot, 1024);
+        }
+    }
+
+    void GpuCuller::ensureFrameSlotCapacity(FrameSlot& slot, uint32_t drawCount)
+    {
+        if (slot.capacity >= drawCount)
+            return;
+
+        uint32_t newCapacity = std::max(slot.capacity, 1u);
+        while (newCapacity < drawCount)
+            newCapacity *= 2;
+
+        slot.drawCommandBuffer = Buffer::create(
+            m_graphicsContext,
+            static_cast<vk::DeviceSize>(newCapacity) * sizeof(vk::DrawIndexedIndirectCommand),
+            vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer,
+            vk::MemoryPropertyFlagBits::eDeviceLocal);
+        slot.capacity = newCapacity;
+        m_bufferGeneration++;
+
+        if (slot.drawCommandBufferIndex == BindlessDescriptorSet::InvalidIndex)
+            slot.drawCommandBufferIndex = m_bindlessDescriptorSet->registerStorageBuffer(slot.drawCommandBuffer);
+        else
+            m_bindlessDescriptorSet->updateStorageBuffer(slot.drawCommandBufferIndex, slot.drawCommandBuffer);
+    }
+
+    void GpuCuller::createDepthPyramid(const vk::Extent3D& depthExtent)
+    {
+        auto& device = m_graphicsContext->getDevice();
+
+        // Only on resize, frames in flight may still sample the old pyramid or run its reduce passes
+        if (m_depthPyramid)
+        {
+            RetiredDepthPyramid retired{ std::move(m_depthPyramid), std::move(m_pyramidReduceDescriptorSets) };
+            retired.descriptorSets.push_back(std::move(*m_cullDescriptorSet));
+            for (auto& [image, source] : m_depthSources)
+            {
+                retired.descriptorSets.push_back(std::move(source.descriptorSet));
+            }
+            retired.framesLeft = static_cast<uint32_t>(m_frameSlots.size());
+            m_retiredDepthPyramids.push_back(std::move(retired));
+        }
+
+        m_depthSources.clear();
+        m_pyramidReduceDescriptorSets.clear();
+        m_cullDescriptorSet.reset();
+
+        // Level 0 matches the depth attachment, every level halves down to 1x1
+        const uint32_t mipLevels = std::bit_width(std::max(depthExtent.width, depthExtent.height));
+
+        ImageSpecification pyramidSpec{
+            vk::Format::eR32Sfloat,
+            vk::Extent3D{ depthExtent.width, depthExtent.height, 1 },
+            vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eStorage,
+            vk::ImageAspectFlagBits::eColor
+        };
+        pyramidSpec.mipLevels = mipLevels;
+
+        m_depthPyramid = Image::makeShared(m_graphicsContext, pyramidSpec);
+        m_depthPyramidInitialized = false;
+        m_depthPyramidValid = false;
+
+        ASSERT(mipLevels + 1 < MaxDescriptorSetsPerPyramid, "Depth pyramid has too many levels for the descriptor pool!");
+
+        for (uint32_t mipLevel = 1; mipLevel < mipLevels; mipLevel++)
+        {
+            m_pyramidReduceDescriptorSets.push_back(allocateReduceDescriptorSet(
+                m_depthPyramid->getMipImageView(mipLevel - 1),
+                vk::ImageLayout::eGeneral,
+                m_depthPyramid->getMipImageView(mipLevel)));
+        }
+
+        vk::DescriptorSetLayout cullDescriptorSetLayout = **m_cullDescriptorSetLayout;
+        vk::DescriptorSetAllocateInfo allocateInfo{
+            **m_descriptorPool,
+            1,
+            &cullDescriptorSetLayout
+        };
+
+        auto descriptorSets = device.allocateDescriptorSets(allocateInfo);
+        ASSERT(descriptorSets.size(), "Failed to allocate culling descriptor set!");
+        m_cullDescriptorSet = std::move(descriptorSets.front());
+
+        vk::DescriptorImageInfo pyramidImageInfo{
+            **m_sampler,
+            *m_depthPyramid->getImageView(),
+            vk::ImageLayout::eGeneral
+        };
+
+        vk::WriteDescriptorSet writeDescriptorSet{
+            **m_cullDescriptorSet,
+            0,
+            0,
+            1,
+            vk::DescriptorType::eCombinedImageSampler,
+            &pyramidImageInfo
+        };
+
+        device.updateDescriptorSets(writeDescriptorSet, nullptr);
+    }
+
+    vk::raii::DescriptorSet GpuCuller::allocateReduceDescriptorSet(const vk::raii::ImageView& source,
+        vk::ImageLayout sourceLayout,
+        const vk::raii::ImageView& destination) const
+    {
+        auto& device = m_graphicsContext->getDevice();
+
+        vk::DescriptorSetLayout reduceDescriptorSetLayout = **m_reduceDescriptorSetLayout;
+        vk::DescriptorSetAllocateInfo allocateInfo{
+            **m_descriptorPool,
+            1,
+            &reduceDescriptorSetLayout
+        };
+
+        auto descriptorSets = device.allocateDescriptorSets(allocateInfo);
+        ASSERT(descriptorSets.size(), "Failed to allocate depth pyramid descriptor set!");
+        vk::raii::DescriptorSet descriptorSet = std::move(descriptorSets.front());
+
+        vk::DescriptorImageInfo sourceImageInfo{ **m_sampler, *source, sourceLayout };
+        vk::DescriptorImageInfo destinationImageInfo{ nullptr, *destination, vk::ImageLayout::eGeneral };
+
+        std::array writeDescriptorSets{
+            vk::WriteDescriptorSet{ *descriptorSet, 0, 0, 1, vk::DescriptorType::eCombinedImageSampler, &sourceImageInfo },
+            vk::WriteDescriptorSet{ *descriptorSet, 1, 0, 1, vk::DescriptorType::eStorageImage, &destinationImageInfo }
+        };
+
+        device.updateDescriptorSets(writeDescriptorSets, nullptr);
+        return descriptorSet;
+    }
+
+    const vk::raii::DescriptorSet& GpuCuller::getDepthReduceDescriptorSet(const Image::Shared& depthImage)
+    {
+        ASSERT(depthImage->getSpecification().usageFlags & vk::ImageUsageFlagBits::eSampled,
+            "Depth attachment must be created with sampled usage for the depth pyramid!");
+
+        const VkImageView imageView = *depthImage->getImageView();
+
+        auto it = m_depthSources.find(depthImage.get());
+        if (it != m_depthSources.end())
+        {
+            if (it->second.imageView == imageView)
+            {
+                it->second.lastUsedFrame = m_frameIndex;
+                return it->second.descriptorSet;
+            }
+
+            // The attachment was re-created, the old set may still be in use by a frame in flight
+            retireDescriptorSet(std::move(it->second.descriptorSet));
+            m_depthSources.erase(it);
+        }
+
+        auto descriptorSet = allocateReduceDescriptorSet(depthImage->getImageView(),
+            vk::ImageLayout::eDepthStencilReadOnlyOptimal,
+            m_depthPyramid->getMipImageView(0));
+
+        auto [inserted, _] = m_depthSources.emplace(depthImage.get(),
+            DepthSource{ imageView, std::move(descriptorSet), m_frameIndex });
+        return inserted->second.descriptorSet;
+    }
+
+    void GpuCuller::retireDescriptorSet(vk::raii::DescriptorSet&& descriptorSet)
+    {
+        RetiredDepthPyramid retired{};
+        retired.descriptorSets.push_back(std::move(descriptorSet));
+        retired.framesLeft = static_cast<uint32_t>(m_frameSlots.size());
+        m_retiredDepthPyramids.push_back(std::move(retired));
+    }
+
+    void GpuCuller::releaseRetiredResources()
+    {
+        for (auto& retired : m_retiredDepthPyramids)
+        {
+            if (retired.framesLeft > 0)
+                retired.framesLeft--;
+        }
+
+        std::erase_if(m_retiredDepthPyramids, [](const RetiredDepthPyramid& retired) { return retired.framesLeft == 0; });
+
+        // Every frame slot came around without using them, their framebuffers are gone.
+        // Only frames calling prepare() read the sets, so no frame in flight can still use them
+        const uint64_t frameSlotCount = m_frameSlots.size();
+        std::erase_if(m_depthSources, [&](const auto& entry) {
+            return entry.second.lastUsedFrame + frameSlotCount <= m_frameIndex;
+        });
+    }
+} // LearnVulkanRAII
\ No newline at end of file
@@ -0,0 +1,193 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#ifndef LEARNVULKANRAII_GPUCULLER_H
+#define LEARNVULKANRAII_GPUCULLER_H
+
+#include "base/utils.h"
+#include "base/graphicscontext.h"
+
+#include "buffer.h"
+#include "image.h"
+#include "bindlessdescriptorset.h"
+#include "frustum.h"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+namespace LearnVulkanRAII
+{
+    // Bindless slots the culling pass reads from, all of them for the same frame slot
+    struct GpuCullInputs
+    {
+        uint32_t objectMetadataBufferIndex = BindlessDescriptorSet::InvalidIndex;
+        uint32_t drawCommandBufferIndex = BindlessDescriptorSet::InvalidIndex;
+        uint32_t instanceBufferIndex = BindlessDescriptorSet::InvalidIndex;
+        uint32_t boundsBufferIndex = BindlessDescriptorSet::InvalidIndex;
+        uint32_t drawCount = 0;
+    };
+
+    // Compute pre-pass over the retained draw commands.
+    // Every command is tested against the frustum and, when a depth pyramid (Hi-Z) of the previous frame exists,
+    // against the max depth it covers. The survivors are appended to a compacted draw command buffer next to
+    // a GPU written draw count, which the draw consumes with drawIndexedIndirectCount.
+    // The pyramid is rebuilt from the depth attachment at the end of every frame, for the next one.
+    class GpuCuller
+    {
+    public:
+        DEFINE_SMART_POINTER_HELPERS(GpuCuller)
+
+    public:
+        GpuCuller(const GraphicsContext::Shared& graphicsContext,
+            const BindlessDescriptorSet::Shared& bindlessDescriptorSet,
+            uint32_t frameSlotCount);
+        ~GpuCuller();
+
+        void setOcclusionCullingEnabled(bool enabled);
+        [[nodiscard]] bool isOcclusionCullingEnabled() const;
+
+        // Grows the frame slot's output buffers, follows the depth attachment's extent and uploads the
+        // culling parameters. Called once per frame, the caller must make sure the GPU is done with the slot.
+        // Replaced pyramids and descriptor sets are kept until every frame slot came around, nothing waits idle.
+        // Occlusion culling is skipped without a depth attachment owned by the framebuffer
+        void prepare(uint32_t frameSlot,
+            const Frustum& frustum,
+            bool frustumCullingEnabled,
+            uint32_t drawCount,
+            const Image::Shared& depthImage);
+
+        // Must be recorded outside of a render pass, before the draw consuming the output
+        void recordCulling(const vk::raii::CommandBuffer& cb, uint32_t frameSlot, const GpuCullInputs& inputs);
+        // Must be recorded outside of a render pass, after the last pass writing the depth attachment given to prepare().
+        // The depth image is expected in the depth attachment layout and is left there
+        void recordDepthPyramid(const vk::raii::CommandBuffer& cb,
+            const Image::Shared& depthImage,
+            const glm::mat4& viewProjection);
+
+        [[nodiscard]] const Buffer::Shared& getDrawCommandBuffer(uint32_t frameSlot) const;
+        [[nodiscard]] const Buffer::Shared& getDrawCountBuffer(uint32_t frameSlot) const;
+        // Bumped whenever an output buffer is re-created, a destroyed buffer's handle value may come back
+        [[nodiscard]] uint64_t getBufferGeneration() const;
+
+        static Shared create(const GraphicsContext::Shared& graphicsContext,
+            const BindlessDescriptorSet::Shared& bindlessDescriptorSet,
+            uint32_t frameSlotCount);
+
+    private:
+        // Matches CullParamsBuffer of culling.compute.glsl (std430)
+        struct CullParams
+        {
+            glm::vec4 frustumPlanes[Frustum::PlaneCount];
+            glm::mat4 previousViewProjection = glm::mat4(1.0f);
+            glm::vec2 depthPyramidSize = glm::vec2(0.0f);
+            uint32_t drawCount = 0;
+            uint32_t flags = 0;
+        };
+        static_assert(sizeof(CullParams) == 176, "CullParams must match the std430 shader layout!");
+
+        static constexpr uint32_t CullFlagFrustum = 1u << 0;
+        static constexpr uint32_t CullFlagOcclusion = 1u << 1;
+
+        struct CullPushConstants
+        {
+            uint32_t cullParamsBufferIndex;
+            uint32_t objectMetadataBufferIndex;
+            uint32_t drawCommandBufferIndex;
+            uint32_t instanceBufferIndex;
+            uint32_t boundsBufferIndex;
+            uint32_t visibleDrawCommandBufferIndex;
+            uint32_t drawCountBufferIndex;
+        };
+
+        struct DepthPyramidPushConstants
+        {
+            glm::ivec2 sourceSize;
+            glm::ivec2 destinationSize;
+        };
+
+        // Level 0 of the pyramid reads a depth attachment, a resized attachment gets a new view
+        struct DepthSource
+        {
+            VkImageView imageView = VK_NULL_HANDLE;
+            vk::raii::DescriptorSet descriptorSet;
+            // prepare() call that last used it, attachments of retired framebuffers stop showing up
+            uint64_t lastUsedFrame = 0;
+        };
+
+        // Frames in flight may still read them, released after every frame slot came around
+        struct RetiredDepthPyramid
+        {
+            Image::Shared depthPyramid;
+            std::vector<vk::raii::DescriptorSet> descriptorSets;
+            uint32_t framesLeft = 0;
+        };
+
+        struct FrameSlot
+        {
+            Buffer::Shared cullParamsBuffer;
+            Buffer::Shared drawCommandBuffer;
+            Buffer::Shared drawCountBuffer;
+            uint32_t cullParamsBufferIndex = BindlessDescriptorSet::InvalidIndex;
+            uint32_t drawCommandBufferIndex = BindlessDescriptorSet::InvalidIndex;
+            uint32_t drawCountBufferIndex = BindlessDescriptorSet::InvalidIndex;
+            uint32_t capacity = 0;
+        };
+
+    private:
+        void init();
+
+        void createSampler();
+        void createDescriptorSetLayouts();
+        void createDescriptorPool();
+        void createPipelines();
+        void createFrameSlots();
+
+        void ensureFrameSlotCapacity(FrameSlot& slot, uint32_t drawCount);
+        // Re-creates the pyramid (and the descriptor sets pointing at it) for a new depth extent
+        void createDepthPyramid(const vk::Extent3D& depthExtent);
+        vk::raii::DescriptorSet allocateReduceDescriptorSet(const vk::raii::ImageView& source,
+            vk::ImageLayout sourceLayout,
+            const vk::raii::ImageView& destination) const;
+        const vk::raii::DescriptorSet& getDepthReduceDescriptorSet(const Image::Shared& depthImage);
+        void retireDescriptorSet(vk::raii::DescriptorSet&& descriptorSet);
+        // Once per prepare(), after the frame slot's fence wait
+        void releaseRetiredResources();
+
+    private:
+        GraphicsContext::Shared m_graphicsContext;
+        BindlessDescriptorSet::Shared m_bindlessDescriptorSet;
+
+        Utils::Optional<vk::raii::Sampler> m_sampler;
+        Utils::Optional<vk::raii::DescriptorSetLayout> m_cullDescriptorSetLayout;
+        Utils::Optional<vk::raii::DescriptorSetLayout> m_reduceDescriptorSetLayout;
+        Utils::Optional<vk::raii::DescriptorPool> m_descriptorPool;
+        Utils::Optional<vk::raii::PipelineLayout> m_cullPipelineLayout;
+        Utils::Optional<vk::raii::PipelineLayout> m_reducePipelineLayout;
+        Utils::Optional<vk::raii::Pipeline> m_cullPipeline;
+        Utils::Optional<vk::raii::Pipeline> m_reducePipeline;
+
+        std::vector<FrameSlot> m_frameSlots;
+        uint64_t m_bufferGeneration = 0;
+
+        // Single pyramid, consecutive frames are ordered by the barriers on the graphics queue
+        Image::Shared m_depthPyramid;
+        Utils::Optional<vk::raii::DescriptorSet> m_cullDescriptorSet;
+        // Level i reads level i - 1 (index i - 1), level 0 reads the depth attachment (one set per depth image)
+        std::vector<vk::raii::DescriptorSet> m_pyramidReduceDescriptorSets;
+        std::unordered_map<const Image*, DepthSource> m_depthSources;
+        std::vector<RetiredDepthPyramid> m_retiredDepthPyramids;
+        uint64_t m_frameIndex = 0;
+
+        bool m_depthPyramidInitialized = false;
+        // Built since the last prepare(), i.e. by the previous frame
+        bool m_depthPyramidValid = false;
+        glm::mat4 m_depthPyramidViewProjection = glm::mat4(1.0f);
+
+        bool m_occlusionCullingEnabled = true;
+    };
+} // LearnVulkanRAII
+
+#endif //LEARNVULKANRAII_GPUCULLER_H
\ No newline at end of file
@@ -33,11 +33,22 @@ namespace LearnVulkanRAII
         return *m_imageView;
     }
 
+    const vk::raii::ImageView& Image::getMipImageView(uint32_t mipLevel) const
+    {
+        ASSERT(mipLevel < m_mipImageViews.size(), "Invalid mip level!");
+        return m_mipImageViews[mipLevel];
+    }
+
     const vk::raii::DeviceMemory& Image::getDeviceMemory() const
     {
         return *m_deviceMemory;
     }
 
+    const ImageSpecification& Image::getSpecification() const
+    {
+        return m_spec;
+    }
+
     void Image::init()
     {
         auto& device = m_graphicsContext->getDevice();
@@ -47,7 +58,7 @@ namespace LearnVulkanRAII
             m_spec.imageType,
             m_spec.imageFormat,
             m_spec.extent,
-            1, 1,
+            m_spec.mipLevels, 1,
             vk::SampleCountFlagBits::e1,
             m_spec.tiling,
             m_spec.usageFlags,
@@ -83,9 +94,20 @@ namespace LearnVulkanRAII
             m_spec.imageViewType,
             m_spec.imageFormat,
             {},
-            {m_spec.aspectFlags, 0, 1, 0, 1}
+            {m_spec.aspectFlags, 0, m_spec.mipLevels, 0, 1}
         };
 
         m_imageView = device.createImageView(viewCreateInfo);
+
+        m_mipImageViews.clear();
+        if (m_spec.mipLevels > 1)
+        {
+            m_mipImageViews.reserve(m_spec.mipLevels);
+            for (uint32_t mipLevel = 0; mipLevel < m_spec.mipLevels; mipLevel++)
+            {
+                viewCreateInfo.subresourceRange = vk::ImageSubresourceRange{ m_spec.aspectFlags, mipLevel, 1, 0, 1 };
+                m_mipImageViews.push_back(device.createImageView(viewCreateInfo));
+            }
+        }
     }
 } // LearnVulkanRAII
\ No newline at end of file
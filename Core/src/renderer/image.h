@@ -8,6 +8,8 @@
 #include "base/utils.h"
 #include "base/graphicscontext.h"
 
+#include <vector>
+
 namespace LearnVulkanRAII
 {
     struct ImageSpecification
@@ -21,6 +23,7 @@ namespace LearnVulkanRAII
         vk::SharingMode sharingMode = vk::SharingMode::eExclusive;
         vk::ImageTiling tiling = vk::ImageTiling::eOptimal;
         vk::ImageLayout finalLayout = vk::ImageLayout::eUndefined;
+        uint32_t mipLevels = 1;
     };
 
     class Image
@@ -35,7 +38,10 @@ namespace LearnVulkanRAII
 
         const vk::raii::Image& getImage() const;
         const vk::raii::ImageView& getImageView() const;
+        // Single mip view, only available when the image has more than one mip level
+        const vk::raii::ImageView& getMipImageView(uint32_t mipLevel) const;
         const vk::raii::DeviceMemory& getDeviceMemory() const;
+        const ImageSpecification& getSpecification() const;
 
     private:
         void init();
@@ -47,6 +53,7 @@ namespace LearnVulkanRAII
         Utils::Optional<vk::raii::Image> m_image;
         Utils::Optional<vk::raii::DeviceMemory> m_deviceMemory;
         Utils::Optional<vk::raii::ImageView> m_imageView;
+        std::vector<vk::raii::ImageView> m_mipImageViews;
     };
 } // LearnVulkanRAII
 
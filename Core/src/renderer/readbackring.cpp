@@ -0,0 +1,261 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#include "readbackring.h"
+
+#include <algorithm>
+
+namespace LearnVulkanRAII
+{
+    ReadbackRing::ReadbackRing(const GraphicsContext::Shared& graphicsContext, uint32_t frameSlotCount)
+        : m_graphicsContext(graphicsContext),
+        m_frameSlotCount(frameSlotCount)
+    {
+        init();
+    }
+
+    void ReadbackRing::setCallback(const ReadbackCallback& callback)
+    {
+        m_callback = callback;
+    }
+
+    bool ReadbackRing::isEnabled() const
+    {
+        return static_cast<bool>(m_callback);
+    }
+
+    void ReadbackRing::setColorReadbackEnabled(bool enabled)
+    {
+        m_colorReadbackEnabled = enabled;
+    }
+
+    bool ReadbackRing::isColorReadbackEnabled() const
+    {
+        return m_colorReadbackEnabled;
+    }
+
+    void ReadbackRing::setDepthReadbackEnabled(bool enabled)
+    {
+        m_depthReadbackEnabled = enabled;
+    }
+
+    bool ReadbackRing::isDepthReadbackEnabled() const
+    {
+        return m_depthReadbackEnabled;
+    }
+
+    void ReadbackRing::collect(uint32_t frameSlot)
+    {
+        auto& slot = m_slots[frameSlot];
+        if (!slot.pending)
+            return;
+
+        slot.pending = false;
+
+        // Dropped when the callback went away in the meantime
+        if (!m_callback)
+            return;
+
+        ReadbackFrame frame{};
+        frame.frameNumber = slot.frameNumber;
+
+        if (slot.copiesColor)
+        {
+            frame.extent = slot.color.extent;
+            frame.colorFormat = slot.color.format;
+            frame.colorSize = slot.color.size;
+            frame.colorData = slot.color.buffer->map(slot.color.size, 0);
+            slot.color.buffer->invalidate();
+        }
+
+        if (slot.copiesDepth)
+        {
+            frame.extent = slot.depth.extent;
+            frame.depthFormat = slot.depth.format;
+            frame.depthSize = slot.depth.size;
+            frame.depthData = slot.depth.buffer->map(slot.depth.size, 0);
+            slot.depth.buffer->invalidate();
+        }
+
+        m_callback(frame);
+
+        if (slot.copiesColor)
+            slot.color.buffer->unmap();
+        if (slot.copiesDepth)
+            slot.depth.buffer->unmap();
+    }
+
+    void ReadbackRing::addReadbackPass(RenderGraph& graph,
+        uint32_t frameSlot,
+        RenderGraphResource colorAttachment,
+        RenderGraphResource depthAttachment)
+    {
+        auto& slot = m_slots[frameSlot];
+        ASSERT(!slot.pending, "The frame slot's previous readback hasn't been collected!");
+
+        slot.copiesColor = m_colorReadbackEnabled && colorAttachment != RenderGraph::InvalidResource &&
+            prepareTarget(slot.color,
+                graph.getImageInfo(colorAttachment),
+                graph.getImageExtent(colorAttachment),
+                vk::ImageAspectFlagBits::eColor);
+        slot.copiesDepth = m_depthReadbackEnabled && depthAttachment != RenderGraph::InvalidResource &&
+            prepareTarget(slot.depth,
+                graph.getImageInfo(depthAttachment),
+                graph.getImageExtent(depthAttachment),
+                vk::ImageAspectFlagBits::eDepth);
+
+        if (!slot.copiesColor && !slot.copiesDepth)
+            return;
+
+        slot.frameNumber = m_nextFrameNumber++;
+        slot.pending = true;
+
+        // The host reads the buffers once the fence signaled, the final barrier makes the copies visible to it.
+        // Host reads of the previous copy finished before this submission, the copy doesn't wait on anything
+        const auto hostRead = RenderGraphResourceState::fromAccess(RenderGraphAccess::HostRead);
+
+        std::vector<ReadbackCopy> copies;
+        if (slot.copiesColor)
+        {
+            copies.push_back(ReadbackCopy{
+                colorAttachment,
+                graph.importBuffer("ReadbackColor", slot.color.buffer, {}, hostRead),
+                vk::ImageAspectFlagBits::eColor,
+                slot.color.extent
+            });
+        }
+        if (slot.copiesDepth)
+        {
+            copies.push_back(ReadbackCopy{
+                depthAttachment,
+                graph.importBuffer("ReadbackDepth", slot.depth.buffer, {}, hostRead),
+                vk::ImageAspectFlagBits::eDepth,
+                slot.depth.extent
+            });
+        }
+
+        graph.addPass("Readback",
+            [&copies](RenderGraph::PassBuilder& builder) {
+                for (const auto& copy : copies)
+                {
+                    builder.read(copy.image, RenderGraphAccess::TransferRead);
+                    builder.write(copy.buffer, RenderGraphAccess::TransferWrite);
+                }
+            },
+            [copies](const vk::raii::CommandBuffer& cb, const RenderGraph& graph) {
+                for (const auto& copy : copies)
+                {
+                    vk::BufferImageCopy region{
+                        0,
+                        0, // tightly packed
+                        0,
+                        { copy.aspect, 0, 0, 1 },
+                        { 0, 0, 0 },
+                        { copy.extent.width, copy.extent.height, 1 }
+                    };
+
+                    cb.copyImageToBuffer(graph.getImage(copy.image),
+                        vk::ImageLayout::eTransferSrcOptimal,
+                        graph.getBuffer(copy.buffer),
+                        region);
+                }
+            });
+    }
+
+    uint32_t ReadbackRing::getPendingCount() const
+    {
+        return static_cast<uint32_t>(std::ranges::count_if(m_slots, [](const ReadbackSlot& slot) { return slot.pending; }));
+    }
+
+    ReadbackRing::Shared ReadbackRing::create(const GraphicsContext::Shared& graphicsContext, uint32_t frameSlotCount)
+    {
+        return makeShared(graphicsContext, frameSlotCount);
+    }
+
+    void ReadbackRing::init()
+    {
+        m_slots.resize(m_frameSlotCount);
+
+        // Cached memory makes the host reads fast, it usually isn't coherent (see Buffer::invalidate)
+        m_memoryPropertyFlags = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+
+        auto memProperties = m_graphicsContext->getPhysicalDevice().getMemoryProperties();
+        const vk::MemoryPropertyFlags cached = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCached;
+        for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
+        {
+            if ((memProperties.memoryTypes[i].propertyFlags & cached) == cached)
+            {
+                m_memoryPropertyFlags = cached;
+                break;
+            }
+        }
+    }
+
+    bool ReadbackRing::prepareTarget(ReadbackTarget& target,
+        const FramebufferAttachmentInfo& info,
+        vk::Extent2D extent,
+        vk::ImageAspectFlags aspect) const
+    {
+        if (!(info.usageFlags & vk::ImageUsageFlagBits::eTransferSrc))
+            return false;
+
+        const size_t texelSize = getTexelSize(info.format, aspect);
+        if (texelSize == 0)
+            return false;
+
+        target.format = info.format;
+        target.extent = extent;
+        target.size = static_cast<size_t>(extent.width) * extent.height * texelSize;
+
+        // The slot's previous copy has been collected, its buffer is free to replace
+        if (!target.buffer || target.buffer->getSize() < target.size)
+        {
+            target.buffer = Buffer::create(m_graphicsContext,
+                target.size,
+                vk::BufferUsageFlagBits::eTransferDst,
+                m_memoryPropertyFlags);
+        }
+
+        return true;
+    }
+
+    size_t ReadbackRing::getTexelSize(vk::Format format, vk::ImageAspectFlags aspect)
+    {
+        if (aspect & vk::ImageAspectFlagBits::eDepth)
+        {
+            switch (format)
+            {
+            case vk::Format::eD16Unorm:
+            case vk::Format::eD16UnormS8Uint:
+                return 2;
+            case vk::Format::eD24UnormS8Uint:
+            case vk::Format::eX8D24UnormPack32:
+            case vk::Format::eD32Sfloat:
+            case vk::Format::eD32SfloatS8Uint:
+                return 4;
+            default:
+                return 0;
+            }
+        }
+
+        switch (format)
+        {
+        case vk::Format::eR8G8B8A8Unorm:
+        case vk::Format::eR8G8B8A8Srgb:
+        case vk::Format::eB8G8R8A8Unorm:
+        case vk::Format::eB8G8R8A8Srgb:
+        case vk::Format::eA2B10G10R10UnormPack32:
+        case vk::Format::eR32Uint:
+        case vk::Format::eR32Sfloat:
+            return 4;
+        case vk::Format::eR16G16B16A16Sfloat:
+            return 8;
+        case vk::Format::eR32G32B32A32Sfloat:
+            return 16;
+        default:
+            ASSERT(false, "Unsupported readback format!");
+            return 0;
+        }
+    }
+} // LearnVulkanRAII
\ No newline at end of file
@@ -0,0 +1,128 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#ifndef LEARNVULKANRAII_READBACKRING_H
+#define LEARNVULKANRAII_READBACKRING_H
+
+#include "base/utils.h"
+#include "base/graphicscontext.h"
+
+#include "buffer.h"
+#include "rendergraph.h"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace LearnVulkanRAII
+{
+    // Tightly packed texels of a finished frame, only valid during the callback.
+    // Depth holds the depth aspect alone (4 bytes per texel for the 24 and 32 bit formats)
+    struct ReadbackFrame
+    {
+        uint64_t frameNumber = 0;
+        vk::Extent2D extent{};
+
+        vk::Format colorFormat = vk::Format::eUndefined;
+        const void* colorData = nullptr;
+        size_t colorSize = 0;
+
+        vk::Format depthFormat = vk::Format::eUndefined;
+        const void* depthData = nullptr;
+        size_t depthSize = 0;
+    };
+
+    using ReadbackCallback = std::function<void(const ReadbackFrame&)>;
+
+    // Copies the final attachments of a frame into host cached buffers, one set per frame slot.
+    // A copy is handed to the callback when its frame slot comes around again, after the renderer waited on the
+    // slot's fence anyway, so frames arrive frameSlotCount frames late and the render loop never waits for them.
+    // Attachments need the transfer source usage to be copied, swapchain images don't have it
+    class ReadbackRing
+    {
+    public:
+        DEFINE_SMART_POINTER_HELPERS(ReadbackRing)
+
+    public:
+        ReadbackRing(const GraphicsContext::Shared& graphicsContext, uint32_t frameSlotCount);
+
+        // Readback is enabled while a callback is set
+        void setCallback(const ReadbackCallback& callback);
+        [[nodiscard]] bool isEnabled() const;
+
+        void setColorReadbackEnabled(bool enabled);
+        [[nodiscard]] bool isColorReadbackEnabled() const;
+        void setDepthReadbackEnabled(bool enabled);
+        [[nodiscard]] bool isDepthReadbackEnabled() const;
+
+        // Hands the frame slot's finished copy to the callback.
+        // Called once per frame, after the slot's fence has been waited on and before addReadbackPass()
+        void collect(uint32_t frameSlot);
+
+        // Adds a pass copying the attachments into the frame slot's buffers, after every pass writing them.
+        // Either attachment may be RenderGraph::InvalidResource
+        void addReadbackPass(RenderGraph& graph,
+            uint32_t frameSlot,
+            RenderGraphResource colorAttachment,
+            RenderGraphResource depthAttachment);
+
+        // Frames added to the graph but not handed out yet
+        [[nodiscard]] uint32_t getPendingCount() const;
+
+        static Shared create(const GraphicsContext::Shared& graphicsContext, uint32_t frameSlotCount);
+
+    private:
+        struct ReadbackTarget
+        {
+            Buffer::Shared buffer;
+            vk::Format format = vk::Format::eUndefined;
+            vk::Extent2D extent{};
+            size_t size = 0;
+        };
+
+        struct ReadbackSlot
+        {
+            ReadbackTarget color;
+            ReadbackTarget depth;
+            bool copiesColor = false;
+            bool copiesDepth = false;
+            uint64_t frameNumber = 0;
+            bool pending = false;
+        };
+
+        struct ReadbackCopy
+        {
+            RenderGraphResource image = RenderGraph::InvalidResource;
+            RenderGraphResource buffer = RenderGraph::InvalidResource;
+            vk::ImageAspectFlags aspect;
+            vk::Extent2D extent{};
+        };
+
+    private:
+        void init();
+
+        // Grows or recreates the target to fit the attachment, returns false when it can't be copied
+        bool prepareTarget(ReadbackTarget& target,
+            const FramebufferAttachmentInfo& info,
+            vk::Extent2D extent,
+            vk::ImageAspectFlags aspect) const;
+
+        static size_t getTexelSize(vk::Format format, vk::ImageAspectFlags aspect);
+
+    private:
+        GraphicsContext::Shared m_graphicsContext;
+        uint32_t m_frameSlotCount = 0;
+        vk::MemoryPropertyFlags m_memoryPropertyFlags;
+
+        ReadbackCallback m_callback;
+        bool m_colorReadbackEnabled = true;
+        bool m_depthReadbackEnabled = false;
+
+        std::vector<ReadbackSlot> m_slots;
+        uint64_t m_nextFrameNumber = 0;
+    };
+} // LearnVulkanRAII
+
+#endif //LEARNVULKANRAII_READBACKRING_H
\ No newline at end of file
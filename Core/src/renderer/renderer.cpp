@@ -10,12 +10,16 @@
 #include <glm/glm.hpp>
 
 #include <algorithm>
+#include <chrono>
+#include <tuple>
 
 namespace LearnVulkanRAII
 {
     Renderer::Renderer(const GraphicsContext::Shared& graphicsContext)
         : m_graphicsContext(graphicsContext),
-        m_allocationBatchInfo(500, 32)
+        m_jobSystem(JobSystem::getShared()),
+        // Instanced batches are bounded by the object metadata records rather than by the faces
+        m_allocationBatchInfo(500, 1024)
     {
         init();
     }
@@ -28,80 +32,345 @@ namespace LearnVulkanRAII
     void Renderer::beginFrame(const SwapchainFramebuffer::Shared& framebuffer, const CameraViewData& cameraData)
     {
         auto& device = m_graphicsContext->getDevice();
-        auto& swapchain = m_graphicsContext->getSwapchain();
+
+        // Every resize since the last frame is applied at once
+        if (m_graphicsContext->isSwapchainOutOfDate())
+            recreateSwapchain();
 
         auto& framebuffers = framebuffer->getBuffers();
-        ASSERT(m_commandBuffers.size() == framebuffers.size(), "Framebuffer seems incompatible!");
+        ASSERT(m_graphicsContext->getSwapchainImageCount() == framebuffers.size(), "Framebuffer seems incompatible!");
         m_framebuffer = framebuffer;
 
         auto& frameContext = m_inFlightFrameManager.getCurrentFrameContext();
-        auto [result, imageIndex] =
-            swapchain.acquireNextImage(UINT64_MAX, **frameContext.imageAvailableSemaphore);
+
+        // Headless, the offscreen framebuffers are used round robin with the frame slots, nothing to acquire
+        uint32_t imageIndex = m_inFlightFrameManager.getCurrentFrameIndex();
+        m_skipsFrame = !m_graphicsContext->isHeadless() && !acquireNextImage(frameContext, imageIndex);
+        if (m_skipsFrame)
+        {
+            // Nothing is submitted, the frame slot's fence stays signaled for its next frame
+            m_stats.reset();
+            frameContext.resetCounts();
+            return;
+        }
 
         auto _ = device.waitForFences(**frameContext.inFlightFence, VK_TRUE, UINT64_MAX);
         device.resetFences(**frameContext.inFlightFence);
 
+        // The frame slot's command buffers are done, all of them are reset at once
+        m_commandAllocator->reset(m_inFlightFrameManager.getCurrentFrameIndex());
+        m_renderGraph->nextFrame();
+        m_graphicsContext->nextFrame();
+        releaseRetiredFramebuffers();
+        // The frame slot's previous frame is done, so are its copies
+        m_readbackRing->collect(m_inFlightFrameManager.getCurrentFrameIndex());
+
         // reset the statistics
         m_stats.reset();
+        readGpuFrameTime();
 
         // reset frame context counts
         frameContext.resetCounts();
 
-        ASSERT(result == vk::Result::eSuccess || result == vk::Result::eSuboptimalKHR,
-            "Failed to acquire swapchain image!");
-
         frameContext.imageIndex = imageIndex;
 
-        // Copy the per-frame camera view data
-        void* data = m_cameraViewDataBuffers[imageIndex]->map();
-        std::memcpy(data, &cameraData, sizeof(CameraViewData));
-        m_cameraViewDataBuffers[imageIndex]->unmap();
+        // The camera data is pushed with every batch, so only the combined matrix is kept around
+        frameContext.viewProjection = cameraData.getViewProjection();
+        frameContext.frustum = Frustum::fromViewProjection(frameContext.viewProjection);
     }
 
     void Renderer::endFrame()
     {
+        mergeDrawRecorders();
+
+        // Collected draws are batched now, the last of them go out with the final draw below.
+        // Recorded draws are always collected, they go through the list in submission order without sorting
+        if (isCollectingDraws() || !m_drawList.empty())
+            flushDrawList();
+
         auto& frameContext = m_inFlightFrameManager.getCurrentFrameContext();
         frameContext.isLastDrawCall = true;
 
         draw();
-        presentFrame();
+        if (!m_graphicsContext->isHeadless() && !m_skipsFrame)
+            presentFrame();
         m_inFlightFrameManager.nextFrame();
     }
 
-    void Renderer::drawMesh(const Mesh& mesh, const Transform& transform)
+    void Renderer::drawMesh(const Mesh& mesh, const Transform& transform, uint32_t materialIndex)
+    {
+        const auto& frameContext = m_inFlightFrameManager.getCurrentFrameContext();
+        const auto bounds = mesh.getBoundingSphere().transformed(transform);
+
+        if (m_frustumCullingEnabled && !frameContext.frustum.intersects(bounds))
+        {
+            m_stats.culledObjectCount++;
+            return;
+        }
+        m_stats.visibleObjectCount++;
+
+        if (isCollectingDraws())
+        {
+            m_drawList.add(mesh, transform, materialIndex, getViewDepth(bounds.center));
+            return;
+        }
+
+        batchMesh(mesh, transform, materialIndex);
+    }
+
+    void Renderer::drawMesh(const Mesh& mesh, TransformId transformId, uint32_t materialIndex)
     {
-        if (m_localTransferSpace.getCurrentFaceCounts() + mesh.getFaceCount() > m_allocationBatchInfo.batchSize ||
+        ASSERT(m_transformStore->isValid(transformId), "Invalid transform id!");
+        ASSERT(transformId <= InternalVertex::ObjectMetadataIndexMask, "Transform id doesn't fit in the packed internal vertex!");
+
+        // The cached record is reused, so culling doesn't cost a matrix rebuild for static objects
+        const auto& frameContext = m_inFlightFrameManager.getCurrentFrameContext();
+        const auto bounds = mesh.getBoundingSphere().transformed(m_transformStore->getAffine3x4(transformId));
+
+        if (m_frustumCullingEnabled && !frameContext.frustum.intersects(bounds))
+        {
+            m_stats.culledObjectCount++;
+            return;
+        }
+        m_stats.visibleObjectCount++;
+
+        if (isCollectingDraws())
+        {
+            m_drawList.add(mesh, transformId, materialIndex, getViewDepth(bounds.center));
+            return;
+        }
+
+        batchMesh(mesh, transformId, materialIndex);
+    }
+
+    void Renderer::batchMesh(const Mesh& mesh, const Transform& transform, uint32_t materialIndex)
+    {
+        if (m_localTransferSpace.usesRetainedTransforms ||
+            m_localTransferSpace.usesInstancing ||
+            m_localTransferSpace.getCurrentFaceCounts() + mesh.getFaceCount() > m_allocationBatchInfo.batchSize ||
             m_localTransferSpace.currentObjectMetadataCount >= m_allocationBatchInfo.modelCount)
         {
             // flush
-            draw();
+            if (m_localTransferSpace.currentIndexCount != 0)
+                draw();
         }
 
-        // TODO: Need to find a better way instead of just copying memory on each draw call
-        size_t indexOffset = m_localTransferSpace.currentVertexCount;
-        memcpy((m_localTransferSpace.vertices + indexOffset),
-            mesh.vertices.data(),
-            mesh.getVerticesSizeInBytes());
+        appendMeshGeometry(mesh, static_cast<uint32_t>(m_localTransferSpace.currentObjectMetadataCount), materialIndex);
 
-        std::fill_n(m_localTransferSpace.internalVertices + indexOffset,
-            sizeof(InternalVertex) * mesh.getVerticesCount(),
-            InternalVertex{ static_cast<int>(m_localTransferSpace.currentObjectMetadataCount) });
+        m_localTransferSpace.transforms.push(transform);
+        m_localTransferSpace.currentObjectMetadataCount++;
+    }
 
-        m_localTransferSpace.currentVertexCount += mesh.getVerticesCount();
+    void Renderer::batchMesh(const Mesh& mesh, TransformId transformId, uint32_t materialIndex)
+    {
+        if (!m_localTransferSpace.usesRetainedTransforms ||
+            m_localTransferSpace.usesInstancing ||
+            m_localTransferSpace.getCurrentFaceCounts() + mesh.getFaceCount() > m_allocationBatchInfo.batchSize)
+        {
+            // flush
+            if (m_localTransferSpace.currentIndexCount != 0)
+                draw();
+        }
 
-        for (const auto idx : mesh.indices)
+        m_localTransferSpace.usesRetainedTransforms = true;
+        appendMeshGeometry(mesh, transformId, materialIndex);
+    }
+
+    void Renderer::batchInstances(const DrawRun& run)
+    {
+        const auto& firstItem = m_drawList.getSorted(run.first);
+        const Mesh& mesh = *firstItem.mesh;
+        const bool retained = firstItem.pipeline == DrawPipeline::RetainedTransforms;
+
+        // Every instance takes an internal vertex, immediate ones an object metadata record as well
+        const size_t instanceCapacity = retained
+            ? m_allocationBatchInfo.getVertexCount()
+            : std::min(m_allocationBatchInfo.getVertexCount(), m_allocationBatchInfo.modelCount);
+
+        uint32_t instance = 0;
+        while (instance < run.count)
         {
-            m_localTransferSpace.indices[m_localTransferSpace.currentIndexCount++] = idx + indexOffset;
+            auto& space = m_localTransferSpace;
+            const size_t usedInstances = retained ? space.currentInstanceCount : space.currentObjectMetadataCount;
+            if (!space.usesInstancing ||
+                space.usesRetainedTransforms != retained ||
+                space.getCurrentFaceCounts() + mesh.getFaceCount() > m_allocationBatchInfo.batchSize ||
+                usedInstances >= instanceCapacity)
+            {
+                // flush
+                if (space.currentIndexCount != 0)
+                    draw();
+            }
+
+            space.usesInstancing = true;
+            space.usesRetainedTransforms = retained;
+
+            vk::DrawIndexedIndirectCommand command{};
+            command.indexCount = static_cast<uint32_t>(mesh.indices.size());
+            command.firstIndex = appendMeshVertices(mesh);
+            command.firstInstance = static_cast<uint32_t>(space.currentInstanceCount);
+
+            const size_t freeInstances = instanceCapacity - (retained ? space.currentInstanceCount : space.currentObjectMetadataCount);
+            command.instanceCount = static_cast<uint32_t>(std::min<size_t>(run.count - instance, freeInstances));
+
+            for (uint32_t i = 0; i < command.instanceCount; i++)
+            {
+                const auto& item = m_drawList.getSorted(run.first + instance + i);
+                ASSERT(item.materialIndex <= InternalVertex::MaxMaterialIndex || item.materialIndex == BindlessDescriptorSet::InvalidIndex,
+                    "Material index doesn't fit in the packed internal vertex!");
+
+                uint32_t objectMetadataIndex = item.transformIndex;
+                if (!retained)
+                {
+                    objectMetadataIndex = static_cast<uint32_t>(space.currentObjectMetadataCount++);
+                    space.transforms.push(m_drawList.getTransform(item));
+                }
+
+                space.internalVertices[space.currentInstanceCount++] = InternalVertex{ objectMetadataIndex, item.materialIndex };
+            }
+
+            space.instancedDraws.push_back(command);
+            instance += command.instanceCount;
+
+            m_stats.instancedObjectCount += command.instanceCount;
+            m_stats.instancedDrawCount++;
         }
+    }
+
+    DrawRecorder& Renderer::acquireDrawRecorder()
+    {
+        std::lock_guard lock(m_drawRecorderMutex);
+
+        if (m_acquiredDrawRecorderCount == m_drawRecorders.size())
+            m_drawRecorders.push_back(DrawRecorder::makeUnique(m_transformStore));
+
+        const auto& frameContext = m_inFlightFrameManager.getCurrentFrameContext();
+        auto& recorder = *m_drawRecorders[m_acquiredDrawRecorderCount++];
+        recorder.reset(frameContext.viewProjection, frameContext.frustum, m_frustumCullingEnabled);
 
-        m_localTransferSpace.objectMetadata[m_localTransferSpace.currentObjectMetadataCount++].model = transform.toMat4();
+        return recorder;
+    }
+
+    TransformId Renderer::createTransform(const Transform& transform)
+    {
+        return m_transformStore->createTransform(transform);
+    }
+
+    void Renderer::updateTransform(TransformId transformId, const Transform& transform)
+    {
+        m_transformStore->setTransform(transformId, transform);
+    }
+
+    void Renderer::destroyTransform(TransformId transformId)
+    {
+        m_transformStore->destroyTransform(transformId);
+    }
+
+    RenderableId Renderer::createRenderable(const Mesh& mesh, const Transform& transform, uint32_t materialIndex)
+    {
+        return m_retainedScene->createRenderable(mesh, transform, materialIndex);
+    }
+
+    void Renderer::updateRenderable(RenderableId renderableId, const Transform& transform)
+    {
+        m_retainedScene->updateRenderable(renderableId, transform);
+    }
+
+    void Renderer::destroyRenderable(RenderableId renderableId)
+    {
+        m_retainedScene->destroyRenderable(renderableId);
     }
 
     void Renderer::resize(uint32_t width, uint32_t height)
     {
-        // As per current implementation, there is nothing much to handle on resize.
-        // However, this function is kept for future use
-        m_defaultFramebuffer->resize(width, height);
+        m_graphicsContext->resize(width, height);
+    }
+
+    void Renderer::setFrustumCullingEnabled(bool enabled)
+    {
+        m_frustumCullingEnabled = enabled;
+    }
+
+    bool Renderer::isFrustumCullingEnabled() const
+    {
+        return m_frustumCullingEnabled;
+    }
+
+    void Renderer::setGpuCullingEnabled(bool enabled)
+    {
+        m_gpuCullingEnabled = enabled;
+    }
+
+    bool Renderer::isGpuCullingEnabled() const
+    {
+        return m_gpuCullingEnabled;
+    }
+
+    void Renderer::setOcclusionCullingEnabled(bool enabled)
+    {
+        m_gpuCuller->setOcclusionCullingEnabled(enabled);
+    }
+
+    bool Renderer::isOcclusionCullingEnabled() const
+    {
+        return m_gpuCuller->isOcclusionCullingEnabled();
+    }
+
+    void Renderer::setDrawSortingEnabled(bool enabled)
+    {
+        // Draws collected so far still go out with the settings they were collected with
+        if (!m_drawList.empty())
+            flushDrawList();
+
+        m_drawSortingEnabled = enabled;
+    }
+
+    bool Renderer::isDrawSortingEnabled() const
+    {
+        return m_drawSortingEnabled;
+    }
+
+    void Renderer::setAutoInstancingEnabled(bool enabled)
+    {
+        if (!m_drawList.empty())
+            flushDrawList();
+
+        m_autoInstancingEnabled = enabled;
+    }
+
+    bool Renderer::isAutoInstancingEnabled() const
+    {
+        return m_autoInstancingEnabled;
+    }
+
+    void Renderer::setDepthPrePassEnabled(bool enabled)
+    {
+        m_depthPrePassEnabled = enabled;
+    }
+
+    bool Renderer::isDepthPrePassEnabled() const
+    {
+        return m_depthPrePassEnabled;
+    }
+
+    void Renderer::setParallelRecordingEnabled(bool enabled)
+    {
+        m_parallelRecordingEnabled = enabled;
+    }
+
+    bool Renderer::isParallelRecordingEnabled() const
+    {
+        return m_parallelRecordingEnabled;
+    }
+
+    void Renderer::setCommandCachingEnabled(bool enabled)
+    {
+        m_commandCachingEnabled = enabled;
+    }
+
+    bool Renderer::isCommandCachingEnabled() const
+    {
+        return m_commandCachingEnabled;
     }
 
     void Renderer::setBatchSize(size_t batchSize)
@@ -125,133 +394,96 @@ namespace LearnVulkanRAII
         return m_stats;
     }
 
-    const vk::raii::RenderPass& Renderer::getRenderPass() const
+    const BindlessDescriptorSet::Shared& Renderer::getBindlessDescriptorSet() const
+    {
+        return m_bindlessDescriptorSet;
+    }
+
+    const TransformStore::Shared& Renderer::getTransformStore() const
+    {
+        return m_transformStore;
+    }
+
+    const RetainedScene::Shared& Renderer::getRetainedScene() const
+    {
+        return m_retainedScene;
+    }
+
+    const GpuCuller::Shared& Renderer::getGpuCuller() const
+    {
+        return m_gpuCuller;
+    }
+
+    const ReadbackRing::Shared& Renderer::getReadbackRing() const
     {
-        return *m_firstRenderPass;
+        return m_readbackRing;
     }
 
     void Renderer::init()
     {
-        createRenderPass();
-        createDescriptorSetLayout();
+        createBindlessDescriptorSet();
+        createTransformStore();
+        createRetainedScene();
+        createGpuCuller();
+        createRenderGraph();
+        createReadbackRing();
         createGraphicsPipeline();
-        createGraphicsCommandPool();
-        allocateCommandBuffers();
+        createCommandAllocator();
+        createGeometryCache();
         createSyncObjects();
+        createTimestampQueryPool();
 
         allocateLocalTransferSpace();
         createBuffers();
-        createDescriptorPool();
-        allocateDescriptorSets();
         createDefaultFramebuffer();
     }
 
-    void Renderer::createRenderPass()
+    void Renderer::createBindlessDescriptorSet()
     {
-        auto swapchainImageFormat = m_graphicsContext->getSwapchainImageFormat();
-        auto& device = m_graphicsContext->getDevice();
-
-        vk::AttachmentDescription colorAttachment{
-            {},
-            swapchainImageFormat,
-            vk::SampleCountFlagBits::e1,
-            vk::AttachmentLoadOp::eClear,
-            vk::AttachmentStoreOp::eStore,
-            vk::AttachmentLoadOp::eDontCare,
-            vk::AttachmentStoreOp::eDontCare,
-            vk::ImageLayout::eUndefined,
-            vk::ImageLayout::ePresentSrcKHR
-        };
-
-        vk::Format depthFormat = m_graphicsContext->findDepthFormat();
-        vk::AttachmentDescription depthAttachment{
-            {},
-            depthFormat,
-            vk::SampleCountFlagBits::e1,
-            vk::AttachmentLoadOp::eClear,
-            vk::AttachmentStoreOp::eStore,
-            vk::AttachmentLoadOp::eClear,
-            vk::AttachmentStoreOp::eStore,
-            vk::ImageLayout::eUndefined,
-            vk::ImageLayout::eDepthStencilAttachmentOptimal
-        };
-
-        std::array attachments{colorAttachment, depthAttachment};
-
-        vk::AttachmentReference colorAttachmentRef{0, vk::ImageLayout::eColorAttachmentOptimal};
-        vk::AttachmentReference depthAttachmentRef{1, vk::ImageLayout::eDepthStencilAttachmentOptimal};
-
-        vk::SubpassDescription subpass{
-            {},
-            vk::PipelineBindPoint::eGraphics,
-            0,
-            nullptr,
-            1,
-            &colorAttachmentRef,
-            nullptr,
-            &depthAttachmentRef,
-        };
-
-        vk::SubpassDependency dependency{
-            VK_SUBPASS_EXTERNAL,
-            0,
-            vk::PipelineStageFlagBits::eColorAttachmentOutput,
-            vk::PipelineStageFlagBits::eColorAttachmentOutput,
-            vk::AccessFlagBits::eNone,
-            vk::AccessFlagBits::eColorAttachmentWrite,
-        };
-
-        vk::RenderPassCreateInfo renderPassInfo{
-            {},
-            static_cast<uint32_t>(attachments.size()),
-            attachments.data(),
-            1,
-            &subpass,
-            1,
-            &dependency,
-        };
-
-        m_firstRenderPass = device.createRenderPass(renderPassInfo);
+        m_bindlessDescriptorSet = BindlessDescriptorSet::create(m_graphicsContext);
+    }
 
-        colorAttachment.loadOp = vk::AttachmentLoadOp::eLoad;
-        colorAttachment.initialLayout = vk::ImageLayout::ePresentSrcKHR;
+    void Renderer::createTransformStore()
+    {
+        const uint32_t frameSlotCount = m_graphicsContext->getFrameSlotCount();
 
-        depthAttachment.loadOp = vk::AttachmentLoadOp::eLoad;
-        depthAttachment.stencilLoadOp = vk::AttachmentLoadOp::eLoad;
-        depthAttachment.initialLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+        // One copy of the records per frame in flight
+        m_transformStore = TransformStore::create(m_graphicsContext,
+            m_bindlessDescriptorSet,
+            frameSlotCount);
+    }
 
-        attachments = {colorAttachment, depthAttachment};
+    void Renderer::createRetainedScene()
+    {
+        const uint32_t frameSlotCount = m_graphicsContext->getFrameSlotCount();
 
-        m_batchRenderPass = device.createRenderPass(renderPassInfo);
+        m_retainedScene = RetainedScene::create(m_graphicsContext,
+            m_bindlessDescriptorSet,
+            m_transformStore,
+            frameSlotCount);
     }
 
-    void Renderer::createDescriptorSetLayout()
+    void Renderer::createGpuCuller()
     {
-        auto& device = m_graphicsContext->getDevice();
+        const uint32_t frameSlotCount = m_graphicsContext->getFrameSlotCount();
 
-        vk::DescriptorSetLayoutBinding cameraViewDataBinding{
-            0,
-            vk::DescriptorType::eUniformBuffer,
-            1,
-            vk::ShaderStageFlagBits::eVertex,
-        };
+        m_gpuCuller = GpuCuller::create(m_graphicsContext,
+            m_bindlessDescriptorSet,
+            frameSlotCount);
+    }
 
-        vk::DescriptorSetLayoutBinding objectMetadataBinding{
-            1,
-            vk::DescriptorType::eStorageBuffer,
-            1,
-            vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment,
-        };
+    void Renderer::createRenderGraph()
+    {
+        const uint32_t frameSlotCount = m_graphicsContext->getFrameSlotCount();
 
-        std::array layoutBindings{ cameraViewDataBinding, objectMetadataBinding };
+        m_renderGraph = RenderGraph::create(m_graphicsContext, frameSlotCount);
+    }
 
-        vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo{
-            {},
-            static_cast<uint32_t>(layoutBindings.size()),
-            layoutBindings.data()
-        };
+    void Renderer::createReadbackRing()
+    {
+        const uint32_t frameSlotCount = m_graphicsContext->getFrameSlotCount();
 
-        m_descriptorSetLayout = device.createDescriptorSetLayout(descriptorSetLayoutCreateInfo);
+        m_readbackRing = ReadbackRing::create(m_graphicsContext, frameSlotCount);
     }
 
     void Renderer::createGraphicsPipeline()
@@ -260,6 +492,7 @@ namespace LearnVulkanRAII
 
         const std::string vertexGlslSrc = Utils::readFile("Core/resources/shaders/renderer.vertex.glsl");
         const std::string fragmentGlslSrc = Utils::readFile("Core/resources/shaders/renderer.fragment.glsl");
+        const std::string depthPrePassVertexGlslSrc = Utils::readFile("Core/resources/shaders/depthprepass.vertex.glsl");
 
         vk::raii::ShaderModule vertexShaderModule = Utils::createShaderModule(device,
             vk::ShaderStageFlagBits::eVertex,
@@ -267,6 +500,55 @@ namespace LearnVulkanRAII
         vk::raii::ShaderModule fragmentShaderModule = Utils::createShaderModule(device,
             vk::ShaderStageFlagBits::eFragment,
             fragmentGlslSrc);
+        vk::raii::ShaderModule depthPrePassVertexShaderModule = Utils::createShaderModule(device,
+            vk::ShaderStageFlagBits::eVertex,
+            depthPrePassVertexGlslSrc);
+
+        vk::PushConstantRange pushConstantRange{
+            vk::ShaderStageFlagBits::eVertex,
+            0,
+            sizeof(DrawPushConstants)
+        };
+
+        vk::PipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.setSetLayouts(*m_bindlessDescriptorSet->getLayout());
+        pipelineLayoutInfo.setPushConstantRanges(pushConstantRange);
+
+        m_pipelineLayout = device.createPipelineLayout(pipelineLayoutInfo);
+
+        m_graphicsPipeline = createGraphicsPipelineVariant(vertexShaderModule,
+            fragmentShaderModule,
+            vk::VertexInputRate::eVertex,
+            DepthPass::Default);
+        m_instancedGraphicsPipeline = createGraphicsPipelineVariant(vertexShaderModule,
+            fragmentShaderModule,
+            vk::VertexInputRate::eInstance,
+            DepthPass::Default);
+
+        m_depthPrePassPipeline = createGraphicsPipelineVariant(depthPrePassVertexShaderModule,
+            fragmentShaderModule,
+            vk::VertexInputRate::eVertex,
+            DepthPass::PrePass);
+        m_instancedDepthPrePassPipeline = createGraphicsPipelineVariant(depthPrePassVertexShaderModule,
+            fragmentShaderModule,
+            vk::VertexInputRate::eInstance,
+            DepthPass::PrePass);
+        m_afterDepthPrePassPipeline = createGraphicsPipelineVariant(vertexShaderModule,
+            fragmentShaderModule,
+            vk::VertexInputRate::eVertex,
+            DepthPass::AfterPrePass);
+        m_instancedAfterDepthPrePassPipeline = createGraphicsPipelineVariant(vertexShaderModule,
+            fragmentShaderModule,
+            vk::VertexInputRate::eInstance,
+            DepthPass::AfterPrePass);
+    }
+
+    vk::raii::Pipeline Renderer::createGraphicsPipelineVariant(const vk::raii::ShaderModule& vertexShaderModule,
+        const vk::raii::ShaderModule& fragmentShaderModule,
+        vk::VertexInputRate internalVertexInputRate,
+        DepthPass depthPass) const
+    {
+        auto& device = m_graphicsContext->getDevice();
 
         vk::PipelineShaderStageCreateInfo vertexShaderStage{
             {}, vk::ShaderStageFlagBits::eVertex, vertexShaderModule, "main"
@@ -286,6 +568,7 @@ namespace LearnVulkanRAII
         vk::VertexInputBindingDescription internalVertexInputBindingDescription{
             1,
             sizeof(InternalVertex),
+            internalVertexInputRate
         };
 
         std::array vertexInputBindings{ vertexInputBindingDescription, internalVertexInputBindingDescription };
@@ -300,7 +583,7 @@ namespace LearnVulkanRAII
         vk::VertexInputAttributeDescription internalVertexInputAttributeDescription{
             1,
             1,
-            vk::Format::eR32Sint,
+            vk::Format::eR32Uint,
             0
         };
 
@@ -343,11 +626,13 @@ namespace LearnVulkanRAII
             VK_FALSE
         };
 
+        // After the pre-pass the depth is final, only the fragments that wrote it pass
+        const bool afterPrePass = depthPass == DepthPass::AfterPrePass;
         vk::PipelineDepthStencilStateCreateInfo depthStencilState{
             {},
             VK_TRUE,
-            VK_TRUE,
-            vk::CompareOp::eLess,
+            afterPrePass ? VK_FALSE : VK_TRUE,
+            afterPrePass ? vk::CompareOp::eEqual : vk::CompareOp::eLess,
             VK_FALSE,
             VK_FALSE,
             {},
@@ -370,6 +655,10 @@ namespace LearnVulkanRAII
                 vk::ColorComponentFlagBits::eA
         };
 
+        // The subpass still has the color attachment, the pre-pass just leaves it alone
+        if (depthPass == DepthPass::PrePass)
+            colorBlendAttachment.colorWriteMask = {};
+
         vk::PipelineColorBlendStateCreateInfo colorBlending{
             {}, VK_FALSE,
             vk::LogicOp::eCopy,
@@ -381,14 +670,15 @@ namespace LearnVulkanRAII
         vk::PipelineDynamicStateCreateInfo dynamicStateCreateInfo;
         dynamicStateCreateInfo.setDynamicStates(dynamicStates);
 
-        vk::PipelineLayoutCreateInfo pipelineLayoutInfo{};
-        pipelineLayoutInfo.setSetLayouts(**m_descriptorSetLayout);
-
-        m_pipelineLayout = device.createPipelineLayout(pipelineLayoutInfo);
+        // Dynamic rendering, the pipeline only needs the attachment formats
+        const vk::Format colorAttachmentFormat = m_graphicsContext->getSwapchainImageFormat();
+        vk::PipelineRenderingCreateInfo renderingCreateInfo{};
+        renderingCreateInfo.setColorAttachmentFormats(colorAttachmentFormat);
+        renderingCreateInfo.depthAttachmentFormat = m_graphicsContext->findDepthFormat();
 
         vk::GraphicsPipelineCreateInfo graphicsPipelineCreateInfo{
             {},
-            2,
+            depthPass == DepthPass::PrePass ? 1u : 2u,
             shaderStages,
             &vertexInputInfo,
             &inputAssembly,
@@ -400,52 +690,59 @@ namespace LearnVulkanRAII
             &colorBlending,
             &dynamicStateCreateInfo,
             **m_pipelineLayout,
-            **m_firstRenderPass,
+            nullptr,
             0,
             vk::Pipeline(),
             -1
         };
+        graphicsPipelineCreateInfo.pNext = &renderingCreateInfo;
 
-        m_graphicsPipeline = device.createGraphicsPipeline(VK_NULL_HANDLE, graphicsPipelineCreateInfo);
+        return device.createGraphicsPipeline(VK_NULL_HANDLE, graphicsPipelineCreateInfo);
     }
 
-    void Renderer::createGraphicsCommandPool()
+    const vk::raii::Pipeline& Renderer::getGraphicsPipeline(DepthPass depthPass, bool instanced) const
     {
-        auto& device = m_graphicsContext->getDevice();
-        auto queueFamilyIndices = m_graphicsContext->getQueueFamilyIndices();
-
-        vk::CommandPoolCreateInfo commandPoolCreateInfo{
-            vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
-            static_cast<uint32_t>(queueFamilyIndices.graphicsQueueFamilyIndex)
-        };
+        switch (depthPass)
+        {
+        case DepthPass::PrePass:
+            return instanced ? *m_instancedDepthPrePassPipeline : *m_depthPrePassPipeline;
+        case DepthPass::AfterPrePass:
+            return instanced ? *m_instancedAfterDepthPrePassPipeline : *m_afterDepthPrePassPipeline;
+        default:
+            return instanced ? *m_instancedGraphicsPipeline : *m_graphicsPipeline;
+        }
+    }
 
-        m_graphicsCommandPool = device.createCommandPool(commandPoolCreateInfo);
+    void Renderer::createCommandAllocator()
+    {
+        m_commandAllocator = CommandAllocator::create(m_graphicsContext, m_graphicsContext->getFrameSlotCount());
     }
 
-    void Renderer::allocateCommandBuffers()
+    void Renderer::createGeometryCache()
     {
         auto& device = m_graphicsContext->getDevice();
-        auto& swapchainImageViews = m_graphicsContext->getSwapchainImageViews();
+        auto queueFamilyIndices = m_graphicsContext->getQueueFamilyIndices();
 
-        vk::CommandBufferAllocateInfo allocateInfo{
-            **m_graphicsCommandPool,
-            vk::CommandBufferLevel::ePrimary,
-            static_cast<uint32_t>(swapchainImageViews.size())
+        // Cached buffers outlive the frame slot resets, a changed batch re-records its own buffer
+        vk::CommandPoolCreateInfo commandPoolCreateInfo{
+            vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+            static_cast<uint32_t>(queueFamilyIndices.graphicsQueueFamilyIndex)
         };
 
-        m_commandBuffers = device.allocateCommandBuffers(allocateInfo);
+        m_geometryCachePool = device.createCommandPool(commandPoolCreateInfo);
+        m_geometryCache.resize(m_graphicsContext->getFrameSlotCount());
     }
 
     void Renderer::createSyncObjects()
     {
         auto& device = m_graphicsContext->getDevice();
-        auto& swapchainImageViews = m_graphicsContext->getSwapchainImageViews();
+        const uint32_t frameSlotCount = m_graphicsContext->getFrameSlotCount();
 
-        m_inFlightFrameManager = InFlightFrameManager(static_cast<uint32_t>(swapchainImageViews.size()));
+        m_inFlightFrameManager = InFlightFrameManager(frameSlotCount);
 
         vk::FenceCreateInfo fenceCreateInfo{ vk::FenceCreateFlagBits::eSignaled };
 
-        for (size_t i = 0; i < swapchainImageViews.size(); i++)
+        for (size_t i = 0; i < frameSlotCount; i++)
         {
             auto& frameContext = m_inFlightFrameManager.frames.emplace_back();
             frameContext.imageAvailableSemaphore = device.createSemaphore({});
@@ -454,6 +751,97 @@ namespace LearnVulkanRAII
         }
     }
 
+    void Renderer::createTimestampQueryPool()
+    {
+        auto& device = m_graphicsContext->getDevice();
+        const uint32_t frameSlotCount = m_graphicsContext->getFrameSlotCount();
+
+        const auto limits = m_graphicsContext->getPhysicalDevice().getProperties().limits;
+        if (!limits.timestampComputeAndGraphics)
+            return;
+
+        // Frame begin and end, for every frame in flight
+        vk::QueryPoolCreateInfo queryPoolCreateInfo{
+            {},
+            vk::QueryType::eTimestamp,
+            frameSlotCount * 2
+        };
+
+        m_timestampQueryPool = device.createQueryPool(queryPoolCreateInfo);
+        m_timestampPeriod = limits.timestampPeriod;
+        m_timestampsWritten.assign(frameSlotCount, 0);
+    }
+
+    void Renderer::readGpuFrameTime()
+    {
+        const uint32_t frameSlot = m_inFlightFrameManager.getCurrentFrameIndex();
+        if (!m_timestampQueryPool || !m_timestampsWritten[frameSlot])
+            return;
+
+        // The slot's fence has been waited on, the previous frame's timestamps are available
+        auto [result, timestamps] = m_timestampQueryPool->getResults<uint64_t>(frameSlot * 2,
+            2,
+            2 * sizeof(uint64_t),
+            sizeof(uint64_t),
+            vk::QueryResultFlagBits::e64);
+
+        if (result == vk::Result::eSuccess)
+            m_stats.gpuFrameTimeMilliseconds = static_cast<double>(timestamps[1] - timestamps[0]) * m_timestampPeriod * 1e-6;
+    }
+
+    bool Renderer::recreateSwapchain()
+    {
+        if (!m_graphicsContext->recreateSwapchain())
+            return false;
+
+        // Kept alive until every frame slot came around, frames in flight still render into them
+        m_retiredFramebuffers.push_back(RetiredFramebuffers{ m_defaultFramebuffer->getBuffers(), m_graphicsContext->getFrameSlotCount() });
+
+        const auto extent = m_graphicsContext->getSwapchainExtent();
+        m_defaultFramebuffer->resize(extent.width, extent.height);
+        return true;
+    }
+
+    bool Renderer::acquireNextImage(const FrameContext& frameContext, uint32_t& imageIndex)
+    {
+        // A failed acquire leaves the semaphore unsignaled, it's retried once on a recreated swapchain
+        for (uint32_t attempt = 0; attempt < 2; attempt++)
+        {
+            if (m_graphicsContext->isSwapchainOutOfDate() && !recreateSwapchain())
+                return false;
+
+            try
+            {
+                auto [result, index] = m_graphicsContext->getSwapchain().acquireNextImage(UINT64_MAX,
+                    **frameContext.imageAvailableSemaphore);
+
+                // Still presentable, the swapchain is recreated with the next frame
+                if (result == vk::Result::eSuboptimalKHR)
+                    m_graphicsContext->invalidateSwapchain();
+
+                imageIndex = index;
+                return true;
+            }
+            catch (const vk::OutOfDateKHRError&)
+            {
+                m_graphicsContext->invalidateSwapchain();
+            }
+        }
+
+        return false;
+    }
+
+    void Renderer::releaseRetiredFramebuffers()
+    {
+        for (auto& retired : m_retiredFramebuffers)
+        {
+            if (retired.framesLeft > 0)
+                retired.framesLeft--;
+        }
+
+        std::erase_if(m_retiredFramebuffers, [](const RetiredFramebuffers& retired) { return retired.framesLeft == 0; });
+    }
+
     void Renderer::allocateLocalTransferSpace()
     {
         // Initialize local buffer allocation
@@ -462,21 +850,27 @@ namespace LearnVulkanRAII
 
     void Renderer::createBuffers()
     {
-        auto& swapchainImageViews = m_graphicsContext->getSwapchainImageViews();
+        const uint32_t frameSlotCount = m_graphicsContext->getFrameSlotCount();
+
+        // Give back the bindless slots of the previous buffers
+        for (const auto index : m_objectMetadataBufferIndices)
+        {
+            m_bindlessDescriptorSet->releaseStorageBuffer(index);
+        }
+        m_objectMetadataBufferIndices.clear();
 
         m_vertexBuffers.clear();
         m_indexBuffers.clear();
-        m_cameraViewDataBuffers.clear();
         m_objectMetadataBuffers.clear();
         m_internalVertexBuffers.clear();
+        m_bufferGeneration++;
 
-        m_vertexBuffers.resize(swapchainImageViews.size());
-        m_indexBuffers.resize(swapchainImageViews.size());
-        m_cameraViewDataBuffers.resize(swapchainImageViews.size());
-        m_objectMetadataBuffers.resize(swapchainImageViews.size());
-        m_internalVertexBuffers.resize(swapchainImageViews.size());
+        m_vertexBuffers.resize(frameSlotCount);
+        m_indexBuffers.resize(frameSlotCount);
+        m_objectMetadataBuffers.resize(frameSlotCount);
+        m_internalVertexBuffers.resize(frameSlotCount);
 
-        for (size_t i = 0; i < swapchainImageViews.size(); i++)
+        for (size_t i = 0; i < frameSlotCount; i++)
         {
             // vertex buffer
             vk::DeviceSize bufferSize = m_allocationBatchInfo.getVerticesSizeInBytes();
@@ -494,14 +888,6 @@ namespace LearnVulkanRAII
                 vk::BufferUsageFlagBits::eIndexBuffer,
                 vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
 
-            // camera view data uniform buffer
-            bufferSize = sizeof(CameraViewData);
-            m_cameraViewDataBuffers[i] = Buffer::create(
-                m_graphicsContext,
-                bufferSize,
-                vk::BufferUsageFlagBits::eUniformBuffer,
-                vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
-
             // object metadata storage buffer
             bufferSize = sizeof(ObjectMetadata) * m_allocationBatchInfo.modelCount;
             m_objectMetadataBuffers[i] = Buffer::create(
@@ -509,6 +895,8 @@ namespace LearnVulkanRAII
                 bufferSize,
                 vk::BufferUsageFlagBits::eStorageBuffer,
                 vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+            m_objectMetadataBufferIndices.push_back(
+                m_bindlessDescriptorSet->registerStorageBuffer(m_objectMetadataBuffers[i]));
 
             // internal vertex buffer
             bufferSize = m_allocationBatchInfo.getInternalVertexSizeInBytes();
@@ -520,176 +908,585 @@ namespace LearnVulkanRAII
         }
     }
 
-    void Renderer::createDescriptorPool()
+    void Renderer::createDefaultFramebuffer()
     {
-        auto& device = m_graphicsContext->getDevice();
-        auto& swapchainImageViews = m_graphicsContext->getSwapchainImageViews();
-
-        vk::DescriptorPoolSize cameraViewDataPoolSize{
-            vk::DescriptorType::eUniformBuffer,
-            static_cast<uint32_t>(m_cameraViewDataBuffers.size()),
-        };
-
-        vk::DescriptorPoolSize objectMetadataPoolSize{
-            vk::DescriptorType::eStorageBuffer,
-            static_cast<uint32_t>(m_objectMetadataBuffers.size())
+        vk::Format depthFormat = m_graphicsContext->findDepthFormat();
+        FramebufferAttachmentInfo depthAttachmentInfo{
+            depthFormat,
+            // Sampled by the depth pyramid build of the GPU culling pass, copied by depth readbacks
+            vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled |
+                vk::ImageUsageFlagBits::eTransferSrc,
+            vk::ImageAspectFlagBits::eDepth,
+            vk::ClearValue( vk::ClearDepthStencilValue(1.0f, 0) )
         };
 
-        std::array poolSizes{ cameraViewDataPoolSize, objectMetadataPoolSize };
+        if (!m_graphicsContext->isHeadless())
+        {
+            m_defaultFramebuffer = SwapchainFramebuffer::makeShared(m_graphicsContext, depthAttachmentInfo);
+            return;
+        }
 
-        vk::DescriptorPoolCreateInfo descriptorPoolCreateInfo{
-            vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
-            static_cast<uint32_t>(swapchainImageViews.size()),
-            static_cast<uint32_t>(poolSizes.size()),
-            poolSizes.data()
+        // Headless, one offscreen color target per frame slot stands in for the swapchain images.
+        // The finished frames stay in the color attachment layout, they can be copied out from there
+        auto extent = m_graphicsContext->getSwapchainExtent();
+        FramebufferAttachmentInfo colorAttachmentInfo{
+            m_graphicsContext->getSwapchainImageFormat(),
+            vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+            vk::ImageAspectFlagBits::eColor,
+            vk::ClearValue( vk::ClearColorValue(std::array{ 0.0f, 0.0f, 0.0f, 1.0f }) )
         };
-
-        m_descriptorPool = device.createDescriptorPool(descriptorPoolCreateInfo);
+        FramebufferSpecification spec{
+            extent.width,
+            extent.height,
+            { colorAttachmentInfo, depthAttachmentInfo }
+        };
+        m_defaultFramebuffer = SwapchainFramebuffer::makeShared(m_graphicsContext, spec);
     }
 
-    void Renderer::allocateDescriptorSets()
+    void Renderer::recordCommands(const vk::raii::CommandBuffer& cb, const Framebuffer::Shared& fb)
     {
-        auto& device = m_graphicsContext->getDevice();
-        auto& swapchainImageViews = m_graphicsContext->getSwapchainImageViews();
+        const auto& frameContext = m_inFlightFrameManager.getCurrentFrameContext();
+
+        vk::CommandBufferBeginInfo beginInfo{ vk::CommandBufferUsageFlagBits::eOneTimeSubmit };
+        cb.begin(beginInfo);
+
+        const uint32_t frameSlot = m_inFlightFrameManager.getCurrentFrameIndex();
+        if (m_timestampQueryPool && frameContext.drawCallCount == 0)
+        {
+            cb.resetQueryPool(**m_timestampQueryPool, frameSlot * 2, 2);
+            cb.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, **m_timestampQueryPool, frameSlot * 2);
+        }
 
-        std::vector descriptorSetLayouts(swapchainImageViews.size(), **m_descriptorSetLayout);
-        vk::DescriptorSetAllocateInfo descriptorSetAllocateInfo{
-            **m_descriptorPool,
-            static_cast<uint32_t>(swapchainImageViews.size()),
-            descriptorSetLayouts.data(),
+        auto swapchainExtent = m_graphicsContext->getSwapchainExtent();
+
+        vk::Viewport viewport{
+            0,
+            0,
+            static_cast<float>(swapchainExtent.width),
+            static_cast<float>(swapchainExtent.height),
+            0.0f,
+            1.0f
+        };
+
+        vk::Rect2D scissor{
+            {0, 0},
+            swapchainExtent
         };
 
-        m_descriptorSets = device.allocateDescriptorSets(descriptorSetAllocateInfo);
-        ASSERT(m_descriptorSets.size(), "Failed to allocate descriptor sets!");
+        CommandStateTracker state(cb);
+        state.setViewport(viewport);
+        state.setScissor(scissor);
 
-        for (size_t i = 0; i < swapchainImageViews.size(); i++)
+        // The resident renderables go out once per frame, with the last batch
+        const bool drawsRetainedScene = frameContext.isLastDrawCall && !m_retainedScene->empty();
+
+        // Compute work can't be recorded inside a render pass, the visible draw list is produced up front
+        if (drawsRetainedScene && m_gpuCullingEnabled)
         {
-            vk::DescriptorBufferInfo cameraViewDataBufferInfo{
-                *m_cameraViewDataBuffers[i]->getNativeBuffer(),
-                0,
-                sizeof(CameraViewData)
+            GpuCullInputs cullInputs{
+                m_transformStore->getBufferIndex(frameSlot),
+                m_retainedScene->getDrawCommandBufferIndex(frameSlot),
+                m_retainedScene->getInstanceBufferIndex(frameSlot),
+                m_retainedScene->getBoundsBufferIndex(frameSlot),
+                m_retainedScene->getDrawSlotCount()
             };
+            m_gpuCuller->recordCulling(cb, frameSlot, cullInputs);
+        }
 
-            vk::WriteDescriptorSet cameraViewDataWriteDescriptorSet{
-                *m_descriptorSets[i],
-                0,
-                0,
-                1,
-                vk::DescriptorType::eUniformBuffer,
-                nullptr,
-                &cameraViewDataBufferInfo
-            };
+        buildRenderGraph(*fb, state, drawsRetainedScene);
+        m_renderGraph->execute(cb);
+        m_commandStateStats += state.getStats();
 
-            vk::DescriptorBufferInfo objectMetadataBufferInfo{
-                *m_objectMetadataBuffers[i]->getNativeBuffer(),
-                0,
-                sizeof(ObjectMetadata) * m_allocationBatchInfo.modelCount
-            };
+        // The finished depth attachment becomes the occluders of the next frame
+        if (frameContext.isLastDrawCall && m_gpuCullingEnabled && m_gpuCuller->isOcclusionCullingEnabled())
+        {
+            if (auto depthImage = fb->getDepthImage())
+                m_gpuCuller->recordDepthPyramid(cb, depthImage, frameContext.viewProjection);
+        }
 
-            vk::WriteDescriptorSet objectMetadataWriteDescriptorSet{
-                *m_descriptorSets[i],
-                1,
-                0,
-                1,
-                vk::DescriptorType::eStorageBuffer,
-                nullptr,
-                &objectMetadataBufferInfo
-            };
+        if (m_timestampQueryPool && frameContext.isLastDrawCall)
+            cb.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, **m_timestampQueryPool, frameSlot * 2 + 1);
 
-            std::array descriptorWrites{ objectMetadataWriteDescriptorSet, cameraViewDataWriteDescriptorSet };
+        cb.end();
+    }
 
-            device.updateDescriptorSets(descriptorWrites, nullptr);
+    void Renderer::buildRenderGraph(const Framebuffer& fb, CommandStateTracker& state, bool drawsRetainedScene)
+    {
+        const auto& frameContext = m_inFlightFrameManager.getCurrentFrameContext();
+        const auto& attachmentInfos = fb.getFramebufferSpecification().attachments;
+
+        // Every batch is its own rendering pass: the first one clears, the later ones load what the previous stored.
+        // The color stage is the one the acquire semaphore waits on, the first transition chains after it
+        const bool firstPass = frameContext.drawCallCount == 0;
+        const auto colorState = RenderGraphResourceState::fromAccess(RenderGraphAccess::ColorAttachment);
+        const auto depthState = RenderGraphResourceState::fromAccess(RenderGraphAccess::DepthAttachment);
+
+        m_renderGraph->reset();
+
+        std::vector<RenderGraphResource> colorAttachments;
+        RenderGraphResource depthAttachment = RenderGraph::InvalidResource;
+        for (size_t i = 0; i < fb.getAttachmentCount(); i++)
+        {
+            if (attachmentInfos[i].aspectFlags & vk::ImageAspectFlagBits::eDepth)
+            {
+                RenderGraphResourceState initialState = depthState;
+                if (firstPass)
+                    initialState = { depthState.stageMask, vk::AccessFlagBits2::eDepthStencilAttachmentWrite, vk::ImageLayout::eUndefined };
+
+                // The depth pyramid reads the attachment after the graph, it goes back to the attachment layout
+                // when a readback copied it
+                depthAttachment = m_renderGraph->importFramebufferAttachment("Depth", fb, i, initialState, depthState);
+            }
+            else
+            {
+                RenderGraphResourceState initialState = colorState;
+                if (firstPass)
+                    initialState = { colorState.stageMask, vk::AccessFlagBits2::eNone, vk::ImageLayout::eUndefined };
+
+                Utils::Optional<RenderGraphResourceState> finalState;
+                if (frameContext.isLastDrawCall && !m_graphicsContext->isHeadless())
+                    finalState = RenderGraphResourceState::fromAccess(RenderGraphAccess::Present);
+
+                colorAttachments.push_back(m_renderGraph->importFramebufferAttachment("Color", fb, i, initialState, finalState));
+            }
+        }
+
+        const vk::AttachmentLoadOp loadOp = firstPass ? vk::AttachmentLoadOp::eClear : vk::AttachmentLoadOp::eLoad;
+        const bool inParallel = recordsGeometryInParallel();
+        m_renderGraph->addPass("Geometry",
+            [&](RenderGraph::PassBuilder& builder) {
+                if (inParallel || m_cachedGeometry)
+                    builder.setSecondaryCommandBuffers();
+                for (const auto attachment : colorAttachments)
+                {
+                    builder.addColorAttachment(attachment, loadOp);
+                }
+                if (depthAttachment != RenderGraph::InvalidResource)
+                    builder.setDepthAttachment(depthAttachment, loadOp);
+            },
+            [this, &fb, &state, drawsRetainedScene, inParallel](const vk::raii::CommandBuffer& cb, const RenderGraph&) {
+                if (inParallel)
+                {
+                    recordGeometryInParallel(cb, fb, drawsRetainedScene);
+                    state.invalidate();
+                    return;
+                }
+
+                if (m_cachedGeometry)
+                {
+                    cb.executeCommands(**m_cachedGeometry);
+                    state.invalidate();
+                    return;
+                }
+
+                state.bindDescriptorSet(vk::PipelineBindPoint::eGraphics,
+                    *m_pipelineLayout,
+                    0,
+                    *m_bindlessDescriptorSet->getDescriptorSet());
+
+                // Same geometry twice, depth first. Depth tests within a rendering pass follow the submission order
+                const uint32_t drawCount = getBatchDrawCount();
+                if (m_depthPrePassEnabled)
+                {
+                    recordGeometry(state, DepthPass::PrePass, 0, drawCount, drawsRetainedScene);
+                    recordGeometry(state, DepthPass::AfterPrePass, 0, drawCount, drawsRetainedScene);
+                }
+                else
+                {
+                    recordGeometry(state, DepthPass::Default, 0, drawCount, drawsRetainedScene);
+                }
+            });
+
+        if (frameContext.isLastDrawCall && m_readbackRing->isEnabled())
+        {
+            m_readbackRing->addReadbackPass(*m_renderGraph,
+                m_inFlightFrameManager.getCurrentFrameIndex(),
+                colorAttachments.empty() ? RenderGraph::InvalidResource : colorAttachments.front(),
+                depthAttachment);
         }
+
+        m_renderGraph->compile();
     }
 
-    void Renderer::createDefaultFramebuffer()
+    void Renderer::recordGeometry(CommandStateTracker& state,
+        DepthPass depthPass,
+        uint32_t firstDraw,
+        uint32_t drawCount,
+        bool drawsRetainedScene) const
     {
-        vk::Format depthFormat = m_graphicsContext->findDepthFormat();
-        FramebufferAttachmentInfo depthAttachmentInfo{
-            depthFormat,
-            vk::ImageUsageFlagBits::eDepthStencilAttachment,
-            vk::ImageAspectFlagBits::eDepth,
-            vk::ClearValue( vk::ClearDepthStencilValue(1.0f, 0) )
+        const auto& frameContext = m_inFlightFrameManager.getCurrentFrameContext();
+        const uint32_t frameSlot = m_inFlightFrameManager.getCurrentFrameIndex();
+
+        const auto& cb = state.getCommandBuffer();
+
+        // Instanced batches fetch the internal vertex per instance
+        state.bindPipeline(vk::PipelineBindPoint::eGraphics,
+            getGraphicsPipeline(depthPass, m_localTransferSpace.usesInstancing));
+
+        vk::Buffer vertexBuffers[] = {
+            *m_vertexBuffers[frameSlot]->getNativeBuffer(),
+            *m_internalVertexBuffers[frameSlot]->getNativeBuffer()
         };
-        m_defaultFramebuffer = SwapchainFramebuffer::makeShared(m_graphicsContext,
-            *m_firstRenderPass,
-            depthAttachmentInfo);
+        vk::DeviceSize offsets[] = { 0, 0 };
+        state.bindVertexBuffers(0, vertexBuffers, offsets);
+
+        state.bindIndexBuffer(*m_indexBuffers[frameSlot]->getNativeBuffer(), 0, vk::IndexType::eUint32);
+
+        uint32_t objectMetadataBufferIndex = m_localTransferSpace.usesRetainedTransforms
+            ? m_transformStore->getBufferIndex(frameSlot)
+            : m_objectMetadataBufferIndices[frameSlot];
+
+        DrawPushConstants pushConstants{
+            frameContext.viewProjection,
+            objectMetadataBufferIndex
+        };
+        state.pushConstants(*m_pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, pushConstants);
+
+        if (m_localTransferSpace.usesInstancing)
+        {
+            for (uint32_t i = firstDraw; i < firstDraw + drawCount; i++)
+            {
+                const auto& command = m_localTransferSpace.instancedDraws[i];
+                cb.drawIndexed(command.indexCount,
+                    command.instanceCount,
+                    command.firstIndex,
+                    command.vertexOffset,
+                    command.firstInstance);
+            }
+        }
+        else if (drawCount != 0)
+        {
+            cb.drawIndexed(static_cast<uint32_t>(m_localTransferSpace.currentIndexCount),
+                1, 0, 0, 0);
+        }
+
+        if (drawsRetainedScene)
+        {
+            state.bindPipeline(vk::PipelineBindPoint::eGraphics, getGraphicsPipeline(depthPass, true));
+
+            pushConstants.objectMetadataBufferIndex = m_transformStore->getBufferIndex(frameSlot);
+            state.pushConstants(*m_pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, pushConstants);
+
+            if (m_gpuCullingEnabled)
+            {
+                m_retainedScene->recordDrawsIndirectCount(state,
+                    frameSlot,
+                    m_gpuCuller->getDrawCommandBuffer(frameSlot),
+                    m_gpuCuller->getDrawCountBuffer(frameSlot));
+            }
+            else
+            {
+                m_retainedScene->recordDraws(state, frameSlot);
+            }
+        }
     }
 
-    void Renderer::recordCommands(const vk::raii::CommandBuffer& cb, const Framebuffer::Shared& fb) const
+    uint32_t Renderer::getBatchDrawCount() const
     {
-        const auto& frameContext = m_inFlightFrameManager.getCurrentFrameContext();
+        // A per-vertex batch is a single draw
+        return m_localTransferSpace.usesInstancing
+            ? static_cast<uint32_t>(m_localTransferSpace.instancedDraws.size())
+            : 1;
+    }
 
-        cb.reset();
+    bool Renderer::recordsGeometryInParallel() const
+    {
+        return m_parallelRecordingEnabled &&
+            m_jobSystem->getWorkerCount() != 0 &&
+            getBatchDrawCount() > DrawsPerSecondaryCommandBuffer;
+    }
 
-        vk::CommandBufferBeginInfo beginInfo{};
-        cb.begin(beginInfo);
+    void Renderer::beginGeometryCommandBuffer(CommandStateTracker& secondary,
+        const Framebuffer& fb,
+        vk::CommandBufferUsageFlags usageFlags) const
+    {
+        // Secondary buffers inherit nothing but the rendering scope, they are told its attachment formats
+        std::vector<vk::Format> colorFormats;
+        vk::Format depthFormat = vk::Format::eUndefined;
+        for (const auto& attachment : fb.getFramebufferSpecification().attachments)
+        {
+            if (attachment.aspectFlags & vk::ImageAspectFlagBits::eDepth)
+                depthFormat = attachment.format;
+            else
+                colorFormats.push_back(attachment.format);
+        }
 
-        auto swapchainExtent = m_graphicsContext->getSwapchainExtent();
+        vk::CommandBufferInheritanceRenderingInfo inheritanceRenderingInfo{};
+        inheritanceRenderingInfo.setColorAttachmentFormats(colorFormats);
+        inheritanceRenderingInfo.depthAttachmentFormat = depthFormat;
+        inheritanceRenderingInfo.rasterizationSamples = vk::SampleCountFlagBits::e1;
 
-        vk::Viewport viewport{
-            0,
+        vk::CommandBufferInheritanceInfo inheritanceInfo{};
+        inheritanceInfo.pNext = &inheritanceRenderingInfo;
+
+        vk::CommandBufferBeginInfo beginInfo{ usageFlags | vk::CommandBufferUsageFlagBits::eRenderPassContinue, &inheritanceInfo };
+        secondary.getCommandBuffer().begin(beginInfo);
+
+        const auto extent = m_graphicsContext->getSwapchainExtent();
+        secondary.setViewport(vk::Viewport{ 0, 0, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f });
+        secondary.setScissor(vk::Rect2D{ { 0, 0 }, extent });
+        secondary.bindDescriptorSet(vk::PipelineBindPoint::eGraphics,
+            *m_pipelineLayout,
             0,
-            static_cast<float>(swapchainExtent.width),
-            static_cast<float>(swapchainExtent.height),
-            0.0f,
-            1.0f
-        };
+            *m_bindlessDescriptorSet->getDescriptorSet());
+    }
 
-        vk::Rect2D scissor{
-            {0, 0},
-            swapchainExtent
-        };
+    size_t Renderer::hashGeometry(const Framebuffer& fb, bool drawsRetainedScene) const
+    {
+        const auto& frameContext = m_inFlightFrameManager.getCurrentFrameContext();
+        const uint32_t frameSlot = m_inFlightFrameManager.getCurrentFrameIndex();
+        const auto& space = m_localTransferSpace;
+
+        // Everything recordGeometry() reads: the camera, the pipelines, the bound buffers and the draw stream.
+        // The uploaded contents (vertices, transforms, materials) aren't part of the commands
+        size_t hash = 0;
+        Utils::hashCombine(hash, Utils::hashBytes(&frameContext.viewProjection, sizeof(frameContext.viewProjection)));
+        Utils::hashCombine(hash, m_depthPrePassEnabled);
+        Utils::hashCombine(hash, m_gpuCullingEnabled);
+        Utils::hashCombine(hash, space.usesInstancing);
+        Utils::hashCombine(hash, space.usesRetainedTransforms);
+
+        const auto extent = m_graphicsContext->getSwapchainExtent();
+        Utils::hashCombine(hash, extent.width);
+        Utils::hashCombine(hash, extent.height);
+        for (const auto& attachment : fb.getFramebufferSpecification().attachments)
+        {
+            Utils::hashCombine(hash, static_cast<uint32_t>(attachment.format));
+        }
+
+        // Buffers are told apart by their generation, the handle of a destroyed buffer may be reused
+        Utils::hashCombine(hash, m_bufferGeneration);
+        Utils::hashCombine(hash, m_objectMetadataBufferIndices[frameSlot]);
+        Utils::hashCombine(hash, m_transformStore->getBufferIndex(frameSlot));
+
+        if (space.usesInstancing)
+            Utils::hashCombine(hash, Utils::hashBytes(space.instancedDraws.data(), space.instancedDraws.size() * sizeof(vk::DrawIndexedIndirectCommand)));
+        else
+            Utils::hashCombine(hash, space.currentIndexCount);
+
+        Utils::hashCombine(hash, drawsRetainedScene);
+        if (drawsRetainedScene)
+        {
+            Utils::hashCombine(hash, m_retainedScene->hashDrawBindings(frameSlot));
+            if (m_gpuCullingEnabled)
+            {
+                Utils::hashCombine(hash, m_gpuCuller->getBufferGeneration());
+            }
+        }
 
-        cb.setViewport(0, viewport);
-        cb.setScissor(0, scissor);
+        return hash;
+    }
 
-        vk::RenderPassBeginInfo renderPassInfo{};
-        renderPassInfo.framebuffer = *(fb->getBuffer());
-        renderPassInfo.renderArea = vk::Rect2D{ { 0, 0 }, swapchainExtent };
+    void Renderer::prepareCachedGeometry(const Framebuffer& fb, bool drawsRetainedScene)
+    {
+        m_cachedGeometry = nullptr;
+        if (!m_commandCachingEnabled || recordsGeometryInParallel())
+            return;
+
+        // One entry per batch of the frame slot, the slot's fence has been waited on so it isn't in use
+        auto& entries = m_geometryCache[m_inFlightFrameManager.getCurrentFrameIndex()];
+        const size_t batchIndex = m_inFlightFrameManager.getCurrentFrameContext().drawCallCount;
+        if (entries.size() <= batchIndex)
+            entries.resize(batchIndex + 1);
+
+        auto& entry = entries[batchIndex];
+        const size_t hash = hashGeometry(fb, drawsRetainedScene);
+        if (entry.commandBuffer && entry.hash == hash)
+        {
+            m_stats.cachedGeometryReplayCount++;
+            m_cachedGeometry = &*entry.commandBuffer;
+            return;
+        }
+
+        if (!entry.commandBuffer)
+        {
+            vk::CommandBufferAllocateInfo allocateInfo{ **m_geometryCachePool, vk::CommandBufferLevel::eSecondary, 1 };
+            entry.commandBuffer = std::move(m_graphicsContext->getDevice().allocateCommandBuffers(allocateInfo).front());
+        }
 
-        if (frameContext.drawCallCount == 0) // Very first draw call
+        // Begin resets the buffer, its pool allows it
+        const auto& secondary = *entry.commandBuffer;
+        CommandStateTracker state(secondary);
+        beginGeometryCommandBuffer(state, fb, {});
+        const uint32_t drawCount = getBatchDrawCount();
+        if (m_depthPrePassEnabled)
         {
-            const auto& clearValues = fb->getClearValues();
-            renderPassInfo.renderPass = **m_firstRenderPass;
-            renderPassInfo.setClearValues(clearValues);
+            recordGeometry(state, DepthPass::PrePass, 0, drawCount, drawsRetainedScene);
+            recordGeometry(state, DepthPass::AfterPrePass, 0, drawCount, drawsRetainedScene);
         }
         else
         {
-            renderPassInfo.renderPass = **m_batchRenderPass;
+            recordGeometry(state, DepthPass::Default, 0, drawCount, drawsRetainedScene);
         }
+        secondary.end();
+        m_commandStateStats += state.getStats();
 
-        cb.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
+        entry.hash = hash;
+        m_cachedGeometry = &secondary;
+    }
 
-        cb.bindPipeline(vk::PipelineBindPoint::eGraphics, **m_graphicsPipeline);
+    void Renderer::recordGeometryInParallel(const vk::raii::CommandBuffer& cb,
+        const Framebuffer& fb,
+        bool drawsRetainedScene)
+    {
+        const uint32_t frameSlot = m_inFlightFrameManager.getCurrentFrameIndex();
 
-        vk::Buffer vertexBuffers[] = {
-            *m_vertexBuffers[frameContext.imageIndex]->getNativeBuffer(),
-            *m_internalVertexBuffers[frameContext.imageIndex]->getNativeBuffer()
+        // Disjoint draw ranges per depth pass, executed in order: the pre-pass ranges come before the shading ones.
+        // The retained scene goes with the last range of each depth pass
+        struct DrawRange
+        {
+            DepthPass depthPass = DepthPass::Default;
+            uint32_t firstDraw = 0;
+            uint32_t drawCount = 0;
+            bool drawsRetainedScene = false;
         };
-        vk::DeviceSize offsets[] = { 0, 0 };
-        cb.bindVertexBuffers(0, vertexBuffers, offsets);
 
-        cb.bindIndexBuffer(*m_indexBuffers[frameContext.imageIndex]->getNativeBuffer(), 0, vk::IndexType::eUint32);
+        std::vector<DepthPass> depthPasses = { DepthPass::Default };
+        if (m_depthPrePassEnabled)
+            depthPasses = { DepthPass::PrePass, DepthPass::AfterPrePass };
 
-        cb.bindDescriptorSets(
-            vk::PipelineBindPoint::eGraphics,
-            **m_pipelineLayout,
-            0,
-            *m_descriptorSets[frameContext.imageIndex],
-            nullptr);
+        const uint32_t drawCount = getBatchDrawCount();
+        std::vector<DrawRange> ranges;
+        for (const auto depthPass : depthPasses)
+        {
+            for (uint32_t first = 0; first < drawCount; first += DrawsPerSecondaryCommandBuffer)
+            {
+                const uint32_t count = std::min(DrawsPerSecondaryCommandBuffer, drawCount - first);
+                ranges.push_back(DrawRange{ depthPass, first, count, drawsRetainedScene && first + count == drawCount });
+            }
+        }
 
-        cb.drawIndexed(static_cast<uint32_t>(m_localTransferSpace.currentIndexCount),
-            1, 0, 0, 0);
+        m_secondaryCommandBuffers.resize(ranges.size());
+        // Per range, the jobs don't share anything they write
+        std::vector<CommandStateStatistics> rangeStats(ranges.size());
 
-        cb.endRenderPass();
-        cb.end();
+        m_jobSystem->parallelFor(static_cast<uint32_t>(ranges.size()), 1, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++)
+            {
+                const auto& range = ranges[i];
+
+                // From the recording thread's own pool, reset with the frame slot
+                const auto& secondary = m_commandAllocator->allocate(frameSlot, vk::CommandBufferLevel::eSecondary);
+                m_secondaryCommandBuffers[i] = *secondary;
+
+                CommandStateTracker state(secondary);
+                beginGeometryCommandBuffer(state, fb, vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+                recordGeometry(state, range.depthPass, range.firstDraw, range.drawCount, range.drawsRetainedScene);
+
+                secondary.end();
+                rangeStats[i] = state.getStats();
+            }
+        });
+
+        for (const auto& stats : rangeStats)
+        {
+            m_commandStateStats += stats;
+        }
+
+        cb.executeCommands(m_secondaryCommandBuffers);
+    }
+
+    void Renderer::appendMeshGeometry(const Mesh& mesh, uint32_t objectMetadataIndex, uint32_t materialIndex)
+    {
+        ASSERT(materialIndex <= InternalVertex::MaxMaterialIndex || materialIndex == BindlessDescriptorSet::InvalidIndex,
+            "Material index doesn't fit in the packed internal vertex!");
+
+        std::fill_n(m_localTransferSpace.internalVertices + m_localTransferSpace.currentVertexCount,
+            mesh.getVerticesCount(),
+            InternalVertex{ objectMetadataIndex, materialIndex });
+
+        appendMeshVertices(mesh);
+    }
+
+    uint32_t Renderer::appendMeshVertices(const Mesh& mesh)
+    {
+        // TODO: Need to find a better way instead of just copying memory on each draw call
+        size_t indexOffset = m_localTransferSpace.currentVertexCount;
+        memcpy((m_localTransferSpace.vertices + indexOffset),
+            mesh.vertices.data(),
+            mesh.getVerticesSizeInBytes());
+
+        m_localTransferSpace.currentVertexCount += mesh.getVerticesCount();
+
+        const auto firstIndex = static_cast<uint32_t>(m_localTransferSpace.currentIndexCount);
+        for (const auto idx : mesh.indices)
+        {
+            m_localTransferSpace.indices[m_localTransferSpace.currentIndexCount++] = idx + indexOffset;
+        }
+
+        return firstIndex;
+    }
+
+    float Renderer::getViewDepth(const glm::vec3& worldPosition) const
+    {
+        // Clip space w of a perspective projection is the distance along the view axis
+        const auto& viewProjection = m_inFlightFrameManager.getCurrentFrameContext().viewProjection;
+        const glm::vec4 wRow(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+        return glm::dot(wRow, glm::vec4(worldPosition, 1.0f));
+    }
+
+    bool Renderer::isCollectingDraws() const
+    {
+        return m_drawSortingEnabled || m_autoInstancingEnabled;
+    }
+
+    void Renderer::mergeDrawRecorders()
+    {
+        std::lock_guard lock(m_drawRecorderMutex);
+
+        for (size_t i = 0; i < m_acquiredDrawRecorderCount; i++)
+        {
+            const auto& recorder = *m_drawRecorders[i];
+            m_drawList.append(recorder.getDrawList());
+            m_stats.visibleObjectCount += recorder.getVisibleObjectCount();
+            m_stats.culledObjectCount += recorder.getCulledObjectCount();
+        }
+
+        m_acquiredDrawRecorderCount = 0;
+    }
+
+    void Renderer::flushDrawList()
+    {
+        const auto sortBegin = std::chrono::steady_clock::now();
+        m_drawList.sort(m_drawSortingEnabled, m_autoInstancingEnabled);
+        const auto sortEnd = std::chrono::steady_clock::now();
+
+        m_stats.sortedDrawCount += m_drawList.size();
+        m_stats.drawSortTimeMicroseconds += std::chrono::duration<double, std::micro>(sortEnd - sortBegin).count();
+
+        if (m_autoInstancingEnabled)
+        {
+            for (size_t i = 0; i < m_drawList.getRunCount(); i++)
+            {
+                batchInstances(m_drawList.getRun(i));
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < m_drawList.size(); i++)
+            {
+                const auto& item = m_drawList.getSorted(i);
+                if (item.pipeline == DrawPipeline::RetainedTransforms)
+                    batchMesh(*item.mesh, item.transformIndex, item.materialIndex);
+                else
+                    batchMesh(*item.mesh, m_drawList.getTransform(item), item.materialIndex);
+            }
+        }
+
+        m_drawList.clear();
     }
 
     void Renderer::draw()
     {
+        if (m_skipsFrame)
+        {
+            m_localTransferSpace.resetCurrentCounts();
+            return;
+        }
+
         auto& frameContext = m_inFlightFrameManager.getCurrentFrameContext();
         uint32_t imageIndex = frameContext.imageIndex;
+        const uint32_t frameSlot = m_inFlightFrameManager.getCurrentFrameIndex();
         auto& graphicsQueue = m_graphicsContext->getGraphicsQueue();
         auto& framebuffers = m_framebuffer->getBuffers();
 
@@ -702,46 +1499,120 @@ namespace LearnVulkanRAII
             device.resetFences(**frameContext.inFlightFence);
         }
 
-        // Record the commands
+        // Cull the retained scene first, visibility changes end up in the draw commands uploaded below.
+        // With GPU culling every live renderable keeps its command, the compute pass does the selection
+        if (frameContext.isLastDrawCall && !m_retainedScene->empty())
+        {
+            size_t renderableCount = m_retainedScene->getRenderableCount();
+            size_t visibleCount = renderableCount;
+            if (m_frustumCullingEnabled && !m_gpuCullingEnabled)
+                visibleCount = m_retainedScene->cull(frameContext.frustum);
+            else
+                m_retainedScene->disableCulling();
+
+            if (!m_gpuCullingEnabled)
+            {
+                m_stats.visibleObjectCount += visibleCount;
+                m_stats.culledObjectCount += renderableCount - visibleCount;
+            }
+        }
+
+        // The fence has been waited on, so the frame slot's copy of the retained records is free to update
+        const bool drawsRetainedScene = frameContext.isLastDrawCall && !m_retainedScene->empty();
+        if (m_localTransferSpace.usesRetainedTransforms || drawsRetainedScene)
+        {
+            auto flushInfo = m_transformStore->flush(m_inFlightFrameManager.getCurrentFrameIndex());
+            m_stats.matricesRecomputed += flushInfo.matricesRecomputed;
+            m_stats.objectMetadataBytesUploaded += flushInfo.bytesUploaded;
+        }
+
+        if (frameContext.isLastDrawCall)
+        {
+            auto sceneFlushInfo = m_retainedScene->flush(m_inFlightFrameManager.getCurrentFrameIndex());
+            m_stats.sceneBytesUploaded += sceneFlushInfo.recordsBytesUploaded + sceneFlushInfo.geometryBytesUploaded;
+            m_stats.renderableCount = m_retainedScene->getRenderableCount();
+
+            if (m_gpuCullingEnabled)
+            {
+                const uint32_t drawCount = drawsRetainedScene ? m_retainedScene->getDrawSlotCount() : 0;
+                m_gpuCuller->prepare(m_inFlightFrameManager.getCurrentFrameIndex(),
+                    frameContext.frustum,
+                    m_frustumCullingEnabled,
+                    drawCount,
+                    framebuffers[imageIndex]->getDepthImage());
+                m_stats.gpuCulledDrawCount = drawCount;
+            }
+        }
+
+        // Record the commands, every batch gets a fresh buffer of the frame slot
         auto& fb = framebuffers[imageIndex];
-        const auto& cb = m_commandBuffers[imageIndex];
+        const auto& cb = m_commandAllocator->allocate(m_inFlightFrameManager.getCurrentFrameIndex());
+        m_secondaryCommandBuffers.clear();
+        m_commandStateStats = {};
+        prepareCachedGeometry(*fb, drawsRetainedScene);
         recordCommands(cb, fb);
+        m_stats.secondaryCommandBufferCount += m_secondaryCommandBuffers.size();
+        m_stats.emittedStateCommandCount += m_commandStateStats.emittedCommandCount;
+        m_stats.elidedStateCommandCount += m_commandStateStats.elidedCommandCount;
+
+        // Copy from local allocation to the dedicated vk buffers.
+        // The batch can be empty when only the retained scene is drawn, mapping zero bytes isn't allowed
+        void* data = nullptr;
+        if (m_localTransferSpace.currentVertexCount != 0)
+        {
+            data = m_vertexBuffers[frameSlot]->map(m_localTransferSpace.getCurrentVerticesSizeInBytes(), 0);
+            memcpy(data, m_localTransferSpace.vertices, m_localTransferSpace.getCurrentVerticesSizeInBytes());
+            m_vertexBuffers[frameSlot]->unmap();
 
-        // Copy from local allocation to the dedicated vk buffers
-        void* data = m_vertexBuffers[imageIndex]->map(m_localTransferSpace.getCurrentVerticesSizeInBytes(), 0);
-        memcpy(data, m_localTransferSpace.vertices, m_localTransferSpace.getCurrentVerticesSizeInBytes());
-        m_vertexBuffers[imageIndex]->unmap();
+            data = m_internalVertexBuffers[frameSlot]->map(m_localTransferSpace.getCurrentIntervalVerticesSizeInBytes(), 0);
+            memcpy(data, m_localTransferSpace.internalVertices, m_localTransferSpace.getCurrentIntervalVerticesSizeInBytes());
+            m_internalVertexBuffers[frameSlot]->unmap();
+        }
 
-        data = m_indexBuffers[imageIndex]->map(m_localTransferSpace.getCurrentIndicesSizeInBytes(), 0);
-        memcpy(data, m_localTransferSpace.indices, m_localTransferSpace.getCurrentIndicesSizeInBytes());
-        m_indexBuffers[imageIndex]->unmap();
+        if (m_localTransferSpace.currentIndexCount != 0)
+        {
+            data = m_indexBuffers[frameSlot]->map(m_localTransferSpace.getCurrentIndicesSizeInBytes(), 0);
+            memcpy(data, m_localTransferSpace.indices, m_localTransferSpace.getCurrentIndicesSizeInBytes());
+            m_indexBuffers[frameSlot]->unmap();
+        }
 
-        data = m_objectMetadataBuffers[imageIndex]->map(m_localTransferSpace.getCurrentObjectMetadataSizeInBytes(), 0);
-        memcpy(data, m_localTransferSpace.objectMetadata, m_localTransferSpace.getCurrentObjectMetadataSizeInBytes());
-        m_objectMetadataBuffers[imageIndex]->unmap();
+        // The affine records are written by the transform kernels directly into the mapped storage buffer
+        if (m_localTransferSpace.currentObjectMetadataCount != 0)
+        {
+            data = m_objectMetadataBuffers[frameSlot]->map(m_localTransferSpace.getCurrentObjectMetadataSizeInBytes(), 0);
+            TransformKernels::toAffine3x4(m_localTransferSpace.transforms,
+                0,
+                m_localTransferSpace.currentObjectMetadataCount,
+                &static_cast<ObjectMetadata*>(data)->model);
+            m_objectMetadataBuffers[frameSlot]->unmap();
 
-        data = m_internalVertexBuffers[imageIndex]->map(m_localTransferSpace.getCurrentIntervalVerticesSizeInBytes(), 0);
-        memcpy(data, m_localTransferSpace.internalVertices, m_localTransferSpace.getCurrentIntervalVerticesSizeInBytes());
-        m_internalVertexBuffers[imageIndex]->unmap();
+            m_stats.matricesRecomputed += m_localTransferSpace.currentObjectMetadataCount;
+            m_stats.objectMetadataBytesUploaded += m_localTransferSpace.getCurrentObjectMetadataSizeInBytes();
+        }
 
         vk::SubmitInfo submitInfo{};
 
         vk::PipelineStageFlags waitStages[] = { vk::PipelineStageFlagBits::eColorAttachmentOutput };
         submitInfo.setWaitDstStageMask(waitStages);
         submitInfo.waitSemaphoreCount = 0;
-        if (frameContext.drawCallCount == 0) // First draw call, wait for imageAvailable
+        // Headless frames have no acquire or present to synchronize with, the fence is all there is
+        const bool presents = !m_graphicsContext->isHeadless();
+        if (presents && frameContext.drawCallCount == 0) // First draw call, wait for imageAvailable
         {
             submitInfo.setWaitSemaphores(**frameContext.imageAvailableSemaphore);
         }
         submitInfo.setCommandBuffers(*cb);
         submitInfo.signalSemaphoreCount = 0;
-        if (frameContext.isLastDrawCall) // Last draw call, signal the renderFinished
+        if (presents && frameContext.isLastDrawCall) // Last draw call, signal the renderFinished
         {
             submitInfo.setSignalSemaphores(**frameContext.renderFinishedSemaphore);
         }
 
         graphicsQueue.submit(submitInfo, **frameContext.inFlightFence);
 
+        if (m_timestampQueryPool && frameContext.isLastDrawCall)
+            m_timestampsWritten[m_inFlightFrameManager.getCurrentFrameIndex()] = 1;
+
         // Update the frame context counts
         frameContext.drawCallCount++;
 
@@ -765,6 +1636,15 @@ namespace LearnVulkanRAII
         presentInfo.setSwapchains(*swapchain);
         presentInfo.setImageIndices(frameContext.imageIndex);
 
-        auto _ = presentQueue.presentKHR(presentInfo);
+        // The semaphore wait still happens when the present is rejected, the swapchain is recreated next frame
+        try
+        {
+            if (presentQueue.presentKHR(presentInfo) == vk::Result::eSuboptimalKHR)
+                m_graphicsContext->invalidateSwapchain();
+        }
+        catch (const vk::OutOfDateKHRError&)
+        {
+            m_graphicsContext->invalidateSwapchain();
+        }
     }
 } // LearnVulkanRAII
\ No newline at end of file
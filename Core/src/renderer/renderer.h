@@ -7,14 +7,30 @@
 
 #include "base/utils.h"
 #include "base/graphicscontext.h"
+#include "base/commandallocator.h"
+#include "base/jobsystem.h"
 
 #include "mesh/mesh.h"
+#include "mesh/transformarray.h"
 
 #include "framebuffer.h"
 #include "buffer.h"
+#include "bindlessdescriptorset.h"
+#include "transformstore.h"
+#include "retainedscene.h"
+#include "gpuculler.h"
+#include "drawlist.h"
+#include "drawrecorder.h"
+#include "rendergraph.h"
+#include "readbackring.h"
+#include "commandstatetracker.h"
+#include "renderertypes.h"
+#include "frustum.h"
 
 #include <vulkan/vulkan_raii.hpp>
 
+#include <mutex>
+
 namespace LearnVulkanRAII
 {
     // As per current implementation, only triangles are supported as a rendering primitive
@@ -27,16 +43,8 @@ namespace LearnVulkanRAII
     {
         glm::mat4 projection = glm::mat4(1.0f);
         glm::mat4 view = glm::mat4(1.0f);
-    };
-
-    struct ObjectMetadata
-    {
-        glm::mat4 model = glm::mat4(1.0f);
-    };
 
-    struct InternalVertex
-    {
-        int objectMetadataIndex = 0;
+        [[nodiscard]] glm::mat4 getViewProjection() const { return projection * view; }
     };
 
     struct BatchAllocationInfo
@@ -65,7 +73,7 @@ namespace LearnVulkanRAII
             verticesSize = vertexCount * sizeof(Vertex);
             indicesSize = indexCount * sizeof(uint32_t);
             modelsSize = modelCount * sizeof(ObjectMetadata);
-            internalVerticesSize = verticesSize + sizeof(InternalVertex);
+            internalVerticesSize = vertexCount * sizeof(InternalVertex);
         }
 
         size_t getVertexCount() const { return vertexCount; }
@@ -90,14 +98,24 @@ namespace LearnVulkanRAII
     {
         Vertex* vertices = nullptr;
         uint32_t* indices = nullptr;
-        ObjectMetadata* objectMetadata = nullptr;
         InternalVertex* internalVertices = nullptr;
+        // Kept as TRS so the affine records are produced by the SIMD kernels straight into the mapped buffer
+        TransformArray transforms;
         BatchAllocationInfo batchInfo;
 
         size_t currentVertexCount = 0;
         size_t currentIndexCount = 0;
         size_t currentObjectMetadataCount = 0;
 
+        // Retained draws read their records from the transform store, a batch never mixes both kinds
+        bool usesRetainedTransforms = false;
+
+        // Instanced batches copy the geometry of a mesh once and keep one internal vertex per instance,
+        // they never mix with per-vertex batches either
+        bool usesInstancing = false;
+        size_t currentInstanceCount = 0;
+        std::vector<vk::DrawIndexedIndirectCommand> instancedDraws;
+
         LocalTransferSpace() = default;
         explicit LocalTransferSpace(const BatchAllocationInfo& allocationBatchInfo)
             : batchInfo(allocationBatchInfo)
@@ -125,8 +143,8 @@ namespace LearnVulkanRAII
 
             vertices = new Vertex[batchInfo.getVertexCount()];
             indices = new uint32_t[batchInfo.getIndexCount()];
-            objectMetadata = new ObjectMetadata[batchInfo.modelCount];
             internalVertices = new InternalVertex[batchInfo.getVertexCount()];
+            transforms.reserve(batchInfo.modelCount);
         }
 
         void deAllocate()
@@ -135,14 +153,11 @@ namespace LearnVulkanRAII
                 delete[] vertices;
             if (indices != nullptr)
                 delete[] indices;
-            if (objectMetadata != nullptr)
-                delete[] objectMetadata;
             if (internalVertices != nullptr)
                 delete[] internalVertices;
 
             vertices = nullptr;
             indices = nullptr;
-            objectMetadata = nullptr;
             internalVertices = nullptr;
 
             resetCurrentCounts();
@@ -151,7 +166,8 @@ namespace LearnVulkanRAII
         size_t getCurrentVerticesSizeInBytes() const { return currentVertexCount * sizeof(Vertex); }
         size_t getCurrentIndicesSizeInBytes() const { return currentIndexCount * sizeof(uint32_t); }
         size_t getCurrentObjectMetadataSizeInBytes() const { return currentObjectMetadataCount * sizeof(ObjectMetadata); }
-        size_t getCurrentIntervalVerticesSizeInBytes() const { return currentVertexCount * sizeof(InternalVertex); }
+        size_t getCurrentInternalVertexCount() const { return usesInstancing ? currentInstanceCount : currentVertexCount; }
+        size_t getCurrentIntervalVerticesSizeInBytes() const { return getCurrentInternalVertexCount() * sizeof(InternalVertex); }
 
         size_t getCurrentFaceCounts() const { return currentIndexCount / 3; }
 
@@ -160,12 +176,19 @@ namespace LearnVulkanRAII
             currentVertexCount = 0;
             currentIndexCount = 0;
             currentObjectMetadataCount = 0;
+            usesRetainedTransforms = false;
+            usesInstancing = false;
+            currentInstanceCount = 0;
+            instancedDraws.clear();
+            transforms.clear();
         }
     };
 
     struct FrameContext
     {
         uint32_t imageIndex; // swapchain acquired image index
+        glm::mat4 viewProjection = glm::mat4(1.0f); // precombined once per frame in beginFrame
+        Frustum frustum; // extracted from viewProjection, used to cull before batching
         Utils::Optional<vk::raii::Semaphore> imageAvailableSemaphore;
         Utils::Optional<vk::raii::Semaphore> renderFinishedSemaphore;
         Utils::Optional<vk::raii::Fence> inFlightFence;
@@ -205,7 +228,44 @@ namespace LearnVulkanRAII
         size_t totalVertexCount = 0;
         size_t totalIndexCount = 0;
 
+        // Object metadata work of the frame, retained transforms only count when they changed
+        size_t matricesRecomputed = 0;
+        size_t objectMetadataBytesUploaded = 0;
+
+        // Retained scene records (draw commands, instances) and geometry written this frame
+        size_t sceneBytesUploaded = 0;
+        size_t renderableCount = 0;
+
+        // Frustum culling results, immediate and retained objects together.
+        // Retained objects culled on the GPU aren't counted here, the results never come back to the CPU
+        size_t visibleObjectCount = 0;
+        size_t culledObjectCount = 0;
+        // Draw commands handed to the GPU culling pass
+        size_t gpuCulledDrawCount = 0;
+
+        // Draw key sorting on the CPU, and the GPU time of the frame that last used this frame slot
+        size_t sortedDrawCount = 0;
+        double drawSortTimeMicroseconds = 0.0;
+        double gpuFrameTimeMilliseconds = 0.0;
+
+        // drawMesh calls coalesced into instanced draws, and the instanced draws recorded for them
+        size_t instancedObjectCount = 0;
+        size_t instancedDrawCount = 0;
+
+        // Secondary command buffers the geometry was recorded into on the job system
+        size_t secondaryCommandBufferCount = 0;
+        // Batches whose geometry commands were replayed from the cache instead of recorded
+        size_t cachedGeometryReplayCount = 0;
+        // Viewport, scissor, pipeline, buffer, descriptor set and push constant commands recorded, and the redundant
+        // ones dropped before reaching the command buffer
+        size_t emittedStateCommandCount = 0;
+        size_t elidedStateCommandCount = 0;
+
         [[nodiscard]] size_t getTotalFaceCount() const { return totalIndexCount / 3; }
+        [[nodiscard]] double getInstancingRatio() const
+        {
+            return instancedDrawCount != 0 ? static_cast<double>(instancedObjectCount) / static_cast<double>(instancedDrawCount) : 0.0;
+        }
         void reset() { memset(this, 0, sizeof(RendererStatistics)); }
     };
 
@@ -214,6 +274,8 @@ namespace LearnVulkanRAII
     public:
         DEFINE_SMART_POINTER_HELPERS(Renderer)
 
+        static constexpr uint32_t DrawsPerSecondaryCommandBuffer = 256;
+
     public:
         explicit Renderer(const GraphicsContext::Shared& graphicsContext);
 
@@ -221,36 +283,168 @@ namespace LearnVulkanRAII
         void beginFrame(const SwapchainFramebuffer::Shared& framebuffer, const CameraViewData& cameraData);
         void endFrame();
 
-        void drawMesh(const Mesh& mesh, const Transform& transform);
-
+        void drawMesh(const Mesh& mesh,
+            const Transform& transform,
+            uint32_t materialIndex = BindlessDescriptorSet::InvalidIndex);
+        // Draws with a retained transform, its record is only recomputed and uploaded when it changes
+        void drawMesh(const Mesh& mesh,
+            TransformId transformId,
+            uint32_t materialIndex = BindlessDescriptorSet::InvalidIndex);
+
+        // Thread safe, between beginFrame() and endFrame(). A recorder for one thread (or job) to submit draws with,
+        // culled and collected on that thread. Their draws are appended in acquisition order at endFrame()
+        DrawRecorder& acquireDrawRecorder();
+
+        TransformId createTransform(const Transform& transform);
+        void updateTransform(TransformId transformId, const Transform& transform);
+        void destroyTransform(TransformId transformId);
+
+        // Renderables stay resident and are drawn every frame until destroyed, no drawMesh call needed
+        RenderableId createRenderable(const Mesh& mesh,
+            const Transform& transform,
+            uint32_t materialIndex = BindlessDescriptorSet::InvalidIndex);
+        void updateRenderable(RenderableId renderableId, const Transform& transform);
+        void destroyRenderable(RenderableId renderableId);
+
+        // Coalesced, the swapchain and the default framebuffer are recreated once at the next beginFrame
         void resize(uint32_t width, uint32_t height);
 
+        void setFrustumCullingEnabled(bool enabled);
+        [[nodiscard]] bool isFrustumCullingEnabled() const;
+
+        // Collects the drawMesh calls of the frame and batches them in DrawKey order at endFrame():
+        // retained transforms and immediate ones grouped, each front to back.
+        // Meshes must then stay alive until endFrame()
+        void setDrawSortingEnabled(bool enabled);
+        [[nodiscard]] bool isDrawSortingEnabled() const;
+
+        // Collects the drawMesh calls of the frame as well, repeated meshes are coalesced into instanced draws
+        // with contiguous object metadata at endFrame(). Runs are placed where their first (front most) draw was
+        void setAutoInstancingEnabled(bool enabled);
+        [[nodiscard]] bool isAutoInstancingEnabled() const;
+
+        // Every render pass lays down the depth of its geometry with a position only pipeline first,
+        // then shades it with an equal depth test and depth writes off: each pixel is shaded once per pass
+        void setDepthPrePassEnabled(bool enabled);
+        [[nodiscard]] bool isDepthPrePassEnabled() const;
+
+        // Culls the retained scene in a compute pre-pass instead of on the CPU, occlusion culling
+        // (against the previous frame's depth) only applies to it
+        void setGpuCullingEnabled(bool enabled);
+        [[nodiscard]] bool isGpuCullingEnabled() const;
+        void setOcclusionCullingEnabled(bool enabled);
+        [[nodiscard]] bool isOcclusionCullingEnabled() const;
+
+        // Batches with more than DrawsPerSecondaryCommandBuffer draws are recorded into secondary command buffers
+        // on the job system, one per draw range, and executed from the frame's command buffer
+        void setParallelRecordingEnabled(bool enabled);
+        [[nodiscard]] bool isParallelRecordingEnabled() const;
+
+        // Keeps the geometry commands of every batch (per frame slot) in a secondary command buffer and replays it
+        // while the batch would record the same commands: same camera, pipelines, buffers and draw stream.
+        // Meant for mostly idle windows, the attachment transitions and the compute passes are still recorded.
+        // Batches recorded in parallel aren't cached
+        void setCommandCachingEnabled(bool enabled);
+        [[nodiscard]] bool isCommandCachingEnabled() const;
+
         void setBatchSize(size_t batchSize);
         [[nodiscard]] size_t getBatchSize() const;
         [[nodiscard]] const RendererStatistics& getStats() const;
 
-        [[nodiscard]] const vk::raii::RenderPass& getRenderPass() const;
+        [[nodiscard]] const BindlessDescriptorSet::Shared& getBindlessDescriptorSet() const;
+        [[nodiscard]] const TransformStore::Shared& getTransformStore() const;
+        [[nodiscard]] const RetainedScene::Shared& getRetainedScene() const;
+        [[nodiscard]] const GpuCuller::Shared& getGpuCuller() const;
+        // Copies of the finished frames, set a callback to receive them (offscreen framebuffers only)
+        [[nodiscard]] const ReadbackRing::Shared& getReadbackRing() const;
 
         // TODO: Need to create a 'create' function for renderer
         // static Shared create(...);
 
+    private:
+        // How a pipeline variant uses the depth attachment
+        enum class DepthPass
+        {
+            Default,      // depth test less, depth writes on
+            PrePass,      // no fragment shading, no color writes
+            AfterPrePass  // depth test equal, depth writes off
+        };
+
     private:
         void init();
 
-        void createRenderPass();
-        void createDescriptorSetLayout();
+        void createBindlessDescriptorSet();
+        void createTransformStore();
+        void createRetainedScene();
+        void createGpuCuller();
+        void createRenderGraph();
+        void createReadbackRing();
         void createGraphicsPipeline();
-        void createGraphicsCommandPool();
-        void allocateCommandBuffers();
+        void createCommandAllocator();
+        void createGeometryCache();
         void createSyncObjects();
+        void createTimestampQueryPool();
 
         void allocateLocalTransferSpace();
         void createBuffers();
-        void createDescriptorPool();
-        void allocateDescriptorSets();
         void createDefaultFramebuffer();
 
-        void recordCommands(const vk::raii::CommandBuffer& cb, const Framebuffer::Shared& fb) const;
+        // The fragment shader module is ignored by the depth pre-pass variant
+        vk::raii::Pipeline createGraphicsPipelineVariant(const vk::raii::ShaderModule& vertexShaderModule,
+            const vk::raii::ShaderModule& fragmentShaderModule,
+            vk::VertexInputRate internalVertexInputRate,
+            DepthPass depthPass) const;
+        [[nodiscard]] const vk::raii::Pipeline& getGraphicsPipeline(DepthPass depthPass, bool instanced) const;
+
+        void recordCommands(const vk::raii::CommandBuffer& cb, const Framebuffer::Shared& fb);
+        // Builds the batch's passes on the framebuffer attachments, the graph places the barriers in between.
+        // The geometry pass records through the primary buffer's state
+        void buildRenderGraph(const Framebuffer& fb, CommandStateTracker& state, bool drawsRetainedScene);
+        // The batch's draws [firstDraw, firstDraw + drawCount) and, with the last batch, the retained scene.
+        // Must be recorded inside the render pass
+        void recordGeometry(CommandStateTracker& state,
+            DepthPass depthPass,
+            uint32_t firstDraw,
+            uint32_t drawCount,
+            bool drawsRetainedScene) const;
+        [[nodiscard]] uint32_t getBatchDrawCount() const;
+        [[nodiscard]] bool recordsGeometryInParallel() const;
+        // Begins a secondary buffer continuing the geometry pass, with the viewport, scissor and descriptor set set
+        void beginGeometryCommandBuffer(CommandStateTracker& secondary,
+            const Framebuffer& fb,
+            vk::CommandBufferUsageFlags usageFlags) const;
+        // Identifies the commands recordGeometry() would record for the batch
+        [[nodiscard]] size_t hashGeometry(const Framebuffer& fb, bool drawsRetainedScene) const;
+        // Finds (or records) the batch's cached geometry, m_cachedGeometry is null when caching doesn't apply
+        void prepareCachedGeometry(const Framebuffer& fb, bool drawsRetainedScene);
+        // Splits the batch's draws over secondary command buffers recorded on the job system, executed from cb
+        void recordGeometryInParallel(const vk::raii::CommandBuffer& cb,
+            const Framebuffer& fb,
+            bool drawsRetainedScene);
+
+        void appendMeshGeometry(const Mesh& mesh, uint32_t objectMetadataIndex, uint32_t materialIndex);
+        // Vertices and indices only, returns the first index
+        uint32_t appendMeshVertices(const Mesh& mesh);
+
+        // Adds the draw to the current batch, flushing it first when it can't take the draw
+        void batchMesh(const Mesh& mesh, const Transform& transform, uint32_t materialIndex);
+        void batchMesh(const Mesh& mesh, TransformId transformId, uint32_t materialIndex);
+        // Adds the run as instanced draws of its mesh, split over as many batches as needed
+        void batchInstances(const DrawRun& run);
+
+        [[nodiscard]] float getViewDepth(const glm::vec3& worldPosition) const;
+        [[nodiscard]] bool isCollectingDraws() const;
+        void flushDrawList();
+        // Appends the recorders' draws to the draw list, the recorders are free again afterward
+        void mergeDrawRecorders();
+
+        void readGpuFrameTime();
+
+        // Recreates the context's swapchain and the default framebuffer on it, the old attachments are retired
+        bool recreateSwapchain();
+        // False when no image could be acquired, even on a recreated swapchain
+        bool acquireNextImage(const FrameContext& frameContext, uint32_t& imageIndex);
+        void releaseRetiredFramebuffers();
 
         void draw();
         void presentFrame();
@@ -258,29 +452,88 @@ namespace LearnVulkanRAII
     private:
         GraphicsContext::Shared m_graphicsContext;
 
-        Utils::Optional<vk::raii::RenderPass> m_firstRenderPass;
-        Utils::Optional<vk::raii::RenderPass> m_batchRenderPass;
         Utils::Optional<vk::raii::PipelineLayout> m_pipelineLayout;
         Utils::Optional<vk::raii::Pipeline> m_graphicsPipeline;
-        Utils::Optional<vk::raii::CommandPool> m_graphicsCommandPool;
-        std::vector<vk::raii::CommandBuffer> m_commandBuffers;
-        Utils::Optional<vk::raii::DescriptorSetLayout> m_descriptorSetLayout;
-        Utils::Optional<vk::raii::DescriptorPool> m_descriptorPool;
-        std::vector<vk::raii::DescriptorSet> m_descriptorSets;
+        // Same shaders, the internal vertex is fetched per instance (retained scene)
+        Utils::Optional<vk::raii::Pipeline> m_instancedGraphicsPipeline;
+        // Depth pre-pass variants of both
+        Utils::Optional<vk::raii::Pipeline> m_depthPrePassPipeline;
+        Utils::Optional<vk::raii::Pipeline> m_instancedDepthPrePassPipeline;
+        Utils::Optional<vk::raii::Pipeline> m_afterDepthPrePassPipeline;
+        Utils::Optional<vk::raii::Pipeline> m_instancedAfterDepthPrePassPipeline;
+        CommandAllocator::Shared m_commandAllocator;
+        // The current batch's secondary buffers, executed in order from its command buffer
+        std::vector<vk::CommandBuffer> m_secondaryCommandBuffers;
+        // The current batch's state commands, over its primary and secondary buffers
+        CommandStateStatistics m_commandStateStats;
+
+        struct CachedGeometry
+        {
+            size_t hash = 0;
+            Utils::Optional<vk::raii::CommandBuffer> commandBuffer;
+        };
+
+        // Declared first, the cached buffers are freed before their pool goes
+        Utils::Optional<vk::raii::CommandPool> m_geometryCachePool;
+        // Per frame slot and batch
+        std::vector<std::vector<CachedGeometry>> m_geometryCache;
+        // The current batch's entry, when it's used
+        const vk::raii::CommandBuffer* m_cachedGeometry = nullptr;
+        JobSystem::Shared m_jobSystem;
+        // Only created when the graphics queue supports timestamps
+        Utils::Optional<vk::raii::QueryPool> m_timestampQueryPool;
+        float m_timestampPeriod = 0.0f;
+        std::vector<uint8_t> m_timestampsWritten;
+        BindlessDescriptorSet::Shared m_bindlessDescriptorSet;
+        TransformStore::Shared m_transformStore;
+        RetainedScene::Shared m_retainedScene;
+        GpuCuller::Shared m_gpuCuller;
+        // Rebuilt for every batch, keeps its transient allocation across frames
+        RenderGraph::Shared m_renderGraph;
+        ReadbackRing::Shared m_readbackRing;
 
         SwapchainFramebuffer::Shared m_defaultFramebuffer;
         SwapchainFramebuffer::Shared m_framebuffer;
 
+        // Attachments of the default framebuffer before a swapchain recreation, frames in flight may still use them
+        struct RetiredFramebuffers
+        {
+            std::vector<Framebuffer::Shared> framebuffers;
+            uint32_t framesLeft = 0;
+        };
+
+        std::vector<RetiredFramebuffers> m_retiredFramebuffers;
+        // No image could be acquired (minimized), the frame's draws are dropped
+        bool m_skipsFrame = false;
+
+        // One of each per frame slot, the slot's fence guards them (the acquired image index doesn't)
         std::vector<Buffer::Shared> m_vertexBuffers;
         std::vector<Buffer::Shared> m_indexBuffers;
-        std::vector<Buffer::Shared> m_cameraViewDataBuffers;
         std::vector<Buffer::Shared> m_objectMetadataBuffers;
         std::vector<Buffer::Shared> m_internalVertexBuffers;
 
+        // Bindless slots of the per frame slot storage buffers
+        std::vector<uint32_t> m_objectMetadataBufferIndices;
+        // Bumped by createBuffers(), cached geometry recorded against older buffers is recorded again
+        uint64_t m_bufferGeneration = 0;
+
         BatchAllocationInfo m_allocationBatchInfo;
         LocalTransferSpace m_localTransferSpace;
+        DrawList m_drawList;
+        // Recorders handed out this frame come first, kept across frames with their capacity
+        std::vector<DrawRecorder::Unique> m_drawRecorders;
+        size_t m_acquiredDrawRecorderCount = 0;
+        std::mutex m_drawRecorderMutex;
         InFlightFrameManager m_inFlightFrameManager;
         RendererStatistics m_stats;
+
+        bool m_frustumCullingEnabled = true;
+        bool m_gpuCullingEnabled = false;
+        bool m_drawSortingEnabled = true;
+        bool m_autoInstancingEnabled = true;
+        bool m_depthPrePassEnabled = false;
+        bool m_parallelRecordingEnabled = true;
+        bool m_commandCachingEnabled = false;
     };
 } // LearnVulkanRAII
 
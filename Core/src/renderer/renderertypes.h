@@ -0,0 +1,50 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#ifndef LEARNVULKANRAII_RENDERERTYPES_H
+#define LEARNVULKANRAII_RENDERERTYPES_H
+
+#include "bindlessdescriptorset.h"
+
+#include <glm/glm.hpp>
+
+// Records shared between the CPU side of the renderer and its shaders
+namespace LearnVulkanRAII
+{
+    // 48 byte record, the vertex shader expands the affine rows (see Transform::toAffine3x4)
+    struct ObjectMetadata
+    {
+        glm::mat3x4 model = glm::mat3x4(1.0f);
+    };
+    static_assert(sizeof(ObjectMetadata) == 48, "ObjectMetadata must match the std430 shader layout!");
+
+    // Per-frame camera data travels in the push constants, next to the bindless slots read by the draw
+    struct DrawPushConstants
+    {
+        glm::mat4 viewProjection = glm::mat4(1.0f);
+        uint32_t objectMetadataBufferIndex = BindlessDescriptorSet::InvalidIndex;
+    };
+
+    // Both per-vertex indices share 32 bits: the low bits address the object metadata within the batch,
+    // the high bits hold the bindless material slot (all ones when the object has no material)
+    struct InternalVertex
+    {
+        static constexpr uint32_t ObjectMetadataIndexBits = 20;
+        static constexpr uint32_t ObjectMetadataIndexMask = (1u << ObjectMetadataIndexBits) - 1;
+        static constexpr uint32_t MaxMaterialIndex = (UINT32_MAX >> ObjectMetadataIndexBits) - 1;
+
+        uint32_t packedIndices = 0;
+
+        InternalVertex() = default;
+        InternalVertex(uint32_t objectMetadataIndex, uint32_t materialIndex)
+            : packedIndices((objectMetadataIndex & ObjectMetadataIndexMask) | (materialIndex << ObjectMetadataIndexBits))
+        {
+        }
+
+        [[nodiscard]] uint32_t getObjectMetadataIndex() const { return packedIndices & ObjectMetadataIndexMask; }
+        [[nodiscard]] uint32_t getMaterialIndex() const { return packedIndices >> ObjectMetadataIndexBits; }
+    };
+} // LearnVulkanRAII
+
+#endif //LEARNVULKANRAII_RENDERERTYPES_H
\ No newline at end of file
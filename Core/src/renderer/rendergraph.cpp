@@ -0,0 +1,694 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#include "rendergraph.h"
+
+#include "renderer/utils/utils.h"
+
+#include <algorithm>
+
+namespace LearnVulkanRAII
+{
+    RenderGraphResourceState RenderGraphResourceState::fromAccess(RenderGraphAccess access)
+    {
+        using Stage = vk::PipelineStageFlagBits2;
+        using Access = vk::AccessFlagBits2;
+
+        switch (access)
+        {
+        case RenderGraphAccess::ColorAttachment:
+            return { Stage::eColorAttachmentOutput,
+                Access::eColorAttachmentRead | Access::eColorAttachmentWrite,
+                vk::ImageLayout::eColorAttachmentOptimal };
+        case RenderGraphAccess::DepthAttachment:
+            return { Stage::eEarlyFragmentTests | Stage::eLateFragmentTests,
+                Access::eDepthStencilAttachmentRead | Access::eDepthStencilAttachmentWrite,
+                vk::ImageLayout::eDepthStencilAttachmentOptimal };
+        case RenderGraphAccess::DepthRead:
+            return { Stage::eEarlyFragmentTests | Stage::eLateFragmentTests,
+                Access::eDepthStencilAttachmentRead,
+                vk::ImageLayout::eDepthStencilReadOnlyOptimal };
+        case RenderGraphAccess::SampledRead:
+            return { Stage::eFragmentShader | Stage::eComputeShader,
+                Access::eShaderSampledRead,
+                vk::ImageLayout::eShaderReadOnlyOptimal };
+        case RenderGraphAccess::StorageRead:
+            return { Stage::eVertexShader | Stage::eFragmentShader | Stage::eComputeShader,
+                Access::eShaderStorageRead,
+                vk::ImageLayout::eGeneral };
+        case RenderGraphAccess::StorageWrite:
+            return { Stage::eFragmentShader | Stage::eComputeShader,
+                Access::eShaderStorageRead | Access::eShaderStorageWrite,
+                vk::ImageLayout::eGeneral };
+        case RenderGraphAccess::IndirectRead:
+            return { Stage::eDrawIndirect, Access::eIndirectCommandRead, vk::ImageLayout::eUndefined };
+        case RenderGraphAccess::TransferRead:
+            return { Stage::eTransfer, Access::eTransferRead, vk::ImageLayout::eTransferSrcOptimal };
+        case RenderGraphAccess::TransferWrite:
+            return { Stage::eTransfer, Access::eTransferWrite, vk::ImageLayout::eTransferDstOptimal };
+        case RenderGraphAccess::HostRead:
+            return { Stage::eHost, Access::eHostRead, vk::ImageLayout::eUndefined };
+        case RenderGraphAccess::Present:
+            // The present engine waits on a semaphore, the barrier only needs the layout
+            return { Stage::eNone, Access::eNone, vk::ImageLayout::ePresentSrcKHR };
+        }
+
+        return {};
+    }
+
+    RenderGraph::PassBuilder::PassBuilder(RenderGraph& graph, uint32_t passIndex)
+        : m_graph(graph),
+        m_passIndex(passIndex)
+    {
+    }
+
+    void RenderGraph::PassBuilder::read(RenderGraphResource resource, RenderGraphAccess access)
+    {
+        m_graph.addAccess(m_passIndex, resource, access, false);
+    }
+
+    void RenderGraph::PassBuilder::write(RenderGraphResource resource, RenderGraphAccess access)
+    {
+        m_graph.addAccess(m_passIndex, resource, access, true);
+    }
+
+    void RenderGraph::PassBuilder::addColorAttachment(RenderGraphResource image,
+        vk::AttachmentLoadOp loadOp,
+        vk::AttachmentStoreOp storeOp)
+    {
+        m_graph.m_passes[m_passIndex].colorAttachments.push_back(PassAttachment{ image, loadOp, storeOp });
+        m_graph.addAccess(m_passIndex, image, RenderGraphAccess::ColorAttachment, true);
+    }
+
+    void RenderGraph::PassBuilder::setDepthAttachment(RenderGraphResource image,
+        vk::AttachmentLoadOp loadOp,
+        vk::AttachmentStoreOp storeOp)
+    {
+        m_graph.m_passes[m_passIndex].depthAttachment = PassAttachment{ image, loadOp, storeOp };
+        m_graph.addAccess(m_passIndex, image, RenderGraphAccess::DepthAttachment, true);
+    }
+
+    void RenderGraph::PassBuilder::setHasSideEffects()
+    {
+        m_graph.m_passes[m_passIndex].hasSideEffects = true;
+    }
+
+    void RenderGraph::PassBuilder::setSecondaryCommandBuffers()
+    {
+        m_graph.m_passes[m_passIndex].usesSecondaryCommandBuffers = true;
+    }
+
+    RenderGraph::RenderGraph(const GraphicsContext::Shared& graphicsContext, uint32_t frameSlotCount)
+        : m_graphicsContext(graphicsContext),
+        m_frameSlotCount(frameSlotCount)
+    {
+    }
+
+    RenderGraphResource RenderGraph::importImage(const std::string& name,
+        vk::Image image,
+        vk::ImageView imageView,
+        const FramebufferAttachmentInfo& info,
+        vk::Extent2D extent,
+        const RenderGraphResourceState& initialState,
+        const Utils::Optional<RenderGraphResourceState>& finalState)
+    {
+        Resource resource{};
+        resource.name = name;
+        resource.image = image;
+        resource.imageView = imageView;
+        resource.info = info;
+        resource.extent = extent;
+        resource.initialState = initialState;
+        resource.finalState = finalState;
+
+        return addResource(std::move(resource));
+    }
+
+    RenderGraphResource RenderGraph::importImage(const std::string& name,
+        const Image::Shared& image,
+        const RenderGraphResourceState& initialState,
+        const Utils::Optional<RenderGraphResourceState>& finalState)
+    {
+        const auto& spec = image->getSpecification();
+        FramebufferAttachmentInfo info{ spec.imageFormat, spec.usageFlags, spec.aspectFlags };
+
+        return importImage(name,
+            *image->getImage(),
+            *image->getImageView(),
+            info,
+            vk::Extent2D{ spec.extent.width, spec.extent.height },
+            initialState,
+            finalState);
+    }
+
+    RenderGraphResource RenderGraph::importFramebufferAttachment(const std::string& name,
+        const Framebuffer& framebuffer,
+        size_t attachmentIndex,
+        const RenderGraphResourceState& initialState,
+        const Utils::Optional<RenderGraphResourceState>& finalState)
+    {
+        const auto& spec = framebuffer.getFramebufferSpecification();
+        ASSERT(attachmentIndex < spec.attachments.size(), "Invalid attachment index!");
+
+        auto info = spec.attachments[attachmentIndex];
+        info.clearValue = framebuffer.getClearValues()[attachmentIndex];
+
+        return importImage(name,
+            framebuffer.getAttachmentImage(attachmentIndex),
+            framebuffer.getAttachmentImageView(attachmentIndex),
+            info,
+            vk::Extent2D{ spec.width, spec.height },
+            initialState,
+            finalState);
+    }
+
+    RenderGraphResource RenderGraph::importBuffer(const std::string& name,
+        const Buffer::Shared& buffer,
+        const RenderGraphResourceState& initialState,
+        const Utils::Optional<RenderGraphResourceState>& finalState)
+    {
+        Resource resource{};
+        resource.name = name;
+        resource.isImage = false;
+        resource.buffer = *buffer->getNativeBuffer();
+        resource.initialState = initialState;
+        resource.finalState = finalState;
+
+        return addResource(std::move(resource));
+    }
+
+    RenderGraphResource RenderGraph::createImage(const std::string& name,
+        const FramebufferAttachmentInfo& info,
+        vk::Extent2D extent)
+    {
+        ASSERT(!info.existingImageView, "Transient images are owned by the graph!");
+
+        Resource resource{};
+        resource.name = name;
+        resource.isImported = false;
+        resource.info = info;
+        resource.extent = extent;
+
+        return addResource(std::move(resource));
+    }
+
+    void RenderGraph::addPass(const std::string& name, const SetupFunction& setup, const ExecuteFunction& execute)
+    {
+        ASSERT(!m_compiled, "The graph has been compiled, reset() it before adding passes!");
+
+        Pass pass{};
+        pass.name = name;
+        pass.execute = execute;
+        m_passes.push_back(std::move(pass));
+
+        PassBuilder builder(*this, static_cast<uint32_t>(m_passes.size() - 1));
+        setup(builder);
+    }
+
+    void RenderGraph::compile()
+    {
+        cullPasses();
+        computeLifetimes();
+        allocateTransients();
+        computeBarriers();
+
+        m_compiled = true;
+    }
+
+    void RenderGraph::execute(const vk::raii::CommandBuffer& cb) const
+    {
+        ASSERT(m_compiled, "The graph must be compiled before it's executed!");
+
+        for (const auto& pass : m_passes)
+        {
+            if (pass.culled)
+                continue;
+
+            if (!pass.imageBarriers.empty() || !pass.bufferBarriers.empty())
+            {
+                vk::DependencyInfo dependencyInfo{};
+                dependencyInfo.setImageMemoryBarriers(pass.imageBarriers);
+                dependencyInfo.setBufferMemoryBarriers(pass.bufferBarriers);
+                cb.pipelineBarrier2(dependencyInfo);
+            }
+
+            const bool rendersToAttachments = !pass.colorAttachments.empty() || pass.depthAttachment.has_value();
+            if (rendersToAttachments)
+                beginRendering(cb, pass);
+
+            pass.execute(cb, *this);
+
+            if (rendersToAttachments)
+                cb.endRendering();
+        }
+
+        if (!m_finalImageBarriers.empty() || !m_finalBufferBarriers.empty())
+        {
+            vk::DependencyInfo dependencyInfo{};
+            dependencyInfo.setImageMemoryBarriers(m_finalImageBarriers);
+            dependencyInfo.setBufferMemoryBarriers(m_finalBufferBarriers);
+            cb.pipelineBarrier2(dependencyInfo);
+        }
+    }
+
+    void RenderGraph::reset()
+    {
+        m_passes.clear();
+        m_resources.clear();
+        m_finalImageBarriers.clear();
+        m_finalBufferBarriers.clear();
+        m_compiled = false;
+    }
+
+    void RenderGraph::nextFrame()
+    {
+        for (auto& retired : m_retiredPools)
+        {
+            if (retired.framesLeft > 0)
+                retired.framesLeft--;
+        }
+
+        std::erase_if(m_retiredPools, [](const RetiredPool& retired) { return retired.framesLeft == 0; });
+    }
+
+    vk::Image RenderGraph::getImage(RenderGraphResource resource) const
+    {
+        ASSERT(resource < m_resources.size() && m_resources[resource].isImage, "Invalid image resource!");
+        return m_resources[resource].image;
+    }
+
+    vk::ImageView RenderGraph::getImageView(RenderGraphResource resource) const
+    {
+        ASSERT(resource < m_resources.size() && m_resources[resource].isImage, "Invalid image resource!");
+        return m_resources[resource].imageView;
+    }
+
+    vk::Buffer RenderGraph::getBuffer(RenderGraphResource resource) const
+    {
+        ASSERT(resource < m_resources.size() && !m_resources[resource].isImage, "Invalid buffer resource!");
+        return m_resources[resource].buffer;
+    }
+
+    const FramebufferAttachmentInfo& RenderGraph::getImageInfo(RenderGraphResource resource) const
+    {
+        ASSERT(resource < m_resources.size() && m_resources[resource].isImage, "Invalid image resource!");
+        return m_resources[resource].info;
+    }
+
+    vk::Extent2D RenderGraph::getImageExtent(RenderGraphResource resource) const
+    {
+        ASSERT(resource < m_resources.size() && m_resources[resource].isImage, "Invalid image resource!");
+        return m_resources[resource].extent;
+    }
+
+    size_t RenderGraph::getCulledPassCount() const
+    {
+        return static_cast<size_t>(std::ranges::count_if(m_passes, [](const Pass& pass) { return pass.culled; }));
+    }
+
+    vk::DeviceSize RenderGraph::getTransientMemorySize() const
+    {
+        return m_transientPool.size;
+    }
+
+    RenderGraph::Shared RenderGraph::create(const GraphicsContext::Shared& graphicsContext, uint32_t frameSlotCount)
+    {
+        return makeShared(graphicsContext, frameSlotCount);
+    }
+
+    RenderGraphResource RenderGraph::addResource(Resource&& resource)
+    {
+        ASSERT(!m_compiled, "The graph has been compiled, reset() it before adding resources!");
+
+        m_resources.push_back(std::move(resource));
+        return static_cast<RenderGraphResource>(m_resources.size() - 1);
+    }
+
+    void RenderGraph::addAccess(uint32_t passIndex, RenderGraphResource resource, RenderGraphAccess access, bool isWrite)
+    {
+        ASSERT(resource < m_resources.size(), "Invalid render graph resource!");
+        m_passes[passIndex].accesses.push_back(ResourceAccess{ resource, access, isWrite });
+    }
+
+    void RenderGraph::cullPasses()
+    {
+        // Walk back from the passes with visible results: writes to imported resources or declared side effects.
+        // A pass stays when a kept pass after it uses something it writes
+        std::vector<bool> needed(m_resources.size(), false);
+        for (auto pass = m_passes.rbegin(); pass != m_passes.rend(); ++pass)
+        {
+            bool keep = pass->hasSideEffects;
+            for (const auto& access : pass->accesses)
+            {
+                if (access.isWrite && (m_resources[access.resource].isImported || needed[access.resource]))
+                    keep = true;
+            }
+
+            pass->culled = !keep;
+            if (!keep)
+                continue;
+
+            // Attachments are read-modify-write, an earlier writer may provide the loaded contents
+            for (const auto& access : pass->accesses)
+            {
+                needed[access.resource] = true;
+            }
+        }
+    }
+
+    void RenderGraph::computeLifetimes()
+    {
+        for (uint32_t passIndex = 0; passIndex < m_passes.size(); passIndex++)
+        {
+            if (m_passes[passIndex].culled)
+                continue;
+
+            for (const auto& access : m_passes[passIndex].accesses)
+            {
+                auto& resource = m_resources[access.resource];
+                resource.firstPass = std::min(resource.firstPass, passIndex);
+                resource.lastPass = std::max(resource.lastPass, passIndex);
+            }
+        }
+    }
+
+    void RenderGraph::allocateTransients()
+    {
+        std::vector<TransientImage> images;
+        for (auto& resource : m_resources)
+        {
+            // Transients of culled passes don't get memory
+            if (resource.isImported || resource.firstPass == UINT32_MAX)
+                continue;
+
+            resource.transientIndex = static_cast<uint32_t>(images.size());
+            images.push_back(TransientImage{ resource.info, resource.extent, resource.firstPass, resource.lastPass });
+        }
+
+        if (!canReuseTransientPool(images))
+        {
+            // Frames in flight may still use the old images, they go away once every frame slot came around
+            if (m_transientPool.memory)
+                m_retiredPools.push_back(RetiredPool{ std::move(m_transientPool), m_frameSlotCount });
+            m_transientPool = TransientPool{};
+
+            auto& device = m_graphicsContext->getDevice();
+
+            std::vector<vk::MemoryRequirements> requirements;
+            requirements.reserve(images.size());
+            uint32_t memoryTypeBits = UINT32_MAX;
+            for (auto& transient : images)
+            {
+                vk::ImageCreateInfo createInfo{
+                    {},
+                    vk::ImageType::e2D,
+                    transient.info.format,
+                    vk::Extent3D(transient.extent.width, transient.extent.height, 1),
+                    1, 1,
+                    vk::SampleCountFlagBits::e1,
+                    vk::ImageTiling::eOptimal,
+                    transient.info.usageFlags,
+                    vk::SharingMode::eExclusive,
+                    0,
+                    nullptr
+                };
+                transient.image = device.createImage(createInfo);
+
+                requirements.push_back(transient.image->getMemoryRequirements());
+                memoryTypeBits &= requirements.back().memoryTypeBits;
+            }
+
+            // Largest first, each image takes the lowest offset not used by an image alive at the same time
+            std::vector<uint32_t> placementOrder(images.size());
+            for (uint32_t i = 0; i < placementOrder.size(); i++)
+            {
+                placementOrder[i] = i;
+            }
+            std::ranges::stable_sort(placementOrder, [&](uint32_t a, uint32_t b) {
+                return requirements[a].size > requirements[b].size;
+            });
+
+            std::vector<uint32_t> placed;
+            placed.reserve(images.size());
+            for (const auto index : placementOrder)
+            {
+                auto& transient = images[index];
+
+                std::vector<std::pair<vk::DeviceSize, vk::DeviceSize>> occupied;
+                for (const auto other : placed)
+                {
+                    const auto& otherTransient = images[other];
+                    if (otherTransient.firstPass <= transient.lastPass && transient.firstPass <= otherTransient.lastPass)
+                        occupied.emplace_back(otherTransient.offset, otherTransient.offset + requirements[other].size);
+                }
+                std::ranges::sort(occupied);
+
+                const vk::DeviceSize alignment = requirements[index].alignment;
+                vk::DeviceSize offset = 0;
+                for (const auto& [begin, end] : occupied)
+                {
+                    if (offset + requirements[index].size <= begin)
+                        break;
+                    offset = std::max(offset, (end + alignment - 1) / alignment * alignment);
+                }
+
+                transient.offset = offset;
+                m_transientPool.size = std::max(m_transientPool.size, offset + requirements[index].size);
+                placed.push_back(index);
+            }
+
+            if (!images.empty())
+            {
+                ASSERT(memoryTypeBits != 0, "Transient images don't share a memory type, they can't be aliased!");
+
+                vk::MemoryAllocateInfo allocateInfo{
+                    m_transientPool.size,
+                    m_graphicsContext->findMemoryType(memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal)
+                };
+                m_transientPool.memory = device.allocateMemory(allocateInfo);
+            }
+
+            for (auto& transient : images)
+            {
+                vk::BindImageMemoryInfo bindImageMemoryInfo{ **transient.image, **m_transientPool.memory, transient.offset };
+                device.bindImageMemory2(bindImageMemoryInfo);
+
+                vk::ImageViewCreateInfo viewCreateInfo{
+                    {},
+                    **transient.image,
+                    vk::ImageViewType::e2D,
+                    transient.info.format,
+                    {},
+                    { transient.info.aspectFlags, 0, 1, 0, 1 }
+                };
+                transient.imageView = device.createImageView(viewCreateInfo);
+            }
+
+            m_transientPool.images = std::move(images);
+        }
+
+        for (auto& resource : m_resources)
+        {
+            if (resource.transientIndex == UINT32_MAX)
+                continue;
+
+            const auto& transient = m_transientPool.images[resource.transientIndex];
+            resource.image = **transient.image;
+            resource.imageView = **transient.imageView;
+        }
+    }
+
+    bool RenderGraph::canReuseTransientPool(const std::vector<TransientImage>& images) const
+    {
+        // Same images with the same lifetimes end up at the same offsets
+        const auto& current = m_transientPool.images;
+        if (current.size() != images.size())
+            return false;
+
+        for (size_t i = 0; i < images.size(); i++)
+        {
+            if (current[i].info.format != images[i].info.format ||
+                current[i].info.usageFlags != images[i].info.usageFlags ||
+                current[i].info.aspectFlags != images[i].info.aspectFlags ||
+                current[i].extent != images[i].extent ||
+                current[i].firstPass != images[i].firstPass ||
+                current[i].lastPass != images[i].lastPass)
+                return false;
+        }
+
+        return true;
+    }
+
+    void RenderGraph::computeBarriers()
+    {
+        std::vector<TrackedState> tracked(m_resources.size());
+        for (size_t i = 0; i < m_resources.size(); i++)
+        {
+            const auto& resource = m_resources[i];
+            if (resource.isImported)
+            {
+                tracked[i].writeStages = resource.initialState.stageMask;
+                tracked[i].writeAccesses = resource.initialState.accessMask;
+                tracked[i].layout = resource.initialState.layout;
+            }
+            else
+            {
+                // The memory may have belonged to another transient (or the previous frame's use of it)
+                tracked[i].writeStages = vk::PipelineStageFlagBits2::eAllCommands;
+                tracked[i].writeAccesses = vk::AccessFlagBits2::eMemoryWrite;
+            }
+        }
+
+        for (auto& pass : m_passes)
+        {
+            pass.imageBarriers.clear();
+            pass.bufferBarriers.clear();
+            if (pass.culled)
+                continue;
+
+            for (const auto& access : pass.accesses)
+            {
+                addBarrier(m_resources[access.resource],
+                    tracked[access.resource],
+                    RenderGraphResourceState::fromAccess(access.access),
+                    access.isWrite,
+                    pass.imageBarriers,
+                    pass.bufferBarriers);
+            }
+        }
+
+        // Imported images are handed back in the layout the caller asked for, buffers made visible to the final reader
+        for (size_t i = 0; i < m_resources.size(); i++)
+        {
+            const auto& resource = m_resources[i];
+            if (!resource.finalState)
+                continue;
+
+            if (resource.isImage && resource.finalState->layout == tracked[i].layout)
+                continue;
+
+            addBarrier(resource, tracked[i], *resource.finalState, false, m_finalImageBarriers, m_finalBufferBarriers);
+        }
+    }
+
+    void RenderGraph::addBarrier(const Resource& resource,
+        TrackedState& tracked,
+        const RenderGraphResourceState& state,
+        bool isWrite,
+        std::vector<vk::ImageMemoryBarrier2>& imageBarriers,
+        std::vector<vk::BufferMemoryBarrier2>& bufferBarriers) const
+    {
+        const vk::ImageLayout oldLayout = tracked.layout;
+        const bool changesLayout = resource.isImage && state.layout != oldLayout;
+
+        vk::PipelineStageFlags2 srcStages;
+        vk::AccessFlags2 srcAccesses;
+        if (isWrite || changesLayout)
+        {
+            // Write after write, write after read, or a layout transition (which writes as well)
+            srcStages = tracked.writeStages | tracked.readStages;
+            srcAccesses = tracked.writeAccesses;
+
+            tracked.writeStages = state.stageMask;
+            tracked.writeAccesses = isWrite ? state.accessMask : vk::AccessFlags2{};
+            tracked.readStages = isWrite ? vk::PipelineStageFlags2{} : state.stageMask;
+            tracked.readAccesses = isWrite ? vk::AccessFlags2{} : state.accessMask;
+            if (resource.isImage)
+                tracked.layout = state.layout;
+
+            // Nothing touched the resource before, and its layout stays
+            if (!srcStages && !changesLayout)
+                return;
+        }
+        else
+        {
+            // Read after write, once per stage and access
+            const bool alreadyVisible = !(state.stageMask & ~tracked.readStages) && !(state.accessMask & ~tracked.readAccesses);
+            tracked.readStages |= state.stageMask;
+            tracked.readAccesses |= state.accessMask;
+
+            if (alreadyVisible || !tracked.writeStages)
+                return;
+
+            srcStages = tracked.writeStages;
+            srcAccesses = tracked.writeAccesses;
+        }
+
+        if (resource.isImage)
+        {
+            vk::ImageMemoryBarrier2 barrier{};
+            barrier.srcStageMask = srcStages;
+            barrier.srcAccessMask = srcAccesses;
+            barrier.dstStageMask = state.stageMask;
+            barrier.dstAccessMask = state.accessMask;
+            barrier.oldLayout = oldLayout;
+            barrier.newLayout = state.layout;
+            barrier.image = resource.image;
+            barrier.subresourceRange = getSubresourceRange(resource);
+            imageBarriers.push_back(barrier);
+        }
+        else
+        {
+            vk::BufferMemoryBarrier2 barrier{};
+            barrier.srcStageMask = srcStages;
+            barrier.srcAccessMask = srcAccesses;
+            barrier.dstStageMask = state.stageMask;
+            barrier.dstAccessMask = state.accessMask;
+            barrier.buffer = resource.buffer;
+            barrier.offset = 0;
+            barrier.size = VK_WHOLE_SIZE;
+            bufferBarriers.push_back(barrier);
+        }
+    }
+
+    vk::ImageSubresourceRange RenderGraph::getSubresourceRange(const Resource& resource) const
+    {
+        const vk::ImageAspectFlags aspect = (resource.info.aspectFlags & vk::ImageAspectFlagBits::eDepth)
+            ? Utils::getDepthBarrierAspect(resource.info.format)
+            : resource.info.aspectFlags;
+
+        return vk::ImageSubresourceRange{ aspect, 0, VK_REMAINING_MIP_LEVELS, 0, 1 };
+    }
+
+    void RenderGraph::beginRendering(const vk::raii::CommandBuffer& cb, const Pass& pass) const
+    {
+        auto toAttachmentInfo = [this](const PassAttachment& attachment, vk::ImageLayout layout) {
+            const auto& resource = m_resources[attachment.image];
+
+            vk::RenderingAttachmentInfo attachmentInfo{};
+            attachmentInfo.imageView = resource.imageView;
+            attachmentInfo.imageLayout = layout;
+            attachmentInfo.loadOp = attachment.loadOp;
+            attachmentInfo.storeOp = attachment.storeOp;
+            attachmentInfo.clearValue = resource.info.clearValue;
+            return attachmentInfo;
+        };
+
+        std::vector<vk::RenderingAttachmentInfo> colorAttachments;
+        colorAttachments.reserve(pass.colorAttachments.size());
+        for (const auto& attachment : pass.colorAttachments)
+        {
+            colorAttachments.push_back(toAttachmentInfo(attachment, vk::ImageLayout::eColorAttachmentOptimal));
+        }
+
+        vk::RenderingAttachmentInfo depthAttachment{};
+        if (pass.depthAttachment)
+            depthAttachment = toAttachmentInfo(*pass.depthAttachment, vk::ImageLayout::eDepthStencilAttachmentOptimal);
+
+        // Every attachment of a pass has the same extent
+        const auto& firstAttachment = pass.colorAttachments.empty() ? *pass.depthAttachment : pass.colorAttachments.front();
+        const auto& extent = m_resources[firstAttachment.image].extent;
+
+        vk::RenderingInfo renderingInfo{};
+        if (pass.usesSecondaryCommandBuffers)
+            renderingInfo.flags = vk::RenderingFlagBits::eContentsSecondaryCommandBuffers;
+        renderingInfo.renderArea = vk::Rect2D{ { 0, 0 }, extent };
+        renderingInfo.layerCount = 1;
+        renderingInfo.setColorAttachments(colorAttachments);
+        if (pass.depthAttachment)
+            renderingInfo.pDepthAttachment = &depthAttachment;
+
+        cb.beginRendering(renderingInfo);
+    }
+} // LearnVulkanRAII
\ No newline at end of file
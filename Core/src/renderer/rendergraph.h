@@ -0,0 +1,266 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#ifndef LEARNVULKANRAII_RENDERGRAPH_H
+#define LEARNVULKANRAII_RENDERGRAPH_H
+
+#include "base/utils.h"
+#include "base/graphicscontext.h"
+
+#include "buffer.h"
+#include "image.h"
+#include "framebuffer.h"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace LearnVulkanRAII
+{
+    using RenderGraphResource = uint32_t;
+
+    // How a pass touches a resource, each one maps to the stages, accesses and layout of a barrier
+    enum class RenderGraphAccess
+    {
+        ColorAttachment,
+        DepthAttachment,
+        DepthRead,      // depth test without writes
+        SampledRead,    // fragment or compute shader
+        StorageRead,
+        StorageWrite,
+        IndirectRead,
+        TransferRead,
+        TransferWrite,
+        HostRead,       // only as the final state of an imported buffer
+        Present         // only as the final state of an imported image
+    };
+
+    struct RenderGraphResourceState
+    {
+        vk::PipelineStageFlags2 stageMask = vk::PipelineStageFlagBits2::eNone;
+        vk::AccessFlags2 accessMask = vk::AccessFlagBits2::eNone;
+        vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+
+        static RenderGraphResourceState fromAccess(RenderGraphAccess access);
+    };
+
+    // Frame graph recorded into a single command buffer.
+    // Passes declare what they read and write, compile() culls the passes nothing depends on, places the
+    // transient images in one aliased allocation (lifetimes that don't overlap share memory) and works out the
+    // synchronization2 barriers and layout transitions in between. Passes with attachments get their dynamic
+    // rendering begun and ended by the graph.
+    // Imported resources come with the state the previous work left them in, the graph doesn't track them across frames
+    class RenderGraph
+    {
+    public:
+        DEFINE_SMART_POINTER_HELPERS(RenderGraph)
+
+        static constexpr RenderGraphResource InvalidResource = UINT32_MAX;
+
+        class PassBuilder
+        {
+        public:
+            void read(RenderGraphResource resource, RenderGraphAccess access);
+            void write(RenderGraphResource resource, RenderGraphAccess access);
+
+            // A loaded attachment counts as read as well, it keeps the passes writing it before alive
+            void addColorAttachment(RenderGraphResource image,
+                vk::AttachmentLoadOp loadOp,
+                vk::AttachmentStoreOp storeOp = vk::AttachmentStoreOp::eStore);
+            void setDepthAttachment(RenderGraphResource image,
+                vk::AttachmentLoadOp loadOp,
+                vk::AttachmentStoreOp storeOp = vk::AttachmentStoreOp::eStore);
+
+            // Kept even when nothing reads what it writes
+            void setHasSideEffects();
+            // The pass only executes secondary command buffers inside its rendering scope
+            void setSecondaryCommandBuffers();
+
+        private:
+            PassBuilder(RenderGraph& graph, uint32_t passIndex);
+
+        private:
+            RenderGraph& m_graph;
+            uint32_t m_passIndex = 0;
+
+            friend class RenderGraph;
+        };
+
+        using SetupFunction = std::function<void(PassBuilder&)>;
+        using ExecuteFunction = std::function<void(const vk::raii::CommandBuffer&, const RenderGraph&)>;
+
+    public:
+        // Memory of a replaced transient layout is released frameSlotCount frames later (see nextFrame())
+        RenderGraph(const GraphicsContext::Shared& graphicsContext, uint32_t frameSlotCount);
+
+        RenderGraphResource importImage(const std::string& name,
+            vk::Image image,
+            vk::ImageView imageView,
+            const FramebufferAttachmentInfo& info,
+            vk::Extent2D extent,
+            const RenderGraphResourceState& initialState,
+            const Utils::Optional<RenderGraphResourceState>& finalState = Utils::NullOptional);
+        RenderGraphResource importImage(const std::string& name,
+            const Image::Shared& image,
+            const RenderGraphResourceState& initialState,
+            const Utils::Optional<RenderGraphResourceState>& finalState = Utils::NullOptional);
+        RenderGraphResource importFramebufferAttachment(const std::string& name,
+            const Framebuffer& framebuffer,
+            size_t attachmentIndex,
+            const RenderGraphResourceState& initialState,
+            const Utils::Optional<RenderGraphResourceState>& finalState = Utils::NullOptional);
+        RenderGraphResource importBuffer(const std::string& name,
+            const Buffer::Shared& buffer,
+            const RenderGraphResourceState& initialState,
+            const Utils::Optional<RenderGraphResourceState>& finalState = Utils::NullOptional);
+
+        // Lives within the graph only, the contents are undefined at its first use
+        RenderGraphResource createImage(const std::string& name, const FramebufferAttachmentInfo& info, vk::Extent2D extent);
+
+        void addPass(const std::string& name, const SetupFunction& setup, const ExecuteFunction& execute);
+
+        void compile();
+        void execute(const vk::raii::CommandBuffer& cb) const;
+        // Drops the passes and resources, the transient allocation stays for the next graph with the same layout
+        void reset();
+        // Called once per frame, after the frame slot's fence has been waited on
+        void nextFrame();
+
+        [[nodiscard]] vk::Image getImage(RenderGraphResource resource) const;
+        [[nodiscard]] vk::ImageView getImageView(RenderGraphResource resource) const;
+        [[nodiscard]] vk::Buffer getBuffer(RenderGraphResource resource) const;
+        [[nodiscard]] const FramebufferAttachmentInfo& getImageInfo(RenderGraphResource resource) const;
+        [[nodiscard]] vk::Extent2D getImageExtent(RenderGraphResource resource) const;
+
+        [[nodiscard]] size_t getCulledPassCount() const;
+        [[nodiscard]] vk::DeviceSize getTransientMemorySize() const;
+
+        static Shared create(const GraphicsContext::Shared& graphicsContext, uint32_t frameSlotCount);
+
+    private:
+        struct ResourceAccess
+        {
+            RenderGraphResource resource = InvalidResource;
+            RenderGraphAccess access = RenderGraphAccess::SampledRead;
+            bool isWrite = false;
+        };
+
+        struct PassAttachment
+        {
+            RenderGraphResource image = InvalidResource;
+            vk::AttachmentLoadOp loadOp = vk::AttachmentLoadOp::eDontCare;
+            vk::AttachmentStoreOp storeOp = vk::AttachmentStoreOp::eStore;
+        };
+
+        struct Pass
+        {
+            std::string name;
+            ExecuteFunction execute;
+            std::vector<ResourceAccess> accesses;
+            std::vector<PassAttachment> colorAttachments;
+            Utils::Optional<PassAttachment> depthAttachment;
+            bool hasSideEffects = false;
+            bool usesSecondaryCommandBuffers = false;
+
+            // compile() results
+            bool culled = false;
+            std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+            std::vector<vk::BufferMemoryBarrier2> bufferBarriers;
+        };
+
+        struct Resource
+        {
+            std::string name;
+            bool isImage = true;
+            bool isImported = true;
+
+            vk::Image image = nullptr;
+            vk::ImageView imageView = nullptr;
+            vk::Buffer buffer = nullptr;
+            FramebufferAttachmentInfo info{};
+            vk::Extent2D extent{};
+
+            RenderGraphResourceState initialState{};
+            Utils::Optional<RenderGraphResourceState> finalState;
+
+            // Alive passes using the resource, transients only
+            uint32_t firstPass = UINT32_MAX;
+            uint32_t lastPass = 0;
+            uint32_t transientIndex = UINT32_MAX;
+        };
+
+        // State the barrier simulation carries from pass to pass
+        struct TrackedState
+        {
+            vk::PipelineStageFlags2 writeStages = vk::PipelineStageFlagBits2::eNone;
+            vk::AccessFlags2 writeAccesses = vk::AccessFlagBits2::eNone;
+            // Stages and accesses the last write has been made visible to
+            vk::PipelineStageFlags2 readStages = vk::PipelineStageFlagBits2::eNone;
+            vk::AccessFlags2 readAccesses = vk::AccessFlagBits2::eNone;
+            vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+        };
+
+        struct TransientImage
+        {
+            FramebufferAttachmentInfo info{};
+            vk::Extent2D extent{};
+            uint32_t firstPass = 0;
+            uint32_t lastPass = 0;
+
+            vk::DeviceSize offset = 0;
+            Utils::Optional<vk::raii::Image> image;
+            Utils::Optional<vk::raii::ImageView> imageView;
+        };
+
+        struct TransientPool
+        {
+            std::vector<TransientImage> images;
+            Utils::Optional<vk::raii::DeviceMemory> memory;
+            vk::DeviceSize size = 0;
+        };
+
+        struct RetiredPool
+        {
+            TransientPool pool;
+            uint32_t framesLeft = 0;
+        };
+
+    private:
+        RenderGraphResource addResource(Resource&& resource);
+        void addAccess(uint32_t passIndex, RenderGraphResource resource, RenderGraphAccess access, bool isWrite);
+
+        void cullPasses();
+        void computeLifetimes();
+        void allocateTransients();
+        [[nodiscard]] bool canReuseTransientPool(const std::vector<TransientImage>& images) const;
+        void computeBarriers();
+
+        void addBarrier(const Resource& resource,
+            TrackedState& tracked,
+            const RenderGraphResourceState& state,
+            bool isWrite,
+            std::vector<vk::ImageMemoryBarrier2>& imageBarriers,
+            std::vector<vk::BufferMemoryBarrier2>& bufferBarriers) const;
+        [[nodiscard]] vk::ImageSubresourceRange getSubresourceRange(const Resource& resource) const;
+
+        void beginRendering(const vk::raii::CommandBuffer& cb, const Pass& pass) const;
+
+    private:
+        GraphicsContext::Shared m_graphicsContext;
+        uint32_t m_frameSlotCount = 0;
+
+        std::vector<Pass> m_passes;
+        std::vector<Resource> m_resources;
+        std::vector<vk::ImageMemoryBarrier2> m_finalImageBarriers;
+        std::vector<vk::BufferMemoryBarrier2> m_finalBufferBarriers;
+        bool m_compiled = false;
+
+        TransientPool m_transientPool;
+        std::vector<RetiredPool> m_retiredPools;
+    };
+} // LearnVulkanRAII
+
+#endif //LEARNVULKANRAII_RENDERGRAPH_H
\ No newline at end of file
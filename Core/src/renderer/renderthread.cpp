@@ -0,0 +1,198 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#include "renderthread.h"
+
+namespace LearnVulkanRAII
+{
+    namespace
+    {
+        // Draws per job when a frame's draws are spread over the workers, smaller frames stay on the render thread
+        constexpr uint32_t DrawsPerJob = 1024;
+    }
+
+    RenderThread::RenderThread(uint32_t queuedFrameCount)
+        : m_frames(queuedFrameCount),
+        m_jobSystem(JobSystem::getShared())
+    {
+        ASSERT(queuedFrameCount > 0, "The render thread needs at least one frame!");
+
+        m_thread = std::thread(&RenderThread::run, this);
+    }
+
+    RenderThread::~RenderThread()
+    {
+        stop();
+    }
+
+    RenderFrame& RenderThread::beginFrame(const Renderer::Shared& renderer)
+    {
+        std::unique_lock lock(m_mutex);
+        ASSERT(!m_isWriting, "The previous frame hasn't been submitted!");
+
+        m_frameRendered.wait(lock, [this] { return m_queuedCount < m_frames.size(); });
+
+        auto& frame = m_frames[m_writeIndex];
+        frame.clear();
+        frame.renderer = renderer;
+        frame.commands.swap(m_pendingCommands);
+        m_isWriting = true;
+
+        return frame;
+    }
+
+    void RenderThread::submitFrame()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            ASSERT(m_isWriting, "No frame to submit, beginFrame() first!");
+
+            m_writeIndex = (m_writeIndex + 1) % static_cast<uint32_t>(m_frames.size());
+            m_queuedCount++;
+            m_isWriting = false;
+        }
+
+        m_frameSubmitted.notify_one();
+    }
+
+    void RenderThread::enqueue(const RenderCommand& command)
+    {
+        std::lock_guard lock(m_mutex);
+
+        // Commands added while a frame is being filled go with it, the others wait for the next frame
+        if (m_isWriting)
+            m_frames[m_writeIndex].commands.push_back(command);
+        else
+            m_pendingCommands.push_back(command);
+    }
+
+    void RenderThread::flush()
+    {
+        bool hasPendingCommands = false;
+        {
+            std::lock_guard lock(m_mutex);
+            hasPendingCommands = !m_pendingCommands.empty();
+        }
+
+        // Pending commands go out with a frame without a renderer
+        if (hasPendingCommands)
+        {
+            beginFrame(nullptr);
+            submitFrame();
+        }
+
+        std::unique_lock lock(m_mutex);
+        m_frameRendered.wait(lock, [this] { return m_queuedCount == 0; });
+    }
+
+    RendererStatistics RenderThread::getStats(const Renderer::Shared& renderer) const
+    {
+        std::lock_guard lock(m_mutex);
+
+        auto it = m_stats.find(renderer.get());
+        return it != m_stats.end() ? it->second : RendererStatistics{};
+    }
+
+    RenderThread::Shared RenderThread::create(uint32_t queuedFrameCount)
+    {
+        return makeShared(queuedFrameCount);
+    }
+
+    RenderThread::Shared RenderThread::getShared(const GraphicsDevice::Shared& graphicsDevice)
+    {
+        static std::unordered_map<const GraphicsDevice*, Weak> renderThreads;
+
+        auto& weakRenderThread = renderThreads[graphicsDevice.get()];
+        auto renderThread = weakRenderThread.lock();
+        if (!renderThread)
+        {
+            renderThread = create();
+            weakRenderThread = renderThread;
+        }
+
+        return renderThread;
+    }
+
+    void RenderThread::run()
+    {
+        while (true)
+        {
+            RenderFrame* frame = nullptr;
+            {
+                std::unique_lock lock(m_mutex);
+                m_frameSubmitted.wait(lock, [this] { return m_queuedCount > 0 || m_stopping; });
+
+                // Queued frames are still drawn when stopping
+                if (m_queuedCount == 0)
+                    break;
+
+                frame = &m_frames[m_readIndex];
+            }
+
+            // The frame belongs to this thread until it's counted as rendered
+            renderFrame(*frame);
+
+            {
+                std::lock_guard lock(m_mutex);
+                m_readIndex = (m_readIndex + 1) % static_cast<uint32_t>(m_frames.size());
+                m_queuedCount--;
+            }
+
+            m_frameRendered.notify_all();
+        }
+    }
+
+    void RenderThread::renderFrame(RenderFrame& frame)
+    {
+        for (const auto& command : frame.commands)
+        {
+            command();
+        }
+
+        if (frame.renderer)
+        {
+            auto& renderer = *frame.renderer;
+
+            renderer.beginFrame(frame.camera);
+            const auto drawCount = static_cast<uint32_t>(frame.meshDraws.size());
+            if (drawCount > DrawsPerJob)
+            {
+                m_jobSystem->parallelFor(drawCount, DrawsPerJob, [&](uint32_t begin, uint32_t end) {
+                    auto& recorder = renderer.acquireDrawRecorder();
+                    for (uint32_t i = begin; i < end; i++)
+                    {
+                        const auto& draw = frame.meshDraws[i];
+                        recorder.drawMesh(*draw.mesh, draw.transform, draw.materialIndex);
+                    }
+                });
+            }
+            else
+            {
+                for (const auto& draw : frame.meshDraws)
+                {
+                    renderer.drawMesh(*draw.mesh, draw.transform, draw.materialIndex);
+                }
+            }
+            renderer.endFrame();
+
+            std::lock_guard lock(m_mutex);
+            m_stats[frame.renderer.get()] = renderer.getStats();
+        }
+
+        // Don't keep the renderer alive longer than its frames
+        frame.renderer.reset();
+    }
+
+    void RenderThread::stop()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = true;
+        }
+
+        m_frameSubmitted.notify_one();
+        if (m_thread.joinable())
+            m_thread.join();
+    }
+} // LearnVulkanRAII
\ No newline at end of file
@@ -0,0 +1,119 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#ifndef LEARNVULKANRAII_RENDERTHREAD_H
+#define LEARNVULKANRAII_RENDERTHREAD_H
+
+#include "base/utils.h"
+#include "base/graphicsdevice.h"
+#include "base/jobsystem.h"
+
+#include "mesh/mesh.h"
+
+#include "renderer.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace LearnVulkanRAII
+{
+    using RenderCommand = std::function<void()>;
+
+    // Everything the render thread needs for one frame of a renderer, filled on the main thread.
+    // Meshes are referenced, they must stay alive until the frame has been rendered
+    struct RenderFrame
+    {
+        struct MeshDraw
+        {
+            const Mesh* mesh = nullptr;
+            Transform transform;
+            uint32_t materialIndex = BindlessDescriptorSet::InvalidIndex;
+        };
+
+        // Nothing is drawn without a renderer, the frame only carries commands then
+        Renderer::Shared renderer;
+        CameraViewData camera;
+        std::vector<MeshDraw> meshDraws;
+        // Run on the render thread before the frame is drawn
+        std::vector<RenderCommand> commands;
+
+        void drawMesh(const Mesh& mesh,
+            const Transform& transform,
+            uint32_t materialIndex = BindlessDescriptorSet::InvalidIndex)
+        {
+            meshDraws.push_back(MeshDraw{ &mesh, transform, materialIndex });
+        }
+
+        void clear()
+        {
+            renderer.reset();
+            meshDraws.clear();
+            commands.clear();
+        }
+    };
+
+    // Records, submits and presents on its own thread, one per device (queue submissions aren't thread safe).
+    // The main thread fills a frame and hands it over, up to queuedFrameCount frames wait between the two threads:
+    // simulation runs ahead of the submission until the ring is full, then beginFrame() waits for a free frame.
+    // Frames are recycled, their vectors keep their capacity.
+    // While frames are queued the renderers belong to the render thread, changes go through enqueue() or the
+    // frame's commands. Touching a renderer directly is fine after flush()
+    class RenderThread
+    {
+    public:
+        DEFINE_SMART_POINTER_HELPERS(RenderThread)
+
+    public:
+        explicit RenderThread(uint32_t queuedFrameCount = 2);
+        ~RenderThread();
+
+        // Main thread: the next frame to fill, waits while every frame is queued
+        RenderFrame& beginFrame(const Renderer::Shared& renderer);
+        void submitFrame();
+
+        // Runs on the render thread, before the next submitted frame is drawn
+        void enqueue(const RenderCommand& command);
+        // Waits until every submitted frame and enqueued command has run
+        void flush();
+
+        // Statistics of the renderer's last rendered frame
+        [[nodiscard]] RendererStatistics getStats(const Renderer::Shared& renderer) const;
+
+        static Shared create(uint32_t queuedFrameCount = 2);
+        // The render thread of the device, created with its first user and stopped with the last one
+        static Shared getShared(const GraphicsDevice::Shared& graphicsDevice);
+
+    private:
+        void run();
+        void renderFrame(RenderFrame& frame);
+        void stop();
+
+    private:
+        std::vector<RenderFrame> m_frames;
+        uint32_t m_writeIndex = 0;
+        uint32_t m_readIndex = 0;
+        uint32_t m_queuedCount = 0;
+        bool m_isWriting = false;
+        bool m_stopping = false;
+
+        // Enqueued outside of a frame, moved into the next one
+        std::vector<RenderCommand> m_pendingCommands;
+
+        std::unordered_map<const Renderer*, RendererStatistics> m_stats;
+
+        // Large frames are culled and collected on the workers, one draw recorder per job
+        JobSystem::Shared m_jobSystem;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_frameSubmitted;
+        std::condition_variable m_frameRendered;
+        std::thread m_thread;
+    };
+} // LearnVulkanRAII
+
+#endif //LEARNVULKANRAII_RENDERTHREAD_H
\ No newline at end of file
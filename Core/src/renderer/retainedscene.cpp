@@ -0,0 +1,475 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#include "retainedscene.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+
+namespace LearnVulkanRAII
+{
+    RetainedScene::RetainedScene(const GraphicsContext::Shared& graphicsContext,
+        const BindlessDescriptorSet::Shared& bindlessDescriptorSet,
+        const TransformStore::Shared& transformStore,
+        uint32_t frameSlotCount)
+        : m_graphicsContext(graphicsContext),
+        m_bindlessDescriptorSet(bindlessDescriptorSet),
+        m_transformStore(transformStore),
+        m_frameSlotCount(frameSlotCount)
+    {
+        init();
+    }
+
+    RenderableId RetainedScene::createRenderable(const Mesh& mesh, const Transform& transform, uint32_t materialIndex)
+    {
+        ASSERT(materialIndex <= InternalVertex::MaxMaterialIndex || materialIndex == BindlessDescriptorSet::InvalidIndex,
+            "Material index doesn't fit in the packed internal vertex!");
+
+        RenderableId id;
+        if (!m_freeIds.empty())
+        {
+            id = m_freeIds.back();
+            m_freeIds.pop_back();
+        }
+        else
+        {
+            id = static_cast<RenderableId>(m_renderables.size());
+            m_renderables.emplace_back();
+            m_drawCommands->resize(m_renderables.size());
+            m_instances->resize(m_renderables.size());
+            m_localBounds->resize(m_renderables.size());
+
+            m_boundsCenterX.push_back(0.0f);
+            m_boundsCenterY.push_back(0.0f);
+            m_boundsCenterZ.push_back(0.0f);
+            m_boundsRadius.push_back(-FLT_MAX);
+            m_visible.push_back(0);
+        }
+
+        const auto& residentMesh = acquireMesh(mesh);
+
+        auto& renderable = m_renderables[id];
+        renderable.mesh = &mesh;
+        renderable.transformId = m_transformStore->createTransform(transform);
+        renderable.localBounds = mesh.getBoundingSphere();
+        renderable.alive = true;
+
+        setWorldBounds(id, renderable.localBounds.transformed(transform));
+        m_visible[id] = 1;
+
+        ASSERT(renderable.transformId <= InternalVertex::ObjectMetadataIndexMask,
+            "Transform id doesn't fit in the packed internal vertex!");
+
+        m_drawCommands->at<vk::DrawIndexedIndirectCommand>(id) = vk::DrawIndexedIndirectCommand{
+            residentMesh.indices.count,
+            1,
+            residentMesh.indices.offset,
+            static_cast<int32_t>(residentMesh.vertices.offset),
+            id // selects the instance record
+        };
+        m_drawCommands->markDirty(id);
+
+        m_instances->at<InternalVertex>(id) = InternalVertex{ renderable.transformId, materialIndex };
+        m_instances->markDirty(id);
+
+        m_localBounds->at<glm::vec4>(id) = glm::vec4(renderable.localBounds.center, renderable.localBounds.radius);
+        m_localBounds->markDirty(id);
+
+        return id;
+    }
+
+    void RetainedScene::updateRenderable(RenderableId id, const Transform& transform)
+    {
+        ASSERT(isValid(id), "Invalid renderable id!");
+        if (!isValid(id))
+            return;
+
+        // Only the transform record changes, the draw command and the instance record stay as they are
+        auto& renderable = m_renderables[id];
+        m_transformStore->setTransform(renderable.transformId, transform);
+        setWorldBounds(id, renderable.localBounds.transformed(transform));
+    }
+
+    void RetainedScene::destroyRenderable(RenderableId id)
+    {
+        if (!isValid(id))
+            return;
+
+        auto& renderable = m_renderables[id];
+
+        // Keep the slot in the indirect stream, it just doesn't draw anything anymore
+        setVisible(id, false);
+        setWorldBounds(id, BoundingSphere{ glm::vec3(0.0f), -FLT_MAX }); // never passes the frustum test
+
+        m_transformStore->destroyTransform(renderable.transformId);
+        releaseMesh(renderable.mesh);
+
+        renderable = Renderable{};
+        m_freeIds.push_back(id);
+    }
+
+    bool RetainedScene::isValid(RenderableId id) const
+    {
+        return id < m_renderables.size() && m_renderables[id].alive;
+    }
+
+    TransformId RetainedScene::getTransformId(RenderableId id) const
+    {
+        ASSERT(isValid(id), "Invalid renderable id!");
+        return m_renderables[id].transformId;
+    }
+
+    size_t RetainedScene::getRenderableCount() const
+    {
+        return m_renderables.size() - m_freeIds.size();
+    }
+
+    bool RetainedScene::empty() const
+    {
+        return getRenderableCount() == 0;
+    }
+
+    uint32_t RetainedScene::getDrawSlotCount() const
+    {
+        return static_cast<uint32_t>(m_renderables.size());
+    }
+
+    size_t RetainedScene::cull(const Frustum& frustum)
+    {
+        m_cullResults.resize(m_renderables.size());
+        const size_t visibleCount = frustum.cullSpheres(m_boundsCenterX.data(),
+            m_boundsCenterY.data(),
+            m_boundsCenterZ.data(),
+            m_boundsRadius.data(),
+            m_renderables.size(),
+            m_cullResults.data());
+
+        // Only the renderables crossing the frustum boundary get their draw command uploaded
+        for (RenderableId id = 0; id < m_renderables.size(); id++)
+        {
+            if (m_cullResults[id] != m_visible[id])
+                setVisible(id, m_cullResults[id] != 0);
+        }
+
+        return visibleCount;
+    }
+
+    void RetainedScene::disableCulling()
+    {
+        for (RenderableId id = 0; id < m_renderables.size(); id++)
+        {
+            if (m_renderables[id].alive && !m_visible[id])
+                setVisible(id, true);
+        }
+    }
+
+    RetainedSceneFlushInfo RetainedScene::flush(uint32_t frameSlot)
+    {
+        m_flushCount++;
+        reclaimRetiredGeometry();
+
+        RetainedSceneFlushInfo flushInfo{};
+        flushInfo.recordsBytesUploaded += m_drawCommands->flush(frameSlot);
+        flushInfo.recordsBytesUploaded += m_instances->flush(frameSlot);
+        flushInfo.recordsBytesUploaded += m_localBounds->flush(frameSlot);
+        flushInfo.geometryBytesUploaded = m_pendingGeometryBytes;
+        m_pendingGeometryBytes = 0;
+
+        return flushInfo;
+    }
+
+    void RetainedScene::recordDraws(CommandStateTracker& state, uint32_t frameSlot) const
+    {
+        if (m_renderables.empty())
+            return;
+
+        bindGeometry(state, frameSlot);
+
+        state.getCommandBuffer().drawIndexedIndirect(*m_drawCommands->getBuffer(frameSlot)->getNativeBuffer(),
+            0,
+            static_cast<uint32_t>(m_renderables.size()),
+            sizeof(vk::DrawIndexedIndirectCommand));
+    }
+
+    void RetainedScene::recordDrawsIndirectCount(CommandStateTracker& state,
+        uint32_t frameSlot,
+        const Buffer::Shared& drawCommandBuffer,
+        const Buffer::Shared& drawCountBuffer) const
+    {
+        if (m_renderables.empty())
+            return;
+
+        bindGeometry(state, frameSlot);
+
+        // The visible commands are compacted, the GPU written count stops the draw
+        state.getCommandBuffer().drawIndexedIndirectCount(*drawCommandBuffer->getNativeBuffer(),
+            0,
+            *drawCountBuffer->getNativeBuffer(),
+            0,
+            static_cast<uint32_t>(m_renderables.size()),
+            sizeof(vk::DrawIndexedIndirectCommand));
+    }
+
+    size_t RetainedScene::hashDrawBindings(uint32_t frameSlot) const
+    {
+        size_t hash = 0;
+        Utils::hashCombine(hash, m_geometryGeneration);
+        Utils::hashCombine(hash, m_instances->getGeneration());
+        Utils::hashCombine(hash, m_drawCommands->getGeneration());
+        Utils::hashCombine(hash, frameSlot);
+        Utils::hashCombine(hash, m_renderables.size());
+        return hash;
+    }
+
+    uint32_t RetainedScene::getDrawCommandBufferIndex(uint32_t frameSlot) const
+    {
+        return m_drawCommands->getBindlessIndex(frameSlot);
+    }
+
+    uint32_t RetainedScene::getInstanceBufferIndex(uint32_t frameSlot) const
+    {
+        return m_instances->getBindlessIndex(frameSlot);
+    }
+
+    uint32_t RetainedScene::getBoundsBufferIndex(uint32_t frameSlot) const
+    {
+        return m_localBounds->getBindlessIndex(frameSlot);
+    }
+
+    RetainedScene::Shared RetainedScene::create(const GraphicsContext::Shared& graphicsContext,
+        const BindlessDescriptorSet::Shared& bindlessDescriptorSet,
+        const TransformStore::Shared& transformStore,
+        uint32_t frameSlotCount)
+    {
+        return makeShared(graphicsContext, bindlessDescriptorSet, transformStore, frameSlotCount);
+    }
+
+    void RetainedScene::init()
+    {
+        m_drawCommands = FrameSlotBuffer::create(m_graphicsContext,
+            m_bindlessDescriptorSet,
+            vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eStorageBuffer,
+            sizeof(vk::DrawIndexedIndirectCommand),
+            m_frameSlotCount);
+
+        m_instances = FrameSlotBuffer::create(m_graphicsContext,
+            m_bindlessDescriptorSet,
+            vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eStorageBuffer,
+            sizeof(InternalVertex),
+            m_frameSlotCount);
+
+        m_localBounds = FrameSlotBuffer::create(m_graphicsContext,
+            m_bindlessDescriptorSet,
+            vk::BufferUsageFlagBits::eStorageBuffer,
+            sizeof(glm::vec4),
+            m_frameSlotCount);
+
+        growGeometryBuffer(m_vertexBuffer, m_vertexAllocator, 1 << 16, sizeof(Vertex),
+            vk::BufferUsageFlagBits::eVertexBuffer);
+        growGeometryBuffer(m_indexBuffer, m_indexAllocator, 1 << 18, sizeof(uint32_t),
+            vk::BufferUsageFlagBits::eIndexBuffer);
+    }
+
+    RetainedScene::ResidentMesh& RetainedScene::acquireMesh(const Mesh& mesh)
+    {
+        auto it = m_residentMeshes.find(&mesh);
+        if (it != m_residentMeshes.end())
+        {
+            ASSERT(it->second.vertices.count == mesh.getVerticesCount() && it->second.indices.count == mesh.getIndicesCount(),
+                "Mesh changed after it became resident, create the renderables from a new mesh instead!");
+
+            it->second.refCount++;
+            return it->second;
+        }
+
+        const auto vertexCount = static_cast<uint32_t>(mesh.getVerticesCount());
+        const auto indexCount = static_cast<uint32_t>(mesh.getIndicesCount());
+
+        ResidentMesh residentMesh{};
+        residentMesh.vertices.count = vertexCount;
+        residentMesh.indices.count = indexCount;
+        residentMesh.refCount = 1;
+
+        if (!m_vertexAllocator.allocate(vertexCount, residentMesh.vertices.offset))
+        {
+            growGeometryBuffer(m_vertexBuffer, m_vertexAllocator, vertexCount, sizeof(Vertex),
+                vk::BufferUsageFlagBits::eVertexBuffer);
+            m_vertexAllocator.allocate(vertexCount, residentMesh.vertices.offset);
+        }
+
+        if (!m_indexAllocator.allocate(indexCount, residentMesh.indices.offset))
+        {
+            growGeometryBuffer(m_indexBuffer, m_indexAllocator, indexCount, sizeof(uint32_t),
+                vk::BufferUsageFlagBits::eIndexBuffer);
+            m_indexAllocator.allocate(indexCount, residentMesh.indices.offset);
+        }
+
+        // Freshly allocated ranges aren't read by any frame in flight, they can be written right away
+        writeGeometry(m_vertexBuffer, mesh.vertices.data(),
+            residentMesh.vertices.offset * sizeof(Vertex), mesh.getVerticesSizeInBytes());
+        writeGeometry(m_indexBuffer, mesh.indices.data(),
+            residentMesh.indices.offset * sizeof(uint32_t), mesh.getIndicesSizeInBytes());
+
+        return m_residentMeshes[&mesh] = residentMesh;
+    }
+
+    void RetainedScene::releaseMesh(const Mesh* mesh)
+    {
+        auto it = m_residentMeshes.find(mesh);
+        if (it == m_residentMeshes.end())
+            return;
+
+        if (--it->second.refCount > 0)
+            return;
+
+        m_retiredMeshes.push_back({ it->second, m_flushCount });
+        m_residentMeshes.erase(it);
+    }
+
+    void RetainedScene::growGeometryBuffer(Buffer::Shared& buffer, RangeAllocator& allocator,
+        uint32_t requiredCount, size_t elementSize, vk::BufferUsageFlags usage)
+    {
+        uint32_t newCapacity = std::max(allocator.capacity, 1u);
+        while (newCapacity - allocator.capacity < requiredCount)
+            newCapacity *= 2;
+
+        auto newBuffer = Buffer::create(
+            m_graphicsContext,
+            static_cast<vk::DeviceSize>(newCapacity) * elementSize,
+            usage,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+        if (buffer)
+        {
+            // The GPU only reads the geometry, the host copy doesn't have to wait for the frames in flight.
+            // They keep drawing from the old buffer, it's retired until every one of them is done
+            void* src = buffer->map();
+            void* dst = newBuffer->map();
+            memcpy(dst, src, buffer->getSize());
+            newBuffer->unmap();
+            buffer->unmap();
+
+            m_retiredGeometryBuffers.push_back({ buffer, m_flushCount });
+        }
+
+        buffer = newBuffer;
+        allocator.grow(newCapacity);
+        m_geometryGeneration++;
+    }
+
+    void RetainedScene::writeGeometry(const Buffer::Shared& buffer, const void* data, size_t offset, size_t size)
+    {
+        if (size == 0)
+            return;
+
+        void* dst = buffer->map(size, offset);
+        memcpy(dst, data, size);
+        buffer->unmap();
+
+        m_pendingGeometryBytes += size;
+    }
+
+    void RetainedScene::reclaimRetiredGeometry()
+    {
+        std::erase_if(m_retiredMeshes, [this](const RetiredMesh& retired)
+        {
+            if (retired.retiredAt + m_frameSlotCount >= m_flushCount)
+                return false;
+
+            m_vertexAllocator.release(retired.mesh.vertices);
+            m_indexAllocator.release(retired.mesh.indices);
+            return true;
+        });
+
+        std::erase_if(m_retiredGeometryBuffers, [this](const RetiredGeometryBuffer& retired)
+        {
+            return retired.retiredAt + m_frameSlotCount < m_flushCount;
+        });
+    }
+
+    void RetainedScene::setWorldBounds(RenderableId id, const BoundingSphere& bounds)
+    {
+        m_boundsCenterX[id] = bounds.center.x;
+        m_boundsCenterY[id] = bounds.center.y;
+        m_boundsCenterZ[id] = bounds.center.z;
+        m_boundsRadius[id] = bounds.radius;
+    }
+
+    void RetainedScene::setVisible(RenderableId id, bool visible)
+    {
+        m_visible[id] = visible ? 1 : 0;
+        m_drawCommands->at<vk::DrawIndexedIndirectCommand>(id).instanceCount = visible ? 1 : 0;
+        m_drawCommands->markDirty(id);
+    }
+
+    void RetainedScene::bindGeometry(CommandStateTracker& state, uint32_t frameSlot) const
+    {
+        vk::Buffer vertexBuffers[] = {
+            *m_vertexBuffer->getNativeBuffer(),
+            *m_instances->getBuffer(frameSlot)->getNativeBuffer()
+        };
+        vk::DeviceSize offsets[] = { 0, 0 };
+        state.bindVertexBuffers(0, vertexBuffers, offsets);
+
+        state.bindIndexBuffer(*m_indexBuffer->getNativeBuffer(), 0, vk::IndexType::eUint32);
+    }
+
+    bool RetainedScene::RangeAllocator::allocate(uint32_t count, uint32_t& offset)
+    {
+        if (count == 0)
+        {
+            offset = 0;
+            return true;
+        }
+
+        for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it)
+        {
+            if (it->count < count)
+                continue;
+
+            offset = it->offset;
+            it->offset += count;
+            it->count -= count;
+            if (it->count == 0)
+                freeRanges.erase(it);
+
+            return true;
+        }
+
+        return false;
+    }
+
+    void RetainedScene::RangeAllocator::release(const GeometryRange& range)
+    {
+        if (range.count == 0)
+            return;
+
+        // Sorted by offset, neighbours are merged back together
+        auto it = std::ranges::lower_bound(freeRanges, range.offset, {}, &GeometryRange::offset);
+        it = freeRanges.insert(it, range);
+
+        if (auto next = std::next(it); next != freeRanges.end() && it->offset + it->count == next->offset)
+        {
+            it->count += next->count;
+            freeRanges.erase(next);
+        }
+
+        if (it != freeRanges.begin())
+        {
+            auto prev = std::prev(it);
+            if (prev->offset + prev->count == it->offset)
+            {
+                prev->count += it->count;
+                freeRanges.erase(it);
+            }
+        }
+    }
+
+    void RetainedScene::RangeAllocator::grow(uint32_t newCapacity)
+    {
+        release({ capacity, newCapacity - capacity });
+        capacity = newCapacity;
+    }
+} // LearnVulkanRAII
\ No newline at end of file
@@ -0,0 +1,190 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#ifndef LEARNVULKANRAII_RETAINEDSCENE_H
+#define LEARNVULKANRAII_RETAINEDSCENE_H
+
+#include "base/utils.h"
+#include "base/graphicscontext.h"
+
+#include "mesh/mesh.h"
+
+#include "buffer.h"
+#include "frameslotbuffer.h"
+#include "transformstore.h"
+#include "renderertypes.h"
+#include "frustum.h"
+#include "commandstatetracker.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace LearnVulkanRAII
+{
+    using RenderableId = uint32_t;
+    inline constexpr RenderableId InvalidRenderableId = UINT32_MAX;
+
+    struct RetainedSceneFlushInfo
+    {
+        size_t recordsBytesUploaded = 0;
+        size_t geometryBytesUploaded = 0;
+    };
+
+    // Renderables whose geometry stays resident on the GPU.
+    // Every renderable owns an indirect draw command, an instance record (InternalVertex) and a local bounding
+    // sphere at its slot, so the whole scene is drawn with a single multi-draw indirect call and creating,
+    // updating or destroying a renderable only uploads the records that changed.
+    // The records are registered in the bindless set, the GPU culling pass reads them from there.
+    class RetainedScene
+    {
+    public:
+        DEFINE_SMART_POINTER_HELPERS(RetainedScene)
+
+    public:
+        RetainedScene(const GraphicsContext::Shared& graphicsContext,
+            const BindlessDescriptorSet::Shared& bindlessDescriptorSet,
+            const TransformStore::Shared& transformStore,
+            uint32_t frameSlotCount);
+
+        // Meshes are shared by identity, the geometry is copied once and the mesh isn't referenced afterwards
+        RenderableId createRenderable(const Mesh& mesh,
+            const Transform& transform,
+            uint32_t materialIndex = BindlessDescriptorSet::InvalidIndex);
+        void updateRenderable(RenderableId id, const Transform& transform);
+        void destroyRenderable(RenderableId id);
+
+        [[nodiscard]] bool isValid(RenderableId id) const;
+        [[nodiscard]] TransformId getTransformId(RenderableId id) const;
+        [[nodiscard]] size_t getRenderableCount() const;
+        [[nodiscard]] bool empty() const;
+        // Slots in the indirect stream, destroyed renderables included
+        [[nodiscard]] uint32_t getDrawSlotCount() const;
+
+        // Tests the world bounding spheres of all renderables at once, the draw commands of the renderables
+        // whose visibility changed are rewritten. Returns the visible count
+        size_t cull(const Frustum& frustum);
+        // Makes every renderable visible again
+        void disableCulling();
+
+        // Uploads the changed records of the frame slot, the caller must make sure the GPU is done with it
+        RetainedSceneFlushInfo flush(uint32_t frameSlot);
+
+        // Expects the instanced pipeline and the push constants to be bound already
+        void recordDraws(CommandStateTracker& state, uint32_t frameSlot) const;
+        // Same, with the draw commands and their count produced on the GPU (see GpuCuller)
+        void recordDrawsIndirectCount(CommandStateTracker& state,
+            uint32_t frameSlot,
+            const Buffer::Shared& drawCommandBuffer,
+            const Buffer::Shared& drawCountBuffer) const;
+
+        // Identifies the buffers and the draw count recordDraws() records for the frame slot, changes when a buffer grows.
+        // Buffers are told apart by their generation, the handle of a destroyed buffer may be reused
+        [[nodiscard]] size_t hashDrawBindings(uint32_t frameSlot) const;
+
+        // Bindless slots of the frame slot's records
+        [[nodiscard]] uint32_t getDrawCommandBufferIndex(uint32_t frameSlot) const;
+        [[nodiscard]] uint32_t getInstanceBufferIndex(uint32_t frameSlot) const;
+        [[nodiscard]] uint32_t getBoundsBufferIndex(uint32_t frameSlot) const;
+
+        static Shared create(const GraphicsContext::Shared& graphicsContext,
+            const BindlessDescriptorSet::Shared& bindlessDescriptorSet,
+            const TransformStore::Shared& transformStore,
+            uint32_t frameSlotCount);
+
+    private:
+        struct GeometryRange
+        {
+            uint32_t offset = 0;
+            uint32_t count = 0;
+        };
+
+        // First fit allocator over the elements of a resident buffer
+        struct RangeAllocator
+        {
+            uint32_t capacity = 0;
+            std::vector<GeometryRange> freeRanges;
+
+            bool allocate(uint32_t count, uint32_t& offset);
+            void release(const GeometryRange& range);
+            void grow(uint32_t newCapacity);
+        };
+
+        struct ResidentMesh
+        {
+            GeometryRange vertices;
+            GeometryRange indices;
+            uint32_t refCount = 0;
+        };
+
+        struct Renderable
+        {
+            const Mesh* mesh = nullptr;
+            TransformId transformId = InvalidTransformId;
+            BoundingSphere localBounds;
+            bool alive = false;
+        };
+
+    private:
+        void init();
+
+        ResidentMesh& acquireMesh(const Mesh& mesh);
+        void releaseMesh(const Mesh* mesh);
+        void growGeometryBuffer(Buffer::Shared& buffer, RangeAllocator& allocator,
+            uint32_t requiredCount, size_t elementSize, vk::BufferUsageFlags usage);
+        void writeGeometry(const Buffer::Shared& buffer, const void* data, size_t offset, size_t size);
+        void reclaimRetiredGeometry();
+
+        void setWorldBounds(RenderableId id, const BoundingSphere& bounds);
+        void setVisible(RenderableId id, bool visible);
+
+        void bindGeometry(CommandStateTracker& state, uint32_t frameSlot) const;
+
+    private:
+        GraphicsContext::Shared m_graphicsContext;
+        BindlessDescriptorSet::Shared m_bindlessDescriptorSet;
+        TransformStore::Shared m_transformStore;
+        uint32_t m_frameSlotCount = 0;
+
+        Buffer::Shared m_vertexBuffer;
+        Buffer::Shared m_indexBuffer;
+        RangeAllocator m_vertexAllocator;
+        RangeAllocator m_indexAllocator;
+        std::unordered_map<const Mesh*, ResidentMesh> m_residentMeshes;
+        size_t m_pendingGeometryBytes = 0;
+        // Bumped whenever the vertex or the index buffer is re-created
+        uint64_t m_geometryGeneration = 0;
+
+        // Released geometry stays reserved until every frame in flight that could still read it has retired
+        struct RetiredMesh
+        {
+            ResidentMesh mesh;
+            uint64_t retiredAt = 0;
+        };
+        std::vector<RetiredMesh> m_retiredMeshes;
+        // Grown out of, kept for the frames in flight that were recorded against them
+        struct RetiredGeometryBuffer
+        {
+            Buffer::Shared buffer;
+            uint64_t retiredAt = 0;
+        };
+        std::vector<RetiredGeometryBuffer> m_retiredGeometryBuffers;
+        uint64_t m_flushCount = 0;
+
+        std::vector<Renderable> m_renderables;
+        std::vector<RenderableId> m_freeIds;
+
+        // World bounding spheres as separate component arrays for the SIMD frustum test
+        std::vector<float> m_boundsCenterX, m_boundsCenterY, m_boundsCenterZ, m_boundsRadius;
+        std::vector<uint8_t> m_visible;
+        std::vector<uint8_t> m_cullResults;
+
+        // Indexed by renderable id, destroyed and culled renderables keep a zero instance count
+        FrameSlotBuffer::Shared m_drawCommands;
+        FrameSlotBuffer::Shared m_instances;
+        // Local space sphere (xyz center, w radius), only read by the GPU culling pass
+        FrameSlotBuffer::Shared m_localBounds;
+    };
+} // LearnVulkanRAII
+
+#endif //LEARNVULKANRAII_RETAINEDSCENE_H
\ No newline at end of file
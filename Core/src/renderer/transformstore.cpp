@@ -0,0 +1,162 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#include "transformstore.h"
+
+#include <algorithm>
+
+namespace LearnVulkanRAII
+{
+    TransformStore::TransformStore(const GraphicsContext::Shared& graphicsContext,
+        const BindlessDescriptorSet::Shared& bindlessDescriptorSet,
+        uint32_t frameSlotCount,
+        uint32_t initialCapacity)
+    {
+        m_transforms.reserve(initialCapacity);
+        m_records = FrameSlotBuffer::create(graphicsContext,
+            bindlessDescriptorSet,
+            vk::BufferUsageFlagBits::eStorageBuffer,
+            sizeof(glm::mat3x4),
+            frameSlotCount,
+            initialCapacity);
+    }
+
+    TransformId TransformStore::createTransform(const Transform& transform)
+    {
+        TransformId id;
+        if (!m_freeIds.empty())
+        {
+            id = m_freeIds.back();
+            m_freeIds.pop_back();
+
+            m_transforms.set(id, transform);
+            m_alive[id] = true;
+        }
+        else
+        {
+            id = static_cast<TransformId>(m_transforms.size());
+
+            m_transforms.push(transform);
+            m_alive.push_back(true);
+            m_matrixDirty.push_back(false);
+            m_records->resize(m_transforms.size());
+        }
+
+        markDirty(id);
+        return id;
+    }
+
+    void TransformStore::setTransform(TransformId id, const Transform& transform)
+    {
+        ASSERT(isValid(id), "Invalid transform id!");
+        if (!isValid(id))
+            return;
+
+        m_transforms.set(id, transform);
+        markDirty(id);
+    }
+
+    void TransformStore::destroyTransform(TransformId id)
+    {
+        if (!isValid(id))
+            return;
+
+        // The stale record stays in the slot buffers, nothing references it anymore
+        m_alive[id] = false;
+        m_freeIds.push_back(id);
+    }
+
+    Transform TransformStore::getTransform(TransformId id) const
+    {
+        ASSERT(isValid(id), "Invalid transform id!");
+        return m_transforms.get(id);
+    }
+
+    const glm::mat3x4& TransformStore::getAffine3x4(TransformId id)
+    {
+        ASSERT(isValid(id), "Invalid transform id!");
+
+        auto& record = m_records->at<glm::mat3x4>(id);
+        if (m_matrixDirty[id])
+        {
+            // Recompute just this one, it stays queued for the next flush
+            TransformKernels::toAffine3x4(m_transforms, id, 1, &record);
+        }
+
+        return record;
+    }
+
+    bool TransformStore::isValid(TransformId id) const
+    {
+        return id < m_alive.size() && m_alive[id];
+    }
+
+    size_t TransformStore::getTransformCount() const
+    {
+        return m_transforms.size() - m_freeIds.size();
+    }
+
+    TransformStoreFlushInfo TransformStore::flush(uint32_t frameSlot)
+    {
+        TransformStoreFlushInfo flushInfo{};
+        flushInfo.matricesRecomputed = recomputeDirtyMatrices();
+        flushInfo.bytesUploaded = m_records->flush(frameSlot);
+
+        return flushInfo;
+    }
+
+    uint32_t TransformStore::getBufferIndex(uint32_t frameSlot) const
+    {
+        return m_records->getBindlessIndex(frameSlot);
+    }
+
+    TransformStore::Shared TransformStore::create(const GraphicsContext::Shared& graphicsContext,
+        const BindlessDescriptorSet::Shared& bindlessDescriptorSet,
+        uint32_t frameSlotCount,
+        uint32_t initialCapacity)
+    {
+        return makeShared(graphicsContext, bindlessDescriptorSet, frameSlotCount, initialCapacity);
+    }
+
+    void TransformStore::markDirty(TransformId id)
+    {
+        if (m_matrixDirty[id])
+            return;
+
+        m_matrixDirty[id] = true;
+        m_dirtyIds.push_back(id);
+    }
+
+    size_t TransformStore::recomputeDirtyMatrices()
+    {
+        if (m_dirtyIds.empty())
+            return 0;
+
+        std::ranges::sort(m_dirtyIds);
+
+        // Neighbouring ids are converted together so the SIMD kernels see long runs
+        auto* records = m_records->data<glm::mat3x4>();
+        size_t runBegin = 0;
+        for (size_t i = 1; i <= m_dirtyIds.size(); i++)
+        {
+            if (i < m_dirtyIds.size() && m_dirtyIds[i] == m_dirtyIds[i - 1] + 1)
+                continue;
+
+            const TransformId first = m_dirtyIds[runBegin];
+            const size_t count = i - runBegin;
+            TransformKernels::toAffine3x4(m_transforms, first, count, records + first);
+            runBegin = i;
+        }
+
+        for (const auto id : m_dirtyIds)
+        {
+            m_matrixDirty[id] = false;
+            m_records->markDirty(id);
+        }
+
+        const size_t recomputed = m_dirtyIds.size();
+        m_dirtyIds.clear();
+        return recomputed;
+    }
+} // LearnVulkanRAII
\ No newline at end of file
@@ -0,0 +1,82 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#ifndef LEARNVULKANRAII_TRANSFORMSTORE_H
+#define LEARNVULKANRAII_TRANSFORMSTORE_H
+
+#include "base/utils.h"
+#include "base/graphicscontext.h"
+
+#include "mesh/mesh.h"
+#include "mesh/transformarray.h"
+
+#include "bindlessdescriptorset.h"
+#include "frameslotbuffer.h"
+
+#include <vector>
+
+namespace LearnVulkanRAII
+{
+    using TransformId = uint32_t;
+    inline constexpr TransformId InvalidTransformId = UINT32_MAX;
+
+    struct TransformStoreFlushInfo
+    {
+        size_t matricesRecomputed = 0;
+        size_t bytesUploaded = 0;
+    };
+
+    // Retained transforms with cached affine records.
+    // The records live in a FrameSlotBuffer, so a transform that doesn't change is neither recomputed nor uploaded again.
+    // Changed entries are recomputed once, then written to each frame slot buffer the next time that slot is flushed.
+    class TransformStore
+    {
+    public:
+        DEFINE_SMART_POINTER_HELPERS(TransformStore)
+
+    public:
+        TransformStore(const GraphicsContext::Shared& graphicsContext,
+            const BindlessDescriptorSet::Shared& bindlessDescriptorSet,
+            uint32_t frameSlotCount,
+            uint32_t initialCapacity);
+
+        TransformId createTransform(const Transform& transform);
+        void setTransform(TransformId id, const Transform& transform);
+        void destroyTransform(TransformId id);
+
+        [[nodiscard]] Transform getTransform(TransformId id) const;
+        [[nodiscard]] const glm::mat3x4& getAffine3x4(TransformId id);
+        [[nodiscard]] bool isValid(TransformId id) const;
+        [[nodiscard]] size_t getTransformCount() const;
+
+        // Recomputes the dirty records and writes the ones the slot hasn't seen yet,
+        // the caller must make sure the GPU is done with the slot buffer
+        TransformStoreFlushInfo flush(uint32_t frameSlot);
+
+        [[nodiscard]] uint32_t getBufferIndex(uint32_t frameSlot) const;
+
+        static Shared create(const GraphicsContext::Shared& graphicsContext,
+            const BindlessDescriptorSet::Shared& bindlessDescriptorSet,
+            uint32_t frameSlotCount,
+            uint32_t initialCapacity = 1024);
+
+    private:
+        void markDirty(TransformId id);
+        size_t recomputeDirtyMatrices();
+
+    private:
+        TransformArray m_transforms;
+        std::vector<bool> m_alive;
+        std::vector<TransformId> m_freeIds;
+
+        // Entries changed since the last flush, their cached record is stale
+        std::vector<bool> m_matrixDirty;
+        std::vector<TransformId> m_dirtyIds;
+
+        // Cached affine records, mirrored into the bindless object metadata buffers
+        FrameSlotBuffer::Shared m_records;
+    };
+} // LearnVulkanRAII
+
+#endif //LEARNVULKANRAII_TRANSFORMSTORE_H
\ No newline at end of file
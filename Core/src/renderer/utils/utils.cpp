@@ -98,4 +98,13 @@ namespace LearnVulkanRAII::Utils
 
         return std::move(ss.str());
     }
-}
+
+    vk::ImageAspectFlags getDepthBarrierAspect(vk::Format format)
+    {
+        if (format == vk::Format::eD32SfloatS8Uint || format == vk::Format::eD24UnormS8Uint ||
+            format == vk::Format::eD16UnormS8Uint)
+            return vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
+
+        return vk::ImageAspectFlagBits::eDepth;
+    }
+}
\ No newline at end of file
@@ -18,6 +18,9 @@ namespace LearnVulkanRAII::Utils
                                               std::string const& shaderText);
 
     std::string readFile(const std::string& filePath);
+
+    // Without separate depth/stencil layouts both aspects of a combined format change layout together
+    vk::ImageAspectFlags getDepthBarrierAspect(vk::Format format);
 }
 
 #endif //LEARNVULKANRAII_RENDERER_UTILS_H
\ No newline at end of file
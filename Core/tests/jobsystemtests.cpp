@@ -0,0 +1,270 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#include "base/jobsystem.h"
+#include "base/workstealingdeque.h"
+
+#include "testing.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace LearnVulkanRAII;
+using namespace LearnVulkanRAII::Tests;
+
+namespace
+{
+    void testDequeOwnerOnly()
+    {
+        // Starts tiny, the pushes wrap around the ring and grow it
+        WorkStealingDeque<int> deque(4);
+        std::vector<int> values(1000);
+
+        for (int round = 0; round < 3; round++)
+        {
+            for (auto& value : values)
+                deque.push(&value);
+
+            // LIFO for the owner
+            for (size_t i = values.size(); i > 0; i--)
+                CHECK(deque.pop() == &values[i - 1]);
+
+            CHECK(deque.pop() == nullptr);
+            CHECK(deque.empty());
+        }
+        CHECK(deque.getCapacity() >= static_cast<int64_t>(values.size()));
+
+        // FIFO for the thieves, across the wrap of the ring
+        WorkStealingDeque<int> small(4);
+        for (int round = 0; round < 10; round++)
+        {
+            small.push(&values[0]);
+            small.push(&values[1]);
+            small.push(&values[2]);
+            CHECK(small.steal() == &values[0]);
+            CHECK(small.pop() == &values[2]);
+            CHECK(small.steal() == &values[1]);
+            CHECK(small.steal() == nullptr);
+        }
+        CHECK(small.getCapacity() == 4);
+    }
+
+    void testDequeContention()
+    {
+        constexpr int itemCount = 200000;
+        constexpr int thiefCount = 3;
+
+        // Small ring, the owner grows it while the thieves read it
+        WorkStealingDeque<int> deque(16);
+        std::vector<int> values(itemCount);
+        std::vector<std::atomic<int>> takenCount(itemCount);
+        std::atomic<bool> pushing = true;
+
+        auto take = [&](int* item) {
+            takenCount[item - values.data()].fetch_add(1, std::memory_order_relaxed);
+        };
+
+        std::vector<std::thread> thieves;
+        for (int i = 0; i < thiefCount; i++)
+        {
+            thieves.emplace_back([&] {
+                while (pushing.load() || !deque.empty())
+                {
+                    if (int* item = deque.steal())
+                        take(item);
+                }
+            });
+        }
+
+        // The owner pops some of its own items in between, racing the thieves for the last one
+        for (int i = 0; i < itemCount; i++)
+        {
+            deque.push(&values[i]);
+            if (i % 3 == 0)
+            {
+                if (int* item = deque.pop())
+                    take(item);
+            }
+        }
+        while (int* item = deque.pop())
+            take(item);
+
+        pushing.store(false);
+        for (auto& thief : thieves)
+            thief.join();
+
+        bool everyItemOnce = true;
+        for (const auto& count : takenCount)
+            everyItemOnce = everyItemOnce && count.load() == 1;
+        CHECK(everyItemOnce);
+    }
+
+    void testParallelFor()
+    {
+        JobSystem jobSystem(3);
+
+        const uint32_t counts[] = { 0, 1, 63, 64, 65, 1000, 100003 };
+        const uint32_t grainSizes[] = { 0, 1, 7, 64, 1024 };
+        for (const auto count : counts)
+        {
+            for (const auto grainSize : grainSizes)
+            {
+                std::vector<std::atomic<uint32_t>> runCount(count);
+                jobSystem.parallelFor(count, grainSize, [&](uint32_t begin, uint32_t end) {
+                    CHECK(begin < end && end <= count);
+                    for (uint32_t i = begin; i < end; i++)
+                        runCount[i].fetch_add(1, std::memory_order_relaxed);
+                });
+
+                bool everyIndexOnce = true;
+                for (const auto& value : runCount)
+                    everyIndexOnce = everyIndexOnce && value.load() == 1;
+                CHECK(everyIndexOnce);
+            }
+        }
+    }
+
+    void testDependencies()
+    {
+        JobSystem jobSystem(3);
+
+        constexpr uint32_t firstStageCount = 64;
+        std::atomic<uint32_t> firstStageDone = 0;
+        std::atomic<uint32_t> secondStageSawAll = 0;
+
+        JobCounter firstStage;
+        JobCounter secondStage;
+        for (uint32_t i = 0; i < firstStageCount; i++)
+        {
+            jobSystem.schedule([&] {
+                std::this_thread::yield();
+                firstStageDone.fetch_add(1);
+            }, &firstStage);
+        }
+
+        // Held back until every first stage job finished
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            jobSystem.schedule([&] {
+                if (firstStageDone.load() == firstStageCount)
+                    secondStageSawAll.fetch_add(1);
+            }, &secondStage, &firstStage);
+        }
+
+        jobSystem.wait(secondStage);
+        CHECK(firstStage.isDone());
+        CHECK(secondStage.isDone());
+        CHECK(secondStageSawAll.load() == 8);
+
+        // A dependency already done doesn't hold the job back
+        JobCounter late;
+        std::atomic<bool> ran = false;
+        jobSystem.schedule([&] { ran.store(true); }, &late, &firstStage);
+        jobSystem.wait(late);
+        CHECK(ran.load());
+    }
+
+    void testNestedWait()
+    {
+        JobSystem jobSystem(3);
+
+        // Every job waits for jobs of its own, the waiting workers run them instead of blocking
+        constexpr uint32_t outerCount = 16;
+        constexpr uint32_t innerCount = 32;
+        std::atomic<uint32_t> innerDone = 0;
+
+        JobCounter outer;
+        for (uint32_t i = 0; i < outerCount; i++)
+        {
+            jobSystem.schedule([&] {
+                JobCounter inner;
+                for (uint32_t j = 0; j < innerCount; j++)
+                    jobSystem.schedule([&] { innerDone.fetch_add(1); }, &inner);
+                jobSystem.wait(inner);
+                CHECK(inner.isDone());
+            }, &outer);
+        }
+
+        jobSystem.wait(outer);
+        CHECK(innerDone.load() == outerCount * innerCount);
+
+        // Nested parallel for
+        std::vector<std::atomic<uint32_t>> runCount(64 * 64);
+        jobSystem.parallelFor(64, 1, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++)
+            {
+                jobSystem.parallelFor(64, 4, [&, i](uint32_t innerBegin, uint32_t innerEnd) {
+                    for (uint32_t j = innerBegin; j < innerEnd; j++)
+                        runCount[i * 64 + j].fetch_add(1);
+                });
+            }
+        });
+
+        bool everyIndexOnce = true;
+        for (const auto& value : runCount)
+            everyIndexOnce = everyIndexOnce && value.load() == 1;
+        CHECK(everyIndexOnce);
+    }
+
+    void testMainThreadAffinity()
+    {
+        JobSystem jobSystem(3);
+        CHECK(jobSystem.isMainThread());
+
+        const auto mainThreadId = std::this_thread::get_id();
+        std::atomic<uint32_t> ranOnMainThread = 0;
+        std::atomic<uint32_t> ranElsewhere = 0;
+        auto mainThreadJob = [&] {
+            if (std::this_thread::get_id() == mainThreadId)
+                ranOnMainThread.fetch_add(1);
+            else
+                ranElsewhere.fetch_add(1);
+        };
+
+        // Scheduled from the main thread and from workers, the workers never pick them up
+        JobCounter counter;
+        for (uint32_t i = 0; i < 8; i++)
+            jobSystem.schedule(mainThreadJob, &counter, nullptr, JobAffinity::MainThread);
+
+        JobCounter scheduling;
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            jobSystem.schedule([&] {
+                jobSystem.schedule(mainThreadJob, &counter, nullptr, JobAffinity::MainThread);
+            }, &scheduling);
+        }
+        jobSystem.wait(scheduling);
+
+        // wait() on the main thread may have run some of them already
+        const uint32_t pendingCount = counter.getValue();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        CHECK(counter.getValue() == pendingCount);
+        CHECK(ranOnMainThread.load() + pendingCount == 16);
+
+        jobSystem.runMainThreadJobs();
+        CHECK(ranOnMainThread.load() == 16);
+        CHECK(counter.isDone());
+
+        // wait() on the main thread runs them too
+        JobCounter waited;
+        for (uint32_t i = 0; i < 4; i++)
+            jobSystem.schedule(mainThreadJob, &waited, nullptr, JobAffinity::MainThread);
+        jobSystem.wait(waited);
+        CHECK(ranOnMainThread.load() == 20);
+        CHECK(ranElsewhere.load() == 0);
+    }
+}
+
+void LearnVulkanRAII::Tests::runJobSystemTests()
+{
+    run("WorkStealingDeque owner only", testDequeOwnerOnly);
+    run("WorkStealingDeque contention", testDequeContention);
+    run("JobSystem parallelFor", testParallelFor);
+    run("JobSystem dependencies", testDependencies);
+    run("JobSystem nested wait", testNestedWait);
+    run("JobSystem main thread affinity", testMainThreadAffinity);
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#include "testing.h"
+
+int main()
+{
+    using namespace LearnVulkanRAII::Tests;
+
+    runJobSystemTests();
+    runTransformKernelTests();
+
+    return s_failureCount.load() == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#ifndef LEARNVULKANRAII_TESTING_H
+#define LEARNVULKANRAII_TESTING_H
+
+#include <atomic>
+#include <cstdio>
+
+// Checked from worker threads as well
+#define CHECK(condition)                                                                  \
+    do                                                                                    \
+    {                                                                                     \
+        if (!(condition))                                                                 \
+        {                                                                                 \
+            std::printf("  FAILED: %s (%s:%d)\n", #condition, __FILE__, __LINE__);        \
+            LearnVulkanRAII::Tests::s_failureCount.fetch_add(1);                          \
+        }                                                                                 \
+    } while (false)
+
+namespace LearnVulkanRAII::Tests
+{
+    inline std::atomic<int> s_failureCount = 0;
+
+    inline void run(const char* name, void (*test)())
+    {
+        const int failureCount = s_failureCount.load();
+        test();
+        std::printf("%s %s\n", s_failureCount.load() == failureCount ? "[ OK ]" : "[FAIL]", name);
+    }
+
+    // One per test file, each runs its tests through run()
+    void runJobSystemTests();
+    void runTransformKernelTests();
+} // LearnVulkanRAII::Tests
+
+#endif //LEARNVULKANRAII_TESTING_H
\ No newline at end of file
@@ -0,0 +1,132 @@
+//
+// Created by User on 10/19/2026.
+//
+
+#include "mesh/transformarray.h"
+
+#include "testing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace LearnVulkanRAII;
+using namespace LearnVulkanRAII::Tests;
+
+namespace
+{
+    constexpr TransformKernelType KernelTypes[] = {
+        TransformKernelType::Scalar,
+        TransformKernelType::SSE,
+        TransformKernelType::AVX2,
+        TransformKernelType::NEON
+    };
+
+    TransformArray makeTransforms(size_t count)
+    {
+        std::mt19937 random(42);
+        std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+        std::uniform_real_distribution<float> scale(0.1f, 4.0f);
+
+        TransformArray transforms;
+        transforms.reserve(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            Transform transform;
+            transform.translate = glm::vec3(position(random), position(random), position(random));
+            transform.setRotation(glm::vec3(angle(random), angle(random), angle(random)));
+            transform.scale = glm::vec3(scale(random), scale(random), scale(random));
+            transforms.push(transform);
+        }
+        return transforms;
+    }
+
+    // FMA and the order of the operations differ between the kernels, the results only match closely
+    bool nearlyEqual(float a, float b)
+    {
+        return std::abs(a - b) <= 1e-4f * std::max(1.0f, std::abs(b));
+    }
+
+    // Every supported kernel against the scalar reference, over counts that leave a tail for the vector widths
+    // and ranges that don't start at a vector boundary
+    void testKernelsMatchScalar()
+    {
+        constexpr size_t counts[] = { 1, 3, 4, 5, 7, 8, 9, 15, 17, 31, 33, 1001 };
+        constexpr size_t firsts[] = { 0, 1, 3 };
+
+        const auto transforms = makeTransforms(1001 + 3);
+        const auto previousKernel = TransformKernels::getActiveKernel();
+
+        for (const auto kernelType : KernelTypes)
+        {
+            if (!TransformKernels::isKernelSupported(kernelType))
+                continue;
+
+            TransformKernels::setActiveKernel(kernelType);
+            CHECK(TransformKernels::getActiveKernel() == kernelType);
+
+            for (const auto first : firsts)
+            {
+                for (const auto count : counts)
+                {
+                    // One more matrix than written, the kernels must not store past the range
+                    const glm::mat3x4 sentinel(-12345.0f);
+                    std::vector<glm::mat3x4> expected(count + 1, sentinel);
+                    std::vector<glm::mat3x4> actual(count + 1, sentinel);
+
+                    TransformKernels::toAffine3x4Scalar(transforms, first, count, expected.data());
+                    TransformKernels::toAffine3x4(transforms, first, count, actual.data());
+
+                    bool matches = true;
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        for (int row = 0; row < 3; row++)
+                        {
+                            for (int column = 0; column < 4; column++)
+                                matches = matches && nearlyEqual(actual[i][row][column], expected[i][row][column]);
+                        }
+                    }
+
+                    if (!matches)
+                    {
+                        std::printf("  %s kernel, first %zu, count %zu\n",
+                            TransformKernels::getKernelName(kernelType), first, count);
+                    }
+                    CHECK(matches);
+                    CHECK(actual[count] == sentinel);
+                }
+            }
+        }
+
+        TransformKernels::setActiveKernel(previousKernel);
+    }
+
+    // The scalar reference against the per transform conversion the renderer used before the kernels
+    void testScalarMatchesTransform()
+    {
+        constexpr size_t count = 37;
+        const auto transforms = makeTransforms(count);
+
+        std::vector<glm::mat3x4> matrices(count);
+        TransformKernels::toAffine3x4Scalar(transforms, 0, count, matrices.data());
+
+        for (size_t i = 0; i < count; i++)
+        {
+            const glm::mat3x4 expected = transforms.get(i).toAffine3x4();
+            for (int row = 0; row < 3; row++)
+            {
+                for (int column = 0; column < 4; column++)
+                    CHECK(nearlyEqual(matrices[i][row][column], expected[row][column]));
+            }
+        }
+    }
+}
+
+void LearnVulkanRAII::Tests::runTransformKernelTests()
+{
+    run("TransformKernels scalar reference", testScalarMatchesTransform);
+    run("TransformKernels match the scalar reference", testKernelsMatchScalar);
+}
\ No newline at end of file